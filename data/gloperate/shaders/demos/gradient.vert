@@ -1,9 +1,11 @@
 
-#version 140
+#version 150
 #extension GL_ARB_explicit_attrib_location : require
+#extension GL_ARB_shading_language_include : require
+
+#include </gloperate/shaders/util/constants.glsl>
 
 
-uniform mat4      modelViewProjectionMatrix;
 uniform sampler2D gradientTexture;
 uniform uint      gradientIndex;
 uniform float     value;
@@ -17,7 +19,7 @@ out vec4 v_color;
 
 void main()
 {
-    gl_Position = modelViewProjectionMatrix * vec4(vertex, 1.0);
+    gl_Position = transform.modelViewProjectionMatrix * vec4(vertex, 1.0);
 
     ivec2 size = textureSize(gradientTexture, 0);
     v_color = texelFetch(gradientTexture, ivec2(int(value * float(size.x-1)), gradientIndex), 0);
@@ -1,10 +1,9 @@
 
-#version 140
+#version 150
 #extension GL_ARB_explicit_attrib_location : require
+#extension GL_ARB_shading_language_include : require
 
-
-uniform mat4 modelMatrix;
-uniform mat4 modelViewProjectionMatrix;
+#include </gloperate/shaders/util/constants.glsl>
 
 
 layout (location = 0) in vec3 a_vertex;
@@ -14,7 +13,7 @@ out vec3 v_worldPosition;
 
 void main()
 {
-    gl_Position = modelViewProjectionMatrix * vec4(a_vertex, 1.0);
+    gl_Position = transform.modelViewProjectionMatrix * vec4(a_vertex, 1.0);
 
-    v_worldPosition = (modelMatrix * vec4(a_vertex, 1.0)).xyz;
+    v_worldPosition = (transform.modelMatrix * vec4(a_vertex, 1.0)).xyz;
 }
@@ -3,6 +3,7 @@
 #extension GL_ARB_explicit_attrib_location : require
 #extension GL_ARB_shading_language_include : require
 
+#include </gloperate/shaders/util/constants.glsl>
 #include </gloperate/shaders/lighting/ssao.glsl>
 
 
@@ -16,7 +17,6 @@ uniform sampler2D depthTexture;
 uniform sampler1D ssaoKernelTexture;
 uniform sampler2DArray ssaoNoiseTexture;
 
-uniform mat4 modelViewProjectionMatrix;
 uniform mat3 normalMatrix;
 
 uniform int currentFrame;
@@ -46,8 +46,8 @@ void main()
             normalTexture,
             ssaoNoiseTexture,
             ssaoKernelTexture,
-            modelViewProjectionMatrix,
-            inverse(modelViewProjectionMatrix),
+            transform.modelViewProjectionMatrix,
+            inverse(transform.modelViewProjectionMatrix),
             ssaoRadius,
             currentFrame
         );
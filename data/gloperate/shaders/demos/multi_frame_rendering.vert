@@ -1,16 +1,14 @@
 
-#version 140
+#version 150
 #extension GL_ARB_explicit_attrib_location : require
+#extension GL_ARB_shading_language_include : require
+
+#include </gloperate/shaders/util/constants.glsl>
 
 
 uniform sampler1D dofShiftKernel;
 uniform sampler1D subpixelShiftKernel;
 
-uniform mat4 modelViewMatrix;
-uniform mat4 projectionMatrix;
-
-uniform vec4 viewport;
-
 uniform int currentFrame;
 uniform float dofZFocus;
 
@@ -31,12 +29,12 @@ void main()
     // Get shift values
     vec2 dofShift = texelFetch(dofShiftKernel, currentFrame, 0).xy;
     vec2 subpixelShift = texelFetch(subpixelShiftKernel, currentFrame, 0).xy;
-    subpixelShift /= viewport.zw;
+    subpixelShift /= frame.viewport.zw;
 
     // Apply DOF shift in view space
-    vec4 viewPos = modelViewMatrix * vec4(a_vertex, 1.0);
+    vec4 viewPos = transform.viewMatrix * transform.modelMatrix * vec4(a_vertex, 1.0);
     vec4 dofViewPos = vec4(viewPos.xy + dofShift * (viewPos.z + dofZFocus) * float(useDOF), viewPos.zw);
-    vec4 dofShiftedPos = projectionMatrix * dofViewPos;
+    vec4 dofShiftedPos = transform.projectionMatrix * dofViewPos;
 
     // Apply AA shift in screen space
     v_position = dofShiftedPos + vec4(subpixelShift, 0.0, 0.0) * float(useAntialiasing);
@@ -1,9 +1,9 @@
 
 #version 330
 #extension GL_ARB_explicit_attrib_location : require
+#extension GL_ARB_shading_language_include : require
 
-
-uniform mat4 modelViewProjectionMatrix;
+#include </gloperate/shaders/util/constants.glsl>
 
 
 layout (location = 0) in vec3 vertex;
@@ -15,6 +15,6 @@ out vec2 v_texcoord;
 
 void main()
 {
-    gl_Position = modelViewProjectionMatrix * vec4(vertex, 1.0);
+    gl_Position = transform.modelViewProjectionMatrix * vec4(vertex, 1.0);
     v_texcoord  = texcoord;
 }
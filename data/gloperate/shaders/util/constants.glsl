@@ -0,0 +1,26 @@
+
+#ifndef CONSTANTS
+#define CONSTANTS
+
+// Binding indices are assigned after linking (see gloperate::RenderPass::bindConstantBlocks())
+
+// Bound once per frame by the canvas (see gloperate::FrameConstants)
+layout (std140) uniform FrameConstants
+{
+    vec4  viewport;
+    float timeDelta;
+    float time;
+    int   frameCounter;
+} frame;
+
+// Bound per draw call by render passes (see gloperate::TransformConstants)
+layout (std140) uniform TransformConstants
+{
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 modelMatrix;
+    mat4 modelViewProjectionMatrix;
+} transform;
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include <glm/glm.hpp>
@@ -104,6 +105,35 @@ std::string AssimpMeshLoader::allLoadingTypes() const
 }
 
 Drawable * AssimpMeshLoader::load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> /*progress*/) const
+{
+    // Import mesh
+    MeshData data;
+    if (!readGeometry(filename, options, data))
+    {
+        return nullptr;
+    }
+
+    // Return loaded mesh
+    return createGeometry(data);
+}
+
+std::function<Drawable * ()> AssimpMeshLoader::read(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> /*progress*/) const
+{
+    // Import mesh on this thread
+    auto data = std::make_shared<MeshData>();
+    if (!readGeometry(filename, options, *data))
+    {
+        return [] () -> Drawable * { return nullptr; };
+    }
+
+    // Create buffers on the context thread
+    return [this, data] ()
+    {
+        return createGeometry(*data);
+    };
+}
+
+bool AssimpMeshLoader::readGeometry(const std::string & filename, const cppexpose::Variant & options, MeshData & data) const
 {
     bool smoothNormals = false;
 
@@ -125,97 +155,109 @@ Drawable * AssimpMeshLoader::load(const std::string & filename, const cppexpose:
     if (!scene)
     {
         cppassist::error("AssimpMeshLoader") << aiGetErrorString();
-        return nullptr;
+        return false;
     }
 
     // Convert first mesh found in the scene
-    Drawable * geometry = nullptr;
-    if (scene->mNumMeshes > 0) {
-        geometry = convertGeometry(scene->mMeshes[0]);
+    const auto found = scene->mNumMeshes > 0;
+    if (found) {
+        convertGeometry(scene->mMeshes[0], data);
     }
 
     // Release scene
     aiReleaseImport(scene);
 
-    // Return loaded mesh
-    return geometry;
+    return found;
 }
 
-Drawable * AssimpMeshLoader::convertGeometry(const aiMesh * mesh) const
+void AssimpMeshLoader::convertGeometry(const aiMesh * mesh, MeshData & data) const
 {
-    // Create geometry
-    Drawable * geometry = new Drawable;
-
     // Copy index array
-    std::vector<unsigned int> indices;
     for (size_t i = 0; i < mesh->mNumFaces; ++i)
     {
         const auto & face = mesh->mFaces[i];
         for (auto j = 0u; j < face.mNumIndices; ++j)
-            indices.push_back(face.mIndices[j]);
+            data.indices.push_back(face.mIndices[j]);
     }
-    globjects::Buffer * indexBuffer = new globjects::Buffer;
-    indexBuffer->setData(std::move(indices), gl::GL_STATIC_DRAW);
-    geometry->setIndexBuffer(indexBuffer);
-    geometry->setSize(indices.size());
-    geometry->setDrawMode(gloperate::DrawMode::ElementsIndexBuffer);
 
     // Copy vertex array
-    std::vector<glm::vec3> vertices;
     for (size_t i = 0; i < mesh->mNumVertices; ++i)
     {
         const auto & vertex = mesh->mVertices[i];
-        vertices.push_back({ vertex.x, vertex.y, vertex.z });
+        data.vertices.push_back({ vertex.x, vertex.y, vertex.z });
     }
-    globjects::Buffer * vertexBuffer = new globjects::Buffer;
-    geometry->setBuffer(0, vertexBuffer);
-    geometry->setData(0, std::move(vertices), gl::GL_STATIC_DRAW);
-    geometry->bindAttribute(0, 0);
-    geometry->setAttributeBindingBuffer(0, 0, 0, sizeof(glm::vec3));
-    geometry->setAttributeBindingFormat(0, 3, gl::GL_FLOAT, gl::GL_FALSE, 0);
-    geometry->enableAttributeBinding(0);
 
     // Does the mesh contain normal vectors?
     if (mesh->HasNormals())
     {
         // Copy normal array
-        std::vector<glm::vec3> normals;
         for (size_t i = 0; i < mesh->mNumVertices; ++i)
         {
             const auto & normal = mesh->mNormals[i];
-            normals.push_back({ normal.x, normal.y, normal.z });
+            data.normals.push_back({ normal.x, normal.y, normal.z });
         }
-        globjects::Buffer * normalBuffer = new globjects::Buffer;
-        geometry->setBuffer(1, normalBuffer);
-        geometry->setData(1, std::move(normals), gl::GL_STATIC_DRAW);
-        geometry->bindAttribute(1, 1);
-        geometry->setAttributeBindingBuffer(1, 1, 0, sizeof(glm::vec3));
-        geometry->setAttributeBindingFormat(1, 3, gl::GL_FLOAT, gl::GL_FALSE, 0);
-        geometry->enableAttributeBinding(1);
     }
 
     // Does the mesh contain texture coordinates?
     if (mesh->HasTextureCoords(0))
     {
         // Copy texture cooridinate array
-        std::vector<glm::vec3> textureCoordinates;
         for (size_t i = 0; i < mesh->mNumVertices; ++i)
         {
             const auto & textureCoordinate = mesh->mTextureCoords[0][i];
-            textureCoordinates.push_back({ textureCoordinate.x, textureCoordinate.y, textureCoordinate.z });
+            data.textureCoordinates.push_back({ textureCoordinate.x, textureCoordinate.y, textureCoordinate.z });
         }
+    }
+
+    // Materials
+    //geometry->setMaterialIndex(mesh->mMaterialIndex);
+}
+
+Drawable * AssimpMeshLoader::createGeometry(const MeshData & data) const
+{
+    // Create geometry
+    Drawable * geometry = new Drawable;
+
+    // Create index buffer
+    globjects::Buffer * indexBuffer = new globjects::Buffer;
+    indexBuffer->setData(data.indices, gl::GL_STATIC_DRAW);
+    geometry->setIndexBuffer(indexBuffer);
+    geometry->setSize(data.indices.size());
+    geometry->setDrawMode(gloperate::DrawMode::ElementsIndexBuffer);
+
+    // Create vertex buffer
+    globjects::Buffer * vertexBuffer = new globjects::Buffer;
+    geometry->setBuffer(0, vertexBuffer);
+    geometry->setData(0, data.vertices, gl::GL_STATIC_DRAW);
+    geometry->bindAttribute(0, 0);
+    geometry->setAttributeBindingBuffer(0, 0, 0, sizeof(glm::vec3));
+    geometry->setAttributeBindingFormat(0, 3, gl::GL_FLOAT, gl::GL_FALSE, 0);
+    geometry->enableAttributeBinding(0);
+
+    // Create normal buffer
+    if (!data.normals.empty())
+    {
+        globjects::Buffer * normalBuffer = new globjects::Buffer;
+        geometry->setBuffer(1, normalBuffer);
+        geometry->setData(1, data.normals, gl::GL_STATIC_DRAW);
+        geometry->bindAttribute(1, 1);
+        geometry->setAttributeBindingBuffer(1, 1, 0, sizeof(glm::vec3));
+        geometry->setAttributeBindingFormat(1, 3, gl::GL_FLOAT, gl::GL_FALSE, 0);
+        geometry->enableAttributeBinding(1);
+    }
+
+    // Create texture coordinate buffer
+    if (!data.textureCoordinates.empty())
+    {
         globjects::Buffer * texCoordBuffer = new globjects::Buffer;
         geometry->setBuffer(2, texCoordBuffer);
-        geometry->setData(2, std::move(textureCoordinates), gl::GL_STATIC_DRAW);
+        geometry->setData(2, data.textureCoordinates, gl::GL_STATIC_DRAW);
         geometry->bindAttribute(2, 2);
         geometry->setAttributeBindingBuffer(2, 2, 0, sizeof(glm::vec3));
         geometry->setAttributeBindingFormat(2, 3, gl::GL_FLOAT, gl::GL_FALSE, 0);
         geometry->enableAttributeBinding(2);
     }
 
-    // Materials
-    //geometry->setMaterialIndex(mesh->mMaterialIndex);
-
     // Return geometry
     return geometry;
 }
@@ -2,6 +2,10 @@
 #pragma once
 
 
+#include <vector>
+
+#include <glm/vec3.hpp>
+
 #include <cppexpose/plugin/plugin_api.h>
 
 #include <gloperate/gloperate-version.h>
@@ -56,18 +60,63 @@ public:
     virtual std::vector<std::string> loadingTypes() const override;
     virtual std::string allLoadingTypes() const override;
     virtual gloperate::Drawable * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
+    virtual std::function<gloperate::Drawable * ()> read(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
 
 
 protected:
     /**
     *  @brief
-    *    Convert ASSIMP mesh into gloperate mesh
+    *    Mesh data read from a file
+    */
+    struct MeshData
+    {
+        std::vector<unsigned int> indices;            ///< Indices
+        std::vector<glm::vec3>    vertices;           ///< Vertex positions
+        std::vector<glm::vec3>    normals;            ///< Normal vectors (can be empty)
+        std::vector<glm::vec3>    textureCoordinates; ///< Texture coordinates (can be empty)
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Import first mesh of a file
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options for loading the mesh
+    *  @param[out] data
+    *    Mesh data
+    *
+    *  @return
+    *    'true' if a mesh has been imported, else 'false'
+    */
+    bool readGeometry(const std::string & filename, const cppexpose::Variant & options, MeshData & data) const;
+
+    /**
+    *  @brief
+    *    Convert ASSIMP mesh into mesh data
     *
     *  @param[in] mesh
     *    ASSIMP mesh (must be valid!)
+    *  @param[out] data
+    *    Mesh data
+    */
+    void convertGeometry(const aiMesh * mesh, MeshData & data) const;
+
+    /**
+    *  @brief
+    *    Create gloperate mesh from mesh data
+    *
+    *  @param[in] data
+    *    Mesh data
     *
     *  @return
     *    Mesh, must be destroyed by the caller
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
     */
-    gloperate::Drawable * convertGeometry(const aiMesh * mesh) const;
+    gloperate::Drawable * createGeometry(const MeshData & data) const;
 };
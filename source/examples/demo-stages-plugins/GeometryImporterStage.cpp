@@ -1,7 +1,10 @@
 
 #include "GeometryImporterStage.h"
 
+#include <chrono>
+
 #include <gloperate/base/Environment.h>
+#include <gloperate/base/ResourceCache.h>
 #include <gloperate/rendering/Drawable.h>
 
 
@@ -20,18 +23,60 @@ GeometryImporterStage::~GeometryImporterStage()
 {
 }
 
+void GeometryImporterStage::onContextInit(gloperate::AbstractGLContext * /*context*/)
+{
+    // Reload geometry in the background when its file has been modified (notified on the render thread of the context)
+    if (auto cache = gloperate::ResourceCache::current())
+    {
+        m_resourceChangedConnection = cache->resourceChanged.connect([this] (const std::string & path)
+        {
+            if (m_geometry && path == gloperate::ResourceManager::canonicalPath((*filePath).path()))
+            {
+                m_pendingGeometry = m_environment->resourceManager()->loadAsync<gloperate::Drawable>((*filePath).path());
+                setAlwaysProcessed(true);
+            }
+        });
+    }
+}
+
 void GeometryImporterStage::onContextDeinit(gloperate::AbstractGLContext * /*context*/)
 {
+    m_resourceChangedConnection = cppexpose::Connection();
+
     m_geometry.reset();
+
+    // Discard geometry that is being loaded
+    m_pendingGeometry = std::future<std::shared_ptr<gloperate::Drawable>>();
+    setAlwaysProcessed(false);
 }
 
 void GeometryImporterStage::onProcess()
 {
-    auto loaded = std::unique_ptr<gloperate::Drawable>(m_environment->resourceManager()->load<gloperate::Drawable>((*filePath).path()));
+    // Start loading geometry
+    if (filePath.hasChanged() || (!m_geometry && !m_pendingGeometry.valid()))
+    {
+        m_pendingGeometry = m_environment->resourceManager()->loadAsync<gloperate::Drawable>((*filePath).path());
+
+        // Check for the geometry in every frame until it is ready
+        setAlwaysProcessed(true);
+    }
+
+    // Take over geometry once it has been loaded
+    if (m_pendingGeometry.valid() && m_pendingGeometry.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        auto loaded = m_pendingGeometry.get();
+
+        if (loaded)
+        {
+            m_geometry = std::move(loaded);
+        }
+
+        setAlwaysProcessed(false);
+    }
 
-    if (loaded)
+    // Keep providing the previous geometry while loading
+    if (m_geometry && (!geometry.isValid() || *geometry != m_geometry.get()))
     {
-        m_geometry = std::move(loaded);
         geometry = m_geometry.get();
     }
 }
@@ -2,9 +2,13 @@
 #pragma once
 
 
+#include <memory>
+#include <future>
+
 #include <cppfs/FilePath.h>
 
 #include <cppexpose/plugin/plugin_api.h>
+#include <cppexpose/signal/ScopedConnection.h>
 
 #include <gloperate/gloperate-version.h>
 #include <gloperate/pipeline/Stage.h>
@@ -20,6 +24,10 @@ namespace gloperate
 /**
 *  @brief
 *    Stage for loading geometry from file
+*
+*    The geometry is loaded in the background, until it is ready the
+*    stage keeps providing the previous geometry. It is reloaded when
+*    the file has been modified.
 */
 class GeometryImporterStage : public gloperate::Stage
 {
@@ -65,9 +73,12 @@ public:
 protected:
     // Virtual Stage inteface
     virtual void onProcess() override;
+    virtual void onContextInit(gloperate::AbstractGLContext * context) override;
     virtual void onContextDeinit(gloperate::AbstractGLContext * context) override;
 
 
 protected:
-    std::unique_ptr<gloperate::Drawable> m_geometry; ///< geometry
+    std::shared_ptr<gloperate::Drawable>              m_geometry;                  ///< geometry
+    std::future<std::shared_ptr<gloperate::Drawable>> m_pendingGeometry;           ///< geometry that is being loaded
+    cppexpose::ScopedConnection                       m_resourceChangedConnection; ///< connection to reload the geometry when its file has been modified
 };
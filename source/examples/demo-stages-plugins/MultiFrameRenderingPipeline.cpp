@@ -126,7 +126,6 @@ MultiFrameRenderingPipeline::MultiFrameRenderingPipeline(gloperate::Environment
     m_renderPassStage->createInput("transparencyKernel") << m_transparencyKernelStage->texture;
     m_renderPassStage->createInput("useTransparency") << useTransparency;
     m_renderPassStage->createInput("transparencyAlpha") << transparencyAlpha;
-    m_renderPassStage->createInput("viewport") << canvasInterface.viewport;
 
     addStage(m_renderClearStage.get());
     m_renderClearStage->createInput("Color") << m_colorTextureStage->colorRenderTarget;
@@ -69,6 +69,9 @@ public:
     */
     virtual ~KernelToPointInPlanestage();
 
+    // Virtual Stage interface
+    virtual bool requiresContext() const override;
+
 
 protected:
     // Virtual Stage interface
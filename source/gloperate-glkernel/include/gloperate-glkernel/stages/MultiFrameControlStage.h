@@ -66,6 +66,9 @@ public:
     */
     virtual ~MultiFrameControlStage();
 
+    // Virtual Stage interface
+    virtual bool requiresContext() const override;
+
 
 protected:
     // Virtual Stage interface
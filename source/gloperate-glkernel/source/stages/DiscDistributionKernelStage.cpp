@@ -14,6 +14,8 @@
 #include <globjects/Texture.h>
 #include <globjects/Buffer.h>
 
+#include <gloperate/rendering/RenderStateCache.h>
+
 
 namespace
 {
@@ -84,6 +86,7 @@ void DiscDistributionKernelStage::onProcess()
         regenerateKernel();
 
         m_texture->image1D(0, gl::GL_RG32F, *kernelSize, 0, gl::GL_RG, gl::GL_FLOAT, m_kernel.data());
+        gloperate::RenderStateCache::texturesChanged();
 
         m_kernelData = {m_kernel.begin(), m_kernel.end()};
         kernel.setValue(&m_kernelData);
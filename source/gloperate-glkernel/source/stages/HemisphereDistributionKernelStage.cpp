@@ -11,6 +11,8 @@
 #include <globjects/Texture.h>
 #include <globjects/Buffer.h>
 
+#include <gloperate/rendering/RenderStateCache.h>
+
 #include <glkernel/sample.h>
 #include <glkernel/scale.h>
 #include <glkernel/sort.h>
@@ -63,6 +65,7 @@ void HemisphereDistributionKernelStage::onProcess()
         regenerateKernel();
 
         m_texture->image1D(0, gl::GL_RGB32F, *kernelSize, 0, gl::GL_RGB, gl::GL_FLOAT, m_kernel.data());
+        gloperate::RenderStateCache::texturesChanged();
 
         m_kernelData = {m_kernel.begin(), m_kernel.end()};
         kernel.setValue(&m_kernelData);
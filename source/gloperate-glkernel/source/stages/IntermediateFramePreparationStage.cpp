@@ -66,16 +66,25 @@ void IntermediateFramePreparationStage::onProcess()
             static_cast<gl::GLint>(renderInterface.viewport->w)
         }};
 
-        auto sourceFBO = renderInterface.obtainFBO(0, *intermediateRenderTarget);
+        auto sourceChanged = false;
+        auto sourceFBO = renderInterface.obtainFBO(0, *intermediateRenderTarget, &sourceChanged);
         auto sourceAttachment = (*intermediateRenderTarget)->drawBufferAttachment(0);
 
         auto targetFBO = m_targetFBO.get();
         auto targetAttachment = gl::GL_COLOR_ATTACHMENT0;
 
-        targetFBO->attachTexture(targetAttachment, *intermediateFrameTexture);
+        // Only reattach and validate the target texture if it has changed
+        const auto attachment = targetFBO->getAttachment(targetAttachment);
+        const auto targetChanged = !attachment || !attachment->isTextureAttachment()
+            || static_cast<globjects::AttachedTexture *>(attachment)->texture() != *intermediateFrameTexture;
 
-        sourceFBO->printStatus(true);
-        targetFBO->printStatus(true);
+        if (targetChanged)
+        {
+            targetFBO->attachTexture(targetAttachment, *intermediateFrameTexture);
+        }
+
+        gloperate::RenderInterface::validateFBO(sourceFBO, sourceChanged);
+        gloperate::RenderInterface::validateFBO(targetFBO, targetChanged);
         sourceFBO->blit(sourceAttachment, rect, targetFBO, targetAttachment, rect, gl::GL_COLOR_BUFFER_BIT, gl::GL_NEAREST);
     }
 
@@ -29,6 +29,11 @@ KernelToPointInPlanestage::~KernelToPointInPlanestage()
 {
 }
 
+bool KernelToPointInPlanestage::requiresContext() const
+{
+    return false;
+}
+
 void KernelToPointInPlanestage::onProcess()
 {
     if (*kernel == nullptr)
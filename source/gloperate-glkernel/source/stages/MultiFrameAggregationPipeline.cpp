@@ -44,16 +44,19 @@ MultiFrameAggregationPipeline::MultiFrameAggregationPipeline(gloperate::Environm
     m_colorRenderTargetStage->format.setValue(gl::GL_RGBA);
     m_colorRenderTargetStage->internalFormat.setValue(gl::GL_RGBA32F);
     m_colorRenderTargetStage->type.setValue(gl::GL_FLOAT);
+    m_colorRenderTargetStage->transient.setValue(true); // Intermediate frame is aggregated within the frame
 
     addStage(m_aggregationRenderTargetStage.get());
     m_aggregationRenderTargetStage->size << canvasInterface.viewport;
     m_aggregationRenderTargetStage->format = gl::GL_RGBA;
     m_aggregationRenderTargetStage->internalFormat = gl::GL_RGBA32F;
     m_aggregationRenderTargetStage->type = gl::GL_FLOAT;
+    // Not transient, as the aggregated image is blended with the frames that follow
 
     addStage(m_depthStencilRenderTargetStage.get());
     m_depthStencilRenderTargetStage->size << canvasInterface.viewport;
     m_depthStencilRenderTargetStage->internalFormat.setValue(gl::GL_DEPTH24_STENCIL8);
+    m_depthStencilRenderTargetStage->transient.setValue(true);
 
     addStage(m_controlStage.get());
     m_controlStage->timeDelta << canvasInterface.timeDelta;
@@ -100,6 +103,9 @@ MultiFrameAggregationPipeline::~MultiFrameAggregationPipeline()
 
 void MultiFrameAggregationPipeline::setRenderStage(gloperate::Stage * stage)
 {
+    // Reconnect all inputs first, then propagate the invalidations once
+    UpdateScope update(this);
+
     disconnectRenderStage();
 
     m_renderStage = stage;
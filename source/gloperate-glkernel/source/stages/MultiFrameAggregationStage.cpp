@@ -10,6 +10,7 @@
 
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/AttachmentType.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate_glkernel
@@ -64,28 +65,27 @@ void MultiFrameAggregationStage::onProcess()
     );
 
     fbo->bind(gl::GL_FRAMEBUFFER);
-    fbo->printStatus(true);
 
     if (*aggregationFactor > 0.99f) // first frame, no blending required
     {
-        gl::glDisable(gl::GL_BLEND);
+        gloperate::RenderStateCache::applyCapability(gl::GL_BLEND, false);
     }
     else
     {
         gl::glBlendColor(0.0f, 0.0f, 0.0f, *aggregationFactor);
         gl::glBlendFunc(gl::GL_CONSTANT_ALPHA, gl::GL_ONE_MINUS_CONSTANT_ALPHA);
         gl::glBlendEquation(gl::GL_FUNC_ADD);
-        gl::glEnable(gl::GL_BLEND);
+        gloperate::RenderStateCache::applyCapability(gl::GL_BLEND, true);
     }
 
-    gl::glDisable(gl::GL_DEPTH_TEST);
+    gloperate::RenderStateCache::applyCapability(gl::GL_DEPTH_TEST, false);
 
     m_triangle->setTexture(*intermediateFrame);
     m_triangle->draw();
 
-    gl::glDisable(gl::GL_BLEND);
+    gloperate::RenderStateCache::applyCapability(gl::GL_BLEND, false);
     gl::glBlendFunc(gl::GL_SRC_ALPHA, gl::GL_ONE_MINUS_SRC_ALPHA);
-    gl::glEnable(gl::GL_DEPTH_TEST);
+    gloperate::RenderStateCache::applyCapability(gl::GL_DEPTH_TEST, true);
 
     renderInterface.updateRenderTargetOutputs();
 }
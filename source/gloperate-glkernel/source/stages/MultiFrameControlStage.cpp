@@ -27,6 +27,11 @@ MultiFrameControlStage::~MultiFrameControlStage()
 {
 }
 
+bool MultiFrameControlStage::requiresContext() const
+{
+    return false;
+}
+
 void MultiFrameControlStage::onProcess()
 {
     if (m_currentFrame < *multiFrameCount)
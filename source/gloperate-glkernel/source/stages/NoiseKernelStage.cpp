@@ -7,6 +7,8 @@
 
 #include <globjects/Texture.h>
 
+#include <gloperate/rendering/RenderStateCache.h>
+
 
 namespace gloperate_glkernel
 {
@@ -58,6 +60,7 @@ void NoiseKernelStage::onProcess()
         regenerateKernel();
 
         m_texture->image3D(0, gl::GL_RGB32F, *dimensions, 0, gl::GL_RGB, gl::GL_FLOAT, m_kernel.data());
+        gloperate::RenderStateCache::texturesChanged();
         m_kernelData = {m_kernel.begin(), m_kernel.end()};
     }
 
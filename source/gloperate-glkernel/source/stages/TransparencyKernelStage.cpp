@@ -7,6 +7,8 @@
 
 #include <globjects/Texture.h>
 
+#include <gloperate/rendering/RenderStateCache.h>
+
 
 namespace gloperate_glkernel
 {
@@ -52,6 +54,7 @@ void TransparencyKernelStage::onProcess()
     {
         regenerateKernel();
         m_texture->image2D(0, gl::GL_R8, *kernelSize, 0, gl::GL_RED, gl::GL_UNSIGNED_BYTE, m_kernelData.data());
+        gloperate::RenderStateCache::texturesChanged();
     }
 
     kernel.setValue(&m_kernelData);
@@ -13,6 +13,9 @@
 #include <gloperate-qt/gloperate-qt_api.h>
 
 
+class QImage;
+
+
 namespace globjects
 {
     class Texture;
@@ -67,6 +70,38 @@ public:
 
     // Virtual gloperate::Loader<globjects::Texture> functions
     virtual globjects::Texture * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
+    virtual std::function<globjects::Texture * ()> read(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
+
+
+protected:
+    /**
+    *  @brief
+    *    Read image and convert it into RGBA format
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[out] image
+    *    Converted image
+    *
+    *  @return
+    *    'true' if the image has been read, else 'false'
+    */
+    bool readImage(const std::string & filename, QImage & image) const;
+
+    /**
+    *  @brief
+    *    Create texture from image
+    *
+    *  @param[in] image
+    *    Image in RGBA format
+    *
+    *  @return
+    *    Texture, must be destroyed by the caller
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    globjects::Texture * createTexture(const QImage & image) const;
 
 
 protected:
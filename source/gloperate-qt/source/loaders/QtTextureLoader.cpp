@@ -1,6 +1,8 @@
 
 #include <gloperate-qt/loaders/QtTextureLoader.h>
 
+#include <memory>
+
 #include <QString>
 #include <QImage>
 #include <QImageReader>
@@ -77,29 +79,60 @@ globjects::Texture * QtTextureLoader::load(const std::string & filename, const c
 {
     // Load image
     QImage image;
-    if (image.load(QString::fromStdString(filename))) {
-        // Convert image into RGBA format
-        QImage converted = Converter::convert(image);
-
+    if (readImage(filename, image)) {
         // Create texture
-        //TODO this "release" is ugly but to change it to use unique_ptr all Loaders and the resource manager must be changed
-        globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
-        texture->image2D(
-            0,
-            gl::GL_RGBA8,
-            converted.width(),
-            converted.height(),
-            0,
-            gl::GL_RGBA,
-            gl::GL_UNSIGNED_BYTE,
-            converted.constBits()
-        );
-        return texture;
+        return createTexture(image);
     }
 
     // Could not load image
     return nullptr;
 }
 
+std::function<globjects::Texture * ()> QtTextureLoader::read(const std::string & filename, const cppexpose::Variant & /*options*/, std::function<void(int, int)> /*progress*/) const
+{
+    // Load image on this thread
+    auto image = std::make_shared<QImage>();
+    if (!readImage(filename, *image)) {
+        // Could not load image
+        return [] () -> globjects::Texture * { return nullptr; };
+    }
+
+    // Create texture on the context thread
+    return [this, image] ()
+    {
+        return createTexture(*image);
+    };
+}
+
+bool QtTextureLoader::readImage(const std::string & filename, QImage & image) const
+{
+    // Load image
+    QImage loaded;
+    if (!loaded.load(QString::fromStdString(filename))) {
+        return false;
+    }
+
+    // Convert image into RGBA format
+    image = Converter::convert(loaded);
+    return true;
+}
+
+globjects::Texture * QtTextureLoader::createTexture(const QImage & image) const
+{
+    // Create texture
+    //TODO this "release" is ugly but to change it to use unique_ptr all Loaders and the resource manager must be changed
+    globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
+    texture->image2D(
+        0,
+        gl::GL_RGBA8,
+        image.width(),
+        image.height(),
+        0,
+        gl::GL_RGBA,
+        gl::GL_UNSIGNED_BYTE,
+        image.constBits()
+    );
+    return texture;
+}
 
 } // namespace gloperate_qt
@@ -24,7 +24,7 @@ FontImporterStage::~FontImporterStage()
 
 void FontImporterStage::onProcess()
 {
-    auto newFont = std::unique_ptr<openll::FontFace>{ m_environment->resourceManager()->load<openll::FontFace>(fontFilePath.value().path())};
+    auto newFont = std::unique_ptr<openll::FontFace>{ m_environment->resourceManager()->load<openll::FontFace>(fontFilePath->path())};
 
     if (newFont)
     {
@@ -37,10 +37,10 @@ void GlyphPreparationStage::onContextDeinit(gloperate::AbstractGLContext *)
 
 void GlyphPreparationStage::onProcess()
 {
-    openll::Typesetter::typeset(*m_vertexCloud.get(), *sequences.value(), optimized.value(), false);
+    openll::Typesetter::typeset(*m_vertexCloud.get(), **sequences, *optimized, false);
 
     m_vertexCloud->update(); // update drawable
-    m_vertexCloud->setTexture(font.value()->glyphTexture());
+    m_vertexCloud->setTexture(font->glyphTexture());
 
     vertexCloud.setValue(m_vertexCloud.get());
 }
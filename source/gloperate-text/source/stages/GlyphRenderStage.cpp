@@ -9,6 +9,8 @@
 #include <openll/GlyphRenderer.h>
 #include <openll/GlyphVertexCloud.h>
 
+#include <gloperate/rendering/RenderStateCache.h>
+
 
 namespace gloperate_text
 {
@@ -46,8 +48,8 @@ void GlyphRenderStage::onProcess()
     fbo->bind();
 
     gl::glDepthMask(gl::GL_FALSE);
-    gl::glEnable(gl::GL_CULL_FACE);
-    gl::glEnable(gl::GL_BLEND);
+    gloperate::RenderStateCache::applyCapability(gl::GL_CULL_FACE, true);
+    gloperate::RenderStateCache::applyCapability(gl::GL_BLEND, true);
     gl::glBlendFunc(gl::GL_SRC_ALPHA, gl::GL_ONE_MINUS_SRC_ALPHA);
 
     if (*camera != nullptr)
@@ -58,11 +60,15 @@ void GlyphRenderStage::onProcess()
     {
         m_renderer->render(*vertexCloud.value());
     }
-    
+
+    // The renderer binds the vertex array of the vertex cloud and the glyph texture directly
+    gloperate::RenderStateCache::vertexArrayChanged();
+    gloperate::RenderStateCache::texturesChanged();
+
     gl::glDepthMask(gl::GL_TRUE);
-    gl::glDisable(gl::GL_CULL_FACE);
+    gloperate::RenderStateCache::applyCapability(gl::GL_CULL_FACE, false);
     gl::glBlendFunc(gl::GL_ONE, gl::GL_ZERO);
-    gl::glDisable(gl::GL_BLEND);
+    gloperate::RenderStateCache::applyCapability(gl::GL_BLEND, false);
 
     fbo->unbind();
 
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <vector>
+#include <typeindex>
 
 #include <gloperate/base/Component.h>
 
@@ -81,6 +82,18 @@ public:
     */
     virtual std::string allLoadingTypes() const = 0;
 
+    /**
+    *  @brief
+    *    Get type of the resources that are loaded
+    *
+    *  @return
+    *    Resource type
+    *
+    *  @remarks
+    *    Implemented by Loader<T>, used by the resource manager to index loaders.
+    */
+    virtual std::type_index resourceType() const = 0;
+
 
 protected:
     Environment * m_environment; ///< Gloperate environment to which the loaded belongs
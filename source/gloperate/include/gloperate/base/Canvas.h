@@ -3,8 +3,10 @@
 
 
 #include <string>
+#include <vector>
 #include <mutex>
 
+#include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include <glm/fwd.hpp>
 
@@ -14,11 +16,13 @@
 #include <cppexpose/signal/ScopedConnection.h>
 
 #include <gloperate/base/ChronoTimer.h>
+#include <gloperate/base/MPSCQueue.h>
 
 
 namespace globjects
 {
     class Framebuffer;
+    class NamedString;
 }
 
 
@@ -37,6 +41,17 @@ class DepthRenderTarget;
 class DepthStencilRenderTarget;
 class StencilRenderTarget;
 class BlitStage;
+class FrameProfiler;
+class RenderStateCache;
+class FramebufferCache;
+class UniformRing;
+class GeometryLibrary;
+class UploadQueue;
+class ResourceCache;
+template <typename T>
+class Input;
+template <typename T>
+class Output;
 
 
 /**
@@ -47,6 +62,12 @@ class BlitStage;
 *    actual rendering. It should be embedded by the windowing backend and
 *    receives state changes from the outside (such as window size, mouse,
 *    or keyboard events) and passes them on to the rendering components.
+*
+*    Input events and time updates are passed to the render thread through
+*    a lock-free multi-producer queue, so they may originate from several
+*    threads (e.g., the UI thread, timers, or a video exporter). They are
+*    applied right away if the render thread is idle, else at the start of
+*    the next frame, so the producers never wait for a frame to finish.
 */
 class GLOPERATE_API Canvas : public cppexpose::Object
 {
@@ -97,6 +118,80 @@ public:
     Stage * renderStage();
     //@}
 
+    //@{
+    /**
+    *  @brief
+    *    Get frame profiler
+    *
+    *  @return
+    *    Frame profiler that records the spans of the canvas (never null)
+    */
+    const FrameProfiler * profiler() const;
+    FrameProfiler * profiler();
+    //@}
+
+    //@{
+    /**
+    *  @brief
+    *    Get render state cache
+    *
+    *  @return
+    *    Cache of the OpenGL bindings of the canvas' context (never null)
+    *
+    *  @remarks
+    *    The cache is bound to the render thread during render().
+    *    Its number of avoided OpenGL calls can be used for benchmarking.
+    */
+    const RenderStateCache * renderStateCache() const;
+    RenderStateCache * renderStateCache();
+    //@}
+
+    //@{
+    /**
+    *  @brief
+    *    Get framebuffer cache
+    *
+    *  @return
+    *    Cache of the framebuffers of the canvas' context (never null)
+    *
+    *  @remarks
+    *    The cache is bound to the render thread during render().
+    */
+    const FramebufferCache * framebufferCache() const;
+    FramebufferCache * framebufferCache();
+    //@}
+
+    //@{
+    /**
+    *  @brief
+    *    Get uniform ring
+    *
+    *  @return
+    *    Ring-allocated uniform buffer of the canvas' context (never null)
+    *
+    *  @remarks
+    *    The ring is bound to the render thread during render(), and the
+    *    FrameConstants of each frame are bound to their binding index.
+    */
+    const UniformRing * uniformRing() const;
+    UniformRing * uniformRing();
+    //@}
+
+    //@{
+    /**
+    *  @brief
+    *    Get geometry library
+    *
+    *  @return
+    *    Library of the procedural geometry of the canvas' context (never null)
+    *
+    *  @remarks
+    *    The library is bound to the render thread during render().
+    */
+    const GeometryLibrary * geometryLibrary() const;
+    GeometryLibrary * geometryLibrary();
+    //@}
+
     //@{
     /**
     *  @brief
@@ -157,7 +252,7 @@ public:
     //@{
     /**
     *  @brief
-    *    Update virtual time (must be called from UI thread)
+    *    Update virtual time (may be called from any thread)
     *
     *  @remarks
     *    This function determines the time delta since the last call to
@@ -270,9 +365,84 @@ public:
     void promoteMouseWheel(const glm::vec2 & delta, const glm::ivec2 & pos, int modifier);
     //@}
 
+    //@{
+    /**
+    *  @brief
+    *    Lock canvas, so no frame is rendered until the lock is released
+    *
+    *  @return
+    *    Lock on the canvas mutex
+    *
+    *  @remarks
+    *    Used while scripts are executed, which may group changes
+    *    into pipeline updates that must not be open during a frame.
+    */
+    std::unique_lock<std::recursive_mutex> lock();
+
+    /**
+    *  @brief
+    *    End all pipeline updates that scripts have begun but not ended
+    *
+    *  @remarks
+    *    Called when a script has finished and before each frame.
+    *    A warning is issued for each update that had to be ended.
+    */
+    void endScriptUpdates();
+    //@}
+
+
+protected:
+    /**
+    *  @brief
+    *    Input event that is passed from a producer thread to the render thread
+    */
+    struct InputEvent
+    {
+        enum class Type
+        {
+            KeyPress,
+            KeyRelease,
+            MouseMove,
+            MousePress,
+            MouseRelease,
+            MouseWheel,
+            TimeDelta
+        };
+
+        Type       type;      ///< Event type
+        int        key;       ///< Key or mouse button
+        int        modifier;  ///< Modifiers (gloperate modifier codes)
+        glm::ivec2 pos;       ///< Mouse position
+        glm::vec2  delta;     ///< Wheel delta
+        float      timeDelta; ///< Time delta (in seconds)
+    };
+
 
 protected:
     //@{
+    /**
+    *  @brief
+    *    Queue input event (may be called from any thread)
+    *
+    *  @param[in] event
+    *    Input event
+    *
+    *  @remarks
+    *    If the render thread is idle, the queued events are applied
+    *    immediately. Otherwise, a redraw is requested and the events
+    *    are applied at the start of the next frame.
+    */
+    void queueInputEvent(const InputEvent & event);
+
+    /**
+    *  @brief
+    *    Apply all queued input events
+    *
+    *  @remarks
+    *    Must be called with m_mutex locked.
+    */
+    void processInputEvents();
+
     /**
     *  @brief
     *    Check if a redraw is required
@@ -283,6 +453,17 @@ protected:
     */
     void checkRedraw();
 
+    /**
+    *  @brief
+    *    Bind the well-known slots of the render stage
+    *
+    *  @remarks
+    *    Looks up the time delta, viewport and render target slots once,
+    *    so they are not searched for on every frame. Called when the
+    *    render stage is set and when it adds or removes slots.
+    */
+    void bindRenderStageSlots();
+
     /**
     *  @brief
     *    Promote changes of input slots
@@ -314,6 +495,8 @@ protected:
     cppexpose::Variant scr_getSlot(const std::string & path, const std::string & slot);
     cppexpose::Variant scr_getValue(const std::string & path, const std::string & slot);
     void scr_setValue(const std::string & path, const std::string & slot, const cppexpose::Variant & value);
+    void scr_beginUpdate(const std::string & path);
+    void scr_endUpdate(const std::string & path);
     //@}
 
     //@{
@@ -324,30 +507,56 @@ protected:
 
 
 protected:
-    Environment                             * m_environment;            ///< Gloperate environment to which the canvas belongs
-    AbstractGLContext                       * m_openGLContext;          ///< OpenGL context used for rendering onto the canvas
-    bool                                      m_initialized;            ///< 'true' if the context has been initialized and the viewport has been set, else 'false'
-    gloperate::ChronoTimer                    m_clock;                  ///< Time measurement
-    glm::vec4                                 m_viewport;               ///< Viewport (in real device coordinates)
-    float                                     m_timeDelta;              ///< Time delta since the last update (in seconds)
-    std::unique_ptr<Stage>                    m_renderStage;            ///< Render stage that renders into the canvas
-    std::unique_ptr<Stage>                    m_oldStage;               ///< Old render stage, will be destroyed on the next render call
-    std::unique_ptr<BlitStage>                m_blitStage;              ///< Blit stage that is used to blit to target color attachment if render stage uses own targets
-    std::unique_ptr<MouseDevice>              m_mouseDevice;            ///< Device for Mouse Events
-    std::unique_ptr<KeyboardDevice>           m_keyboardDevice;         ///< Device for Keyboard Events
-    bool                                      m_replaceStage;           ///< 'true' if the stage has just been replaced, else 'false'
-    std::recursive_mutex                      m_mutex;                  ///< Mutex for separating main and render thread
-    cppexpose::ScopedConnection               m_inputChangedConnection; ///< Connection for the inputChanged-signal of the current stage
-    cppexpose::Function                       m_inputChangedCallback;   ///< Script function that is called on inputChanged (slot, status)
-    std::vector<cppexpose::Function>          m_renderedCallbacks;      ///< Script functions that are called once after rendering
-    bool                                      m_rendered;               ///< 'true' after a new frame has been drawn
-    std::vector<AbstractSlot *>               m_changedInputs;          ///< List of changed input slots
-    std::mutex                                m_changedInputMutex;      ///< Mutex to access m_changedInputs
-
-    std::unique_ptr<ColorRenderTarget>        m_colorTarget;            ///< Input render target for color attachment
-    std::unique_ptr<DepthRenderTarget>        m_depthTarget;            ///< Input render target for depth attachment
-    std::unique_ptr<DepthStencilRenderTarget> m_depthStencilTarget;     ///< Input render target for combined depth stencil attachment
-    std::unique_ptr<StencilRenderTarget>      m_stencilTarget;          ///< Input render target for stencil attachment
+    Environment                                      * m_environment;              ///< Gloperate environment to which the canvas belongs
+    AbstractGLContext                                * m_openGLContext;            ///< OpenGL context used for rendering onto the canvas
+    bool                                               m_initialized;              ///< 'true' if the context has been initialized and the viewport has been set, else 'false'
+    gloperate::ChronoTimer                             m_clock;                    ///< Time measurement
+    std::mutex                                         m_clockMutex;               ///< Mutex for concurrent calls of updateTime()
+    glm::vec4                                          m_viewport;                 ///< Viewport (in real device coordinates)
+    float                                              m_timeDelta;                ///< Time delta since the last update (in seconds)
+    std::unique_ptr<ResourceCache>                     m_resourceCache;            ///< Cache of the resources of the context (outlives the stages, which are connected to it)
+    std::unique_ptr<Stage>                             m_renderStage;              ///< Render stage that renders into the canvas
+    std::unique_ptr<Stage>                             m_oldStage;                 ///< Old render stage, will be destroyed on the next render call
+    std::unique_ptr<BlitStage>                         m_blitStage;                ///< Blit stage that is used to blit to target color attachment if render stage uses own targets
+    std::unique_ptr<MouseDevice>                       m_mouseDevice;              ///< Device for Mouse Events
+    std::unique_ptr<KeyboardDevice>                    m_keyboardDevice;           ///< Device for Keyboard Events
+    FrameProfiler                                    * m_profiler;                 ///< Frame profiler (owned as property)
+    std::unique_ptr<RenderStateCache>                  m_stateCache;               ///< Cache of the OpenGL bindings of the context
+    std::unique_ptr<FramebufferCache>                  m_framebufferCache;         ///< Cache of the framebuffers of the context
+    std::unique_ptr<UniformRing>                       m_uniformRing;              ///< Ring-allocated uniform buffer of the context
+    std::unique_ptr<GeometryLibrary>                   m_geometryLibrary;          ///< Library of the procedural geometry of the context
+    std::shared_ptr<UploadQueue>                       m_uploadQueue;              ///< Creations of resources loaded in the background for the context
+    std::unique_ptr<globjects::NamedString>            m_constantsNamedString;     ///< Shader include of the frame and transform constants in the context
+    float                                              m_time;                     ///< Time since the first rendered frame (in seconds)
+    int                                                m_frameCounter;             ///< Number of rendered frames
+    bool                                               m_replaceStage;             ///< 'true' if the stage has just been replaced, else 'false'
+    std::recursive_mutex                               m_mutex;                    ///< Mutex for separating main and render thread
+    std::vector<std::string>                           m_scriptUpdates;            ///< Paths of the pipelines whose update has been begun by a script and not ended yet
+    MPSCQueue<InputEvent>                              m_inputEvents;              ///< Input events from producer threads, not yet applied
+    cppexpose::ScopedConnection                        m_inputChangedConnection;   ///< Connection for the inputChanged-signal of the current stage
+    cppexpose::ScopedConnection                        m_inputAddedConnection;     ///< Connection for the inputAdded-signal of the current stage
+    cppexpose::ScopedConnection                        m_inputRemovedConnection;   ///< Connection for the inputRemoved-signal of the current stage
+    cppexpose::ScopedConnection                        m_outputAddedConnection;    ///< Connection for the outputAdded-signal of the current stage
+    cppexpose::ScopedConnection                        m_outputRemovedConnection;  ///< Connection for the outputRemoved-signal of the current stage
+    cppexpose::Function                                m_inputChangedCallback;     ///< Script function that is called on inputChanged (slot, status)
+    std::vector<cppexpose::Function>                   m_renderedCallbacks;        ///< Script functions that are called once after rendering
+    bool                                               m_rendered;                 ///< 'true' after a new frame has been drawn
+    std::vector<AbstractSlot *>                        m_changedInputs;            ///< List of changed input slots
+    std::mutex                                         m_changedInputMutex;        ///< Mutex to access m_changedInputs
+
+    std::unique_ptr<ColorRenderTarget>                 m_colorTarget;              ///< Input render target for color attachment
+    std::unique_ptr<DepthRenderTarget>                 m_depthTarget;              ///< Input render target for depth attachment
+    std::unique_ptr<DepthStencilRenderTarget>          m_depthStencilTarget;       ///< Input render target for combined depth stencil attachment
+    std::unique_ptr<StencilRenderTarget>               m_stencilTarget;            ///< Input render target for stencil attachment
+
+    Input<float>                                     * m_timeDeltaInput;           ///< 'timeDelta' input of the render stage (can be null)
+    Input<glm::vec4>                                 * m_viewportInput;            ///< 'viewport' input of the render stage (can be null)
+    std::vector<Input<ColorRenderTarget *> *>          m_colorTargetInputs;        ///< Color render target inputs of the render stage
+    std::vector<Input<DepthRenderTarget *> *>          m_depthTargetInputs;        ///< Depth render target inputs of the render stage
+    std::vector<Input<DepthStencilRenderTarget *> *>   m_depthStencilTargetInputs; ///< Depth stencil render target inputs of the render stage
+    std::vector<Input<StencilRenderTarget *> *>        m_stencilTargetInputs;      ///< Stencil render target inputs of the render stage
+    std::vector<Output<ColorRenderTarget *> *>         m_colorTargetOutputs;       ///< Color render target outputs of the render stage
+    Output<glm::vec4>                                * m_viewportOutput;           ///< First viewport output of the render stage (can be null)
 };
 
 
@@ -47,6 +47,18 @@ public:
     */
     void scanPlugins();
 
+    /**
+    *  @brief
+    *    Get revision of the available components
+    *
+    *  @return
+    *    Number that changes whenever components may have been added by scanPlugins()
+    *
+    *  @remarks
+    *    Users that index components compare the revision to re-index lazily.
+    */
+    unsigned int revision() const;
+
 
 protected:
     // Scripting functions
@@ -58,6 +70,10 @@ protected:
     void scr_scanPlugins();
     cppexpose::Variant scr_components();
     void scr_printComponents();
+
+
+protected:
+    unsigned int m_revision; ///< Revision of the available components
 };
 
 
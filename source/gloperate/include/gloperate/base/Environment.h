@@ -12,6 +12,7 @@
 #include <gloperate/base/ResourceManager.h>
 #include <gloperate/base/System.h>
 #include <gloperate/base/TimerManager.h>
+#include <gloperate/base/ThreadPool.h>
 #include <gloperate/input/InputManager.h>
 
 
@@ -115,6 +116,18 @@ public:
     TimerManager * timerManager();
     //@}
 
+    //@{
+    /**
+    *  @brief
+    *    Get thread pool
+    *
+    *  @return
+    *    Thread pool for processing tasks that do not need an OpenGL context (never null)
+    */
+    const ThreadPool * threadPool() const;
+    ThreadPool * threadPool();
+    //@}
+
     //@{
     /**
     *  @brief
@@ -258,6 +271,7 @@ protected:
     System                                    m_system;           ///< System functions for scripting
     InputManager                              m_inputManager;     ///< Manager for Devices, -Providers and InputEvents
     TimerManager                              m_timerManager;     ///< Manager for scripting timers
+    ThreadPool                                m_threadPool;       ///< Thread pool for context-free tasks
 
     std::vector<Canvas *>                     m_canvases;         ///< List of active canvases
 
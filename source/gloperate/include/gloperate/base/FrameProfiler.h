@@ -0,0 +1,327 @@
+
+#pragma once
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+#include <cppexpose/reflection/Object.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Frame profiler that records CPU and GPU spans of a canvas
+*
+*    Spans are stored in a fixed-size lock-free ring buffer, so that
+*    stages processed on worker threads can record spans concurrently
+*    and long-running sessions keep only the most recent events.
+*    The recorded spans can be exported as Chrome trace-event JSON,
+*    which can be opened in chrome://tracing or Perfetto.
+*
+*    GPU spans are measured using timestamp queries on threads that have
+*    bound the profiler together with the OpenGL context (see ThreadBinding).
+*    Query results are collected without stalling in beginFrame().
+*
+*    Recording is disabled by default, so stages do not issue queries or
+*    build span names. It is enabled with setEnabled(), or at startup by
+*    setting the environment variable GLOPERATE_PROFILE to 1.
+*
+*    Scripting interface (gloperate.<canvas>.profiler):
+*      dump(filename)     Write recorded spans as trace-event JSON
+*      enabled()          Check if spans are recorded
+*      setEnabled(bool)   Enable or disable recording
+*/
+class GLOPERATE_API FrameProfiler : public cppexpose::Object
+{
+public:
+    using clock = std::chrono::high_resolution_clock;
+    using time_point = clock::time_point;
+
+
+public:
+    /**
+    *  @brief
+    *    Binding of a profiler to the current thread
+    *
+    *    While a binding exists, FrameProfiler::current() returns the bound
+    *    profiler on this thread. The previous binding is restored on destruction.
+    */
+    class GLOPERATE_API ThreadBinding
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] profiler
+        *    Profiler (can be null)
+        *  @param[in] contextThread
+        *    'true' if the OpenGL context of the profiler is current on this thread, else 'false'
+        */
+        ThreadBinding(FrameProfiler * profiler, bool contextThread);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~ThreadBinding();
+
+        // No copying
+        ThreadBinding(const ThreadBinding &) = delete;
+        ThreadBinding & operator=(const ThreadBinding &) = delete;
+
+
+    protected:
+        FrameProfiler * m_previousProfiler;      ///< Previously bound profiler
+        bool            m_previousContextThread; ///< Previous context status of the thread
+    };
+
+    /**
+    *  @brief
+    *    Span that is recorded from construction to destruction
+    *
+    *    If the profiler is bound to the current thread together with
+    *    its OpenGL context, a GPU span is recorded as well.
+    */
+    class GLOPERATE_API Scope
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] profiler
+        *    Profiler (can be null, in which case nothing is recorded)
+        *  @param[in] name
+        *    Name of the span (must stay valid until the scope ends)
+        */
+        Scope(FrameProfiler * profiler, const char * name);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~Scope();
+
+        // No copying
+        Scope(const Scope &) = delete;
+        Scope & operator=(const Scope &) = delete;
+
+
+    protected:
+        FrameProfiler * m_profiler; ///< Profiler (can be null)
+        const char    * m_name;     ///< Name of the span
+        time_point      m_begin;    ///< Start time
+        int             m_gpuSpan;  ///< GPU span handle (-1 if no GPU span is measured)
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Get profiler bound to the current thread
+    *
+    *  @return
+    *    Profiler, null if no profiler is bound or the profiler is disabled
+    */
+    static FrameProfiler * current();
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] name
+    *    Object name
+    */
+    FrameProfiler(const std::string & name = "profiler");
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    virtual ~FrameProfiler();
+
+    /**
+    *  @brief
+    *    Check if spans are recorded
+    *
+    *  @return
+    *    'true' if enabled, else 'false'
+    */
+    bool enabled() const;
+
+    /**
+    *  @brief
+    *    Enable or disable recording of spans
+    *
+    *  @param[in] enabled
+    *    'true' if enabled, else 'false'
+    */
+    void setEnabled(bool enabled);
+
+    /**
+    *  @brief
+    *    Record CPU span
+    *
+    *  @param[in] name
+    *    Name of the span
+    *  @param[in] begin
+    *    Start time
+    *  @param[in] end
+    *    End time
+    *
+    *  @remarks
+    *    Can be called from any thread. Spans are recorded without allocations.
+    */
+    void addSpan(const char * name, const time_point & begin, const time_point & end);
+
+    /**
+    *  @brief
+    *    Start frame
+    *
+    *    Collects available GPU query results and calibrates the GPU clock.
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    void beginFrame();
+
+    /**
+    *  @brief
+    *    Release OpenGL objects
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    void deinitContext();
+
+    /**
+    *  @brief
+    *    Write recorded spans as Chrome trace-event JSON
+    *
+    *  @param[in] filename
+    *    Output file name
+    *
+    *  @return
+    *    'true' on success, else 'false'
+    */
+    bool dump(const std::string & filename) const;
+
+
+protected:
+    static const std::size_t s_nameLength = 96; ///< Maximum length of span names (including terminator)
+
+    /**
+    *  @brief
+    *    Span record in the ring buffer
+    *
+    *    The sequence number is odd while the record is written,
+    *    so readers can detect and skip records that are torn.
+    */
+    struct Event
+    {
+        std::atomic<std::uint64_t> sequence;           ///< Sequence number of the record
+        char                       name[s_nameLength]; ///< Name of the span (truncated)
+        std::int64_t               begin;              ///< Start time (in nanoseconds since creation of the profiler)
+        std::int64_t               end;                ///< End time (in nanoseconds since creation of the profiler)
+        std::uint32_t              thread;             ///< Thread ID (0 for GPU spans)
+    };
+
+    /**
+    *  @brief
+    *    GPU span that waits for its query results
+    */
+    struct GPUSpan
+    {
+        char         name[s_nameLength]; ///< Name of the span (truncated)
+        unsigned int startQuery;         ///< Timestamp query for the start
+        unsigned int endQuery;           ///< Timestamp query for the end
+        std::int64_t offset;             ///< Offset from GPU to CPU time (in nanoseconds)
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Start GPU span on the context thread
+    *
+    *  @param[in] name
+    *    Name of the span
+    *
+    *  @return
+    *    Span handle, -1 if no query is available
+    */
+    int beginGPUSpan(const char * name);
+
+    /**
+    *  @brief
+    *    Stop GPU span on the context thread
+    *
+    *  @param[in] handle
+    *    Span handle returned by beginGPUSpan()
+    */
+    void endGPUSpan(int handle);
+
+    /**
+    *  @brief
+    *    Write span into the ring buffer
+    *
+    *  @param[in] name
+    *    Name of the span
+    *  @param[in] begin
+    *    Start time (in nanoseconds since creation of the profiler)
+    *  @param[in] end
+    *    End time (in nanoseconds since creation of the profiler)
+    *  @param[in] thread
+    *    Thread ID
+    */
+    void record(const char * name, std::int64_t begin, std::int64_t end, std::uint32_t thread);
+
+    /**
+    *  @brief
+    *    Get nanoseconds since creation of the profiler
+    *
+    *  @param[in] time
+    *    Time point
+    *
+    *  @return
+    *    Nanoseconds since creation of the profiler
+    */
+    std::int64_t toNanoseconds(const time_point & time) const;
+
+    // Scripting functions
+    bool scr_dump(const std::string & filename);
+    bool scr_enabled();
+    void scr_setEnabled(bool enabled);
+
+
+protected:
+    static const std::size_t s_numEvents;     ///< Capacity of the ring buffer
+    static const std::size_t s_maxNumQueries; ///< Maximum number of timestamp queries in flight
+
+    time_point                  m_epoch;        ///< Creation time of the profiler
+    std::atomic<bool>           m_enabled;      ///< 'true' if spans are recorded, else 'false'
+    std::unique_ptr<Event[]>    m_events;       ///< Ring buffer of recorded spans
+    std::atomic<std::uint64_t>  m_writeIndex;   ///< Index of the next record to be written
+    std::vector<unsigned int>   m_freeQueries;  ///< Unused timestamp queries (context thread only)
+    std::size_t                 m_numQueries;   ///< Number of created timestamp queries (context thread only)
+    std::vector<GPUSpan>        m_openSpans;    ///< Started GPU spans (context thread only)
+    std::deque<GPUSpan>         m_pendingSpans; ///< Finished GPU spans waiting for results (context thread only)
+    std::int64_t                m_gpuOffset;    ///< Offset from GPU to CPU time (in nanoseconds)
+};
+
+
+} // namespace gloperate
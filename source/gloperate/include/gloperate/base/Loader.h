@@ -41,6 +41,9 @@ public:
     */
     virtual ~Loader();
 
+    // Virtual AbstractLoader functions
+    virtual std::type_index resourceType() const override;
+
     /**
     *  @brief
     *    Load resource from file
@@ -56,6 +59,30 @@ public:
     *    Loaded resource (can be null)
     */
     virtual T * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const = 0;
+
+    /**
+    *  @brief
+    *    Read resource from file for creation on the OpenGL context thread
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options for loading resource, see documentation of specific loader for supported options
+    *  @param[in] progress
+    *    Callback function that is invoked on progress (can be empty)
+    *
+    *  @return
+    *    Function that creates the resource with the OpenGL context current. It is called
+    *    until it returns 'true' and then provides the resource in its argument (can be null).
+    *
+    *  @remarks
+    *    Called on a worker thread by ResourceManager::loadAsync(), so it must not use OpenGL.
+    *    Loaders should read and decode the file here and leave only the creation of OpenGL
+    *    objects to the returned function. Resources that take long to upload should be
+    *    created in several calls, which are spread over frames (see UploadQueue::pushSteps()).
+    *    The default implementation defers load() as a whole to the context thread.
+    */
+    virtual std::function<bool (T * & resource)> read(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const;
 };
 
 
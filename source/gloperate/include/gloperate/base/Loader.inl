@@ -2,6 +2,11 @@
 #pragma once
 
 
+#include <typeinfo>
+
+#include <cppexpose/variant/Variant.h>
+
+
 namespace gloperate
 {
 
@@ -17,5 +22,22 @@ Loader<T>::~Loader()
 {
 }
 
+template <typename T>
+std::type_index Loader<T>::resourceType() const
+{
+    return typeid(T);
+}
+
+template <typename T>
+std::function<bool (T * & resource)> Loader<T>::read(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+{
+    // Nothing can be done without OpenGL
+    return [this, filename, options, progress] (T * & resource)
+    {
+        resource = load(filename, options, progress);
+        return true;
+    };
+}
+
 
 } // namespace gloperate
@@ -0,0 +1,122 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Bounded lock-free queue for multiple producers and a single consumer
+*
+*    Elements are stored in a fixed ring buffer, so neither push() nor
+*    pop() allocates or blocks. Each cell carries a sequence number:
+*    producers on any thread claim a cell by advancing the tail with a
+*    compare-and-swap and publish the element by updating the sequence
+*    number of that cell. pop() must only be called from one consumer
+*    thread at a time. If consumers on different threads are serialized
+*    by a mutex, the mutex provides the required ordering between them.
+*
+*  @tparam T
+*    Element type (must be default constructible and copy assignable)
+*/
+template <typename T>
+class GLOPERATE_TEMPLATE_API MPSCQueue
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] capacity
+    *    Maximum number of elements (rounded up to a power of two)
+    */
+    MPSCQueue(std::size_t capacity);
+
+    // No copying
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue & operator=(const MPSCQueue &) = delete;
+
+    /**
+    *  @brief
+    *    Get maximum number of elements
+    *
+    *  @return
+    *    Capacity of the queue
+    */
+    std::size_t capacity() const;
+
+    /**
+    *  @brief
+    *    Check if the queue is empty
+    *
+    *  @return
+    *    'true' if no element is ready to be removed, else 'false'
+    *
+    *  @remarks
+    *    The result may be outdated immediately if other threads
+    *    modify the queue concurrently.
+    */
+    bool empty() const;
+
+    /**
+    *  @brief
+    *    Append element (any thread)
+    *
+    *  @param[in] value
+    *    Element
+    *
+    *  @return
+    *    'true' if the element has been queued, 'false' if the queue is full
+    */
+    bool push(const T & value);
+
+    /**
+    *  @brief
+    *    Remove first element (consumer thread only)
+    *
+    *  @param[out] value
+    *    Element
+    *
+    *  @return
+    *    'true' if an element has been removed, 'false' if the queue is empty
+    *
+    *  @remarks
+    *    An element whose producer has claimed, but not yet published
+    *    its cell is not returned, it is removed by a later call.
+    */
+    bool pop(T & value);
+
+
+protected:
+    /**
+    *  @brief
+    *    Ring buffer cell
+    */
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence; ///< Index + 1 when the element is published, index + capacity when the cell is free again
+        T                        value;    ///< Element
+    };
+
+
+protected:
+    std::size_t              m_mask;  ///< Capacity - 1, used to wrap indices
+    std::unique_ptr<Cell[]>  m_cells; ///< Ring buffer
+    std::atomic<std::size_t> m_head;  ///< Index of the next element to be removed (written by consumer)
+    std::atomic<std::size_t> m_tail;  ///< Index of the next cell to be claimed (written by producers)
+};
+
+
+} // namespace gloperate
+
+
+#include <gloperate/base/MPSCQueue.inl>
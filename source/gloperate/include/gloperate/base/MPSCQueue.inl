@@ -0,0 +1,97 @@
+
+#pragma once
+
+
+namespace gloperate
+{
+
+
+template <typename T>
+MPSCQueue<T>::MPSCQueue(std::size_t capacity)
+: m_mask(0)
+, m_head(0)
+, m_tail(0)
+{
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+
+    m_mask = size - 1;
+    m_cells.reset(new Cell[size]);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+std::size_t MPSCQueue<T>::capacity() const
+{
+    return m_mask + 1;
+}
+
+template <typename T>
+bool MPSCQueue<T>::empty() const
+{
+    const auto head = m_head.load(std::memory_order_relaxed);
+
+    return m_cells[head & m_mask].sequence.load(std::memory_order_acquire) != head + 1;
+}
+
+template <typename T>
+bool MPSCQueue<T>::push(const T & value)
+{
+    auto tail = m_tail.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        Cell & cell = m_cells[tail & m_mask];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+        if (sequence == tail)
+        {
+            // Cell is free, claim it (on failure, tail is reloaded)
+            if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+            {
+                cell.value = value;
+                cell.sequence.store(tail + 1, std::memory_order_release);
+
+                return true;
+            }
+        }
+        else if (static_cast<std::ptrdiff_t>(sequence - tail) < 0)
+        {
+            // Cell still holds an element of the previous round
+            return false;
+        }
+        else
+        {
+            // Another producer has claimed the cell
+            tail = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+bool MPSCQueue<T>::pop(T & value)
+{
+    const auto head = m_head.load(std::memory_order_relaxed);
+    Cell & cell = m_cells[head & m_mask];
+
+    if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+    {
+        return false;
+    }
+
+    value = cell.value;
+    cell.sequence.store(head + m_mask + 1, std::memory_order_release);
+    m_head.store(head + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+
+} // namespace gloperate
@@ -0,0 +1,217 @@
+
+#pragma once
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <typeindex>
+
+#include <cppexpose/signal/Signal.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace cppexpose
+{
+    class Variant;
+}
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Cache of the resources of an OpenGL context
+*
+*    Resources obtained by ResourceManager::get() or loadAsync() are cached
+*    by canonical path, options and type, so a file is loaded once per
+*    context no matter how many stages use it. The cache only holds weak
+*    references; a resource is deleted when the last stage releases it.
+*
+*    checkModifiedFiles() may be called from any thread, it only marks the
+*    entries of modified files. processChanges() drops them and emits
+*    resourceChanged on the render thread of the context, so stages reload
+*    their resources in their own context while their canvas is locked.
+*
+*    A cache is bound to the current thread together with its OpenGL
+*    context using ThreadBinding; without a binding, current() returns null.
+*/
+class GLOPERATE_API ResourceCache
+{
+public:
+    /**
+    *  @brief
+    *    Binding of a cache to the current thread
+    *
+    *    While a binding exists, ResourceCache::current() returns the bound
+    *    cache on this thread. The previous binding is restored on destruction.
+    */
+    class GLOPERATE_API ThreadBinding
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] cache
+        *    Cache of the OpenGL context that is current on this thread (can be null)
+        */
+        ThreadBinding(ResourceCache * cache);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~ThreadBinding();
+
+        // No copying
+        ThreadBinding(const ThreadBinding &) = delete;
+        ThreadBinding & operator=(const ThreadBinding &) = delete;
+
+
+    protected:
+        ResourceCache * m_previousCache; ///< Previously bound cache
+    };
+
+
+public:
+    cppexpose::Signal<const std::string &> resourceChanged; ///< Called on the render thread when the file of a cached resource has been modified (canonical path)
+
+
+public:
+    /**
+    *  @brief
+    *    Get cache bound to the current thread
+    *
+    *  @return
+    *    Cache, null if no cache is bound
+    */
+    static ResourceCache * current();
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    ResourceCache();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~ResourceCache();
+
+    // No copying
+    ResourceCache(const ResourceCache &) = delete;
+    ResourceCache & operator=(const ResourceCache &) = delete;
+
+    /**
+    *  @brief
+    *    Get cached resource
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options the resource has been loaded with
+    *  @param[in] type
+    *    Type of the resource
+    *
+    *  @return
+    *    Resource, null if it is not cached
+    */
+    std::shared_ptr<void> find(const std::string & filename, const cppexpose::Variant & options, std::type_index type) const;
+
+    /**
+    *  @brief
+    *    Add resource to the cache
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options the resource has been loaded with
+    *  @param[in] type
+    *    Type of the resource
+    *  @param[in] resource
+    *    Resource (must NOT be null!)
+    *
+    *  @return
+    *    Cached resource, which is a resource of the same file that has been cached meanwhile, if any
+    */
+    std::shared_ptr<void> add(const std::string & filename, const cppexpose::Variant & options, std::type_index type, std::shared_ptr<void> resource);
+
+    /**
+    *  @brief
+    *    Check if the files of cached resources have been modified
+    *
+    *  @remarks
+    *    Modification times are compared at most every 500 ms, more frequent
+    *    calls return immediately. Entries of modified files are only marked,
+    *    they are handled by processChanges().
+    *    Thread-safe.
+    */
+    void checkModifiedFiles();
+
+    /**
+    *  @brief
+    *    Check if entries of modified files are waiting to be handled
+    *
+    *  @return
+    *    'true' if processChanges() has work to do, else 'false'
+    *
+    *  @remarks
+    *    Thread-safe.
+    */
+    bool hasChanges() const;
+
+    /**
+    *  @brief
+    *    Drop resources of modified files and notify their users
+    *
+    *  @remarks
+    *    resourceChanged is emitted once per modified file, so stages
+    *    can reload the resource right away.
+    *    Must be called with the OpenGL context current.
+    */
+    void processChanges();
+
+    /**
+    *  @brief
+    *    Drop all entries
+    *
+    *  @remarks
+    *    Called when the context is destroyed.
+    */
+    void clear();
+
+
+protected:
+    /**
+    *  @brief
+    *    Cached resource
+    */
+    struct Entry
+    {
+        std::string         path;             ///< Canonical path of the file
+        std::string         options;          ///< Options the resource has been loaded with (JSON)
+        std::type_index     type;             ///< Type of the resource
+        unsigned int        modificationTime; ///< Modification time of the file when it was loaded
+        bool                modified;         ///< 'true' if the file has been modified since, else 'false'
+        std::weak_ptr<void> resource;         ///< Resource, expires when it is no longer used
+    };
+
+
+protected:
+    mutable std::mutex                    m_mutex;     ///< Mutex for accessing m_entries and m_lastCheck
+    std::vector<Entry>                    m_entries;   ///< Cached resources
+    bool                                  m_modified;  ///< 'true' if an entry has been marked as modified, else 'false'
+    std::chrono::steady_clock::time_point m_lastCheck; ///< Time of the last check for modified files
+};
+
+
+} // namespace gloperate
@@ -4,12 +4,19 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <memory>
 #include <functional>
+#include <future>
+#include <mutex>
+#include <typeindex>
 
 #include <cppexpose/reflection/Object.h>
 #include <cppexpose/variant/Variant.h>
 
 #include <gloperate/gloperate_api.h>
+#include <gloperate/base/AbstractLoader.h>
+#include <gloperate/base/AbstractStorer.h>
 
 
 namespace gloperate
@@ -17,16 +24,46 @@ namespace gloperate
 
 
 class Environment;
-class AbstractLoader;
-class AbstractStorer;
+class ThreadPool;
+template <typename T>
+class Loader;
+template <typename T>
+class Storer;
 
 
 /**
 *  @brief
 *    Class to help loading/accessing resources (textures, ...)
+*
+*    Resources obtained by get() or loadAsync() are cached in the resource
+*    cache of the OpenGL context that is current on the calling thread (see
+*    ResourceCache), so canvases that do not share their contexts never
+*    share OpenGL objects. Without a bound cache, resources are not cached.
+*
+*    Loaders and storers are looked up by resource type and file extension
+*    in an index that is built from the file types they declare. If several
+*    declare the same file type, the one instantiated first takes precedence,
+*    so components of later plugin scans never replace existing ones. File
+*    types that are not declared are resolved once by asking canLoad() or
+*    canStore() in the same order. The index is rebuilt lazily after
+*    ComponentManager::scanPlugins().
 */
 class GLOPERATE_API ResourceManager : public cppexpose::Object
 {
+public:
+    /**
+    *  @brief
+    *    Get canonical path of a file
+    *
+    *  @param[in] filename
+    *    File name
+    *
+    *  @return
+    *    Path with '.' and '..' resolved, as passed to ResourceCache::resourceChanged
+    */
+    static std::string canonicalPath(const std::string & filename);
+
+
 public:
     /**
     *  @brief
@@ -80,6 +117,53 @@ public:
     template <typename T>
     T * load(const std::string & filename, const cppexpose::Variant & options = cppexpose::Variant(), std::function<void(int, int)> progress = std::function<void(int, int)>()) const;
 
+    /**
+    *  @brief
+    *    Get cached resource, or load it from file
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options for loading resource, see documentation of specific loader for supported options
+    *
+    *  @return
+    *    Resource shared with all users of the same file, options and type in the current context (can be null)
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    template <typename T>
+    std::shared_ptr<T> get(const std::string & filename, const cppexpose::Variant & options = cppexpose::Variant());
+
+    /**
+    *  @brief
+    *    Load resource from file in the background
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options for loading resource, see documentation of specific loader for supported options
+    *  @param[in] progress
+    *    Callback function that is invoked on progress from the I/O thread or the render thread (can be empty)
+    *
+    *  @return
+    *    Future that becomes ready when the resource has been created (the resource can be null)
+    *
+    *  @remarks
+    *    A cached resource is returned right away, otherwise the file is read and decoded
+    *    on a dedicated I/O thread (see Loader::read()), so the tasks of the environment
+    *    thread pool, on which the render thread may wait, never queue behind disk access. The OpenGL objects are
+    *    created afterwards by the upload queue that is bound to the calling thread (see
+    *    UploadQueue), which the canvas processes on its render thread before processing
+    *    the pipeline, so the resource belongs to the context of that canvas. Loaders may
+    *    split the creation into steps, which are spread over frames. Without a
+    *    bound queue, or if reading or creating the resource fails, the future provides
+    *    null. Rendering never waits for the resource; stages keep their previous resource
+    *    until the future is ready.
+    */
+    template <typename T>
+    std::future<std::shared_ptr<T>> loadAsync(const std::string & filename, const cppexpose::Variant & options = cppexpose::Variant(), std::function<void(int, int)> progress = std::function<void(int, int)>());
+
     /**
     *  @brief
     *    Store resource to file
@@ -103,7 +187,10 @@ public:
 protected:
     /**
     *  @brief
-    *    Update list of available loaders and storers
+    *    Instantiate loaders and storers of new components and rebuild the index
+    *
+    *  @remarks
+    *    Existing loaders are kept, as background loads may be using them.
     */
     void updateComponents() const;
 
@@ -113,11 +200,79 @@ protected:
     */
     void clearComponents() const;
 
+    /**
+    *  @brief
+    *    Find loader for a file
+    *
+    *  @param[in] filename
+    *    File name
+    *
+    *  @return
+    *    Loader that can load the file type, null if there is none
+    */
+    template <typename T>
+    Loader<T> * findLoader(const std::string & filename) const;
+
+    /**
+    *  @brief
+    *    Find loader for a file
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] type
+    *    Resource type
+    *
+    *  @return
+    *    Loader of the resource type that can load the file type, null if there is none
+    *
+    *  @remarks
+    *    Thread-safe.
+    */
+    AbstractLoader * findLoader(const std::string & filename, std::type_index type) const;
+
+    /**
+    *  @brief
+    *    Find storer for a file
+    *
+    *  @param[in] filename
+    *    File name
+    *
+    *  @return
+    *    Storer that can store the file type, null if there is none
+    */
+    template <typename T>
+    Storer<T> * findStorer(const std::string & filename) const;
+
+    /**
+    *  @brief
+    *    Find storer for a file
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] type
+    *    Resource type
+    *
+    *  @return
+    *    Storer of the resource type that can store the file type, null if there is none
+    *
+    *  @remarks
+    *    Thread-safe.
+    */
+    AbstractStorer * findStorer(const std::string & filename, std::type_index type) const;
+
 
 protected:
-    Environment                                        * m_environment; ///< Gloperate environment (must NOT be null!)
-    mutable std::vector<std::unique_ptr<AbstractLoader>> m_loaders;     ///< Available loaders
-    mutable std::vector<std::unique_ptr<AbstractStorer>> m_storers;     ///< Available storers
+    Environment                                                                                   * m_environment;     ///< Gloperate environment (must NOT be null!)
+    mutable std::vector<std::unique_ptr<AbstractLoader>>                                           m_loaders;          ///< Available loaders, by priority
+    mutable std::vector<std::unique_ptr<AbstractStorer>>                                           m_storers;          ///< Available storers, by priority
+    mutable std::vector<AbstractLoader::AbstractComponentType *>                                   m_loaderComponents; ///< Components of the available loaders
+    mutable std::vector<AbstractStorer::AbstractComponentType *>                                   m_storerComponents; ///< Components of the available storers
+    mutable std::unordered_map<std::type_index, std::unordered_map<std::string, AbstractLoader *>> m_loaderIndex;      ///< Loaders by resource type and file extension (null if there is none)
+    mutable std::unordered_map<std::type_index, std::unordered_map<std::string, AbstractStorer *>> m_storerIndex;      ///< Storers by resource type and file extension (null if there is none)
+    mutable std::mutex                                                                             m_componentMutex;   ///< Mutex for accessing loaders, storers and the index
+    mutable bool                                                                                   m_indexed;          ///< 'true' if loaders and storers have been indexed
+    mutable unsigned int                                                                           m_indexedRevision;  ///< Component revision at the time of indexing
+    std::unique_ptr<ThreadPool>                                                                    m_ioThreadPool;     ///< Worker threads that read files of background loads (separate from the pool of the environment)
 };
 
 
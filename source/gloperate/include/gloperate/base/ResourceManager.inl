@@ -2,11 +2,15 @@
 #pragma once
 
 
-#include <cppfs/FilePath.h>
+#include <typeinfo>
+
+#include <cppassist/logging/logging.h>
 
 #include <gloperate/base/Loader.h>
+#include <gloperate/base/ResourceCache.h>
 #include <gloperate/base/Storer.h>
-
+#include <gloperate/base/ThreadPool.h>
+#include <gloperate/base/UploadQueue.h>
 
 
 namespace gloperate
@@ -16,63 +20,142 @@ namespace gloperate
 template <typename T>
 T * ResourceManager::load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
 {
-    // Lazy initialization of loaders
-    if (m_loaders.size() == 0) {
-        updateComponents();
+    // Find suitable loader
+    if (Loader<T> * loader = findLoader<T>(filename)) {
+        // Use loader
+        return loader->load(filename, options, progress);
     }
 
-    // Get file extension
-    std::string ext = cppfs::FilePath(filename).extension();
-    auto pos = ext.find_last_of('.');
-    if (pos != std::string::npos)
-    {
-        ext = ext.substr(pos + 1);
-    }
+    // No suitable loader found
+    return nullptr;
+}
 
-    // Find suitable loader
-    for (const auto & loader : m_loaders) {
-        // Check loader type
-        Loader<T> * concreteLoader = dynamic_cast<Loader<T> *>(loader.get());
-        if (concreteLoader) {
-            // Check if filetype is supported
-            if (concreteLoader->canLoad(ext)) {
-                // Use loader
-                return concreteLoader->load(filename, options, progress);
-            }
+template <typename T>
+std::shared_ptr<T> ResourceManager::get(const std::string & filename, const cppexpose::Variant & options)
+{
+    // Look up cache of the current context
+    ResourceCache * cache = ResourceCache::current();
+    if (cache) {
+        if (auto cached = cache->find(filename, options, typeid(T))) {
+            return std::static_pointer_cast<T>(cached);
         }
     }
 
-    // No suitable loader found
-    return nullptr;
+    // Load resource
+    std::shared_ptr<T> resource(load<T>(filename, options));
+    if (!resource || !cache) {
+        return resource;
+    }
+
+    // Add resource to cache
+    return std::static_pointer_cast<T>(cache->add(filename, options, typeid(T), resource));
 }
 
 template <typename T>
-bool ResourceManager::store(const std::string & filename, T * resource, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+std::future<std::shared_ptr<T>> ResourceManager::loadAsync(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress)
 {
-    // Lazy initialization of storers
-    if (m_storers.size() == 0) {
-        updateComponents();
+    auto promise = std::make_shared<std::promise<std::shared_ptr<T>>>();
+    auto future  = promise->get_future();
+
+    // Look up cache of the current context
+    if (ResourceCache * cache = ResourceCache::current()) {
+        if (auto cached = cache->find(filename, options, typeid(T))) {
+            promise->set_value(std::static_pointer_cast<T>(cached));
+            return future;
+        }
+    }
+
+    // Resources are created in the context of the canvas that renders on this thread
+    UploadQueue * queue = UploadQueue::current();
+    if (!queue) {
+        cppassist::warning() << "No upload queue bound, cannot load " << filename << " in the background";
+        promise->set_value(nullptr);
+        return future;
     }
 
-    // Get file extension
-    std::string ext = cppfs::FilePath(filename).extension();
+    // Find suitable loader here, as loaders are created lazily
+    Loader<T> * loader = findLoader<T>(filename);
+    if (!loader) {
+        // No suitable loader found
+        promise->set_value(nullptr);
+        return future;
+    }
 
-    // Find suitable storer
-    for (const auto & storer : m_storers) {
-        // Check storer type
-        Storer<T> * concreteStorer = dynamic_cast<Storer<T> *>(storer.get());
-        if (concreteStorer) {
-            // Check if filetype is supported
-            if (concreteStorer->canStore(ext)) {
-                // Use store
-                return concreteStorer->store(filename, resource, options, progress);
-            }
+    // The canvas may be destroyed while the file is read
+    std::weak_ptr<UploadQueue> weakQueue = queue->shared_from_this();
+
+    // Read file on a worker thread
+    m_ioThreadPool->submit([loader, filename, options, progress, promise, weakQueue] ()
+    {
+        std::function<bool (T * &)> create;
+
+        try {
+            create = loader->read(filename, options, progress);
+        } catch (...) {
+            cppassist::warning() << "Could not read " << filename;
+        }
+
+        const auto queue = weakQueue.lock();
+        if (!create || !queue) {
+            promise->set_value(nullptr);
+            return;
         }
+
+        // Create OpenGL objects on the context thread, large resources over several frames
+        queue->pushSteps([create, filename, options, promise] ()
+        {
+            T * created = nullptr;
+
+            try {
+                if (!create(created)) {
+                    return false;
+                }
+            } catch (...) {
+                cppassist::warning() << "Could not create " << filename;
+            }
+
+            std::shared_ptr<T> resource(created);
+
+            // Add resource to the cache of the context, which is bound while the canvas processes its queue
+            ResourceCache * cache = ResourceCache::current();
+            if (resource && cache) {
+                resource = std::static_pointer_cast<T>(cache->add(filename, options, typeid(T), resource));
+            }
+
+            promise->set_value(resource);
+
+            return true;
+        });
+    });
+
+    return future;
+}
+
+template <typename T>
+bool ResourceManager::store(const std::string & filename, T * resource, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+{
+    // Find suitable storer
+    if (Storer<T> * storer = findStorer<T>(filename)) {
+        // Use storer
+        return storer->store(filename, resource, options, progress);
     }
 
-    // No suitable loader found
+    // No suitable storer found
     return false;
 }
 
+template <typename T>
+Loader<T> * ResourceManager::findLoader(const std::string & filename) const
+{
+    // Loaders are indexed by the type of their resources
+    return static_cast<Loader<T> *>(findLoader(filename, typeid(T)));
+}
+
+template <typename T>
+Storer<T> * ResourceManager::findStorer(const std::string & filename) const
+{
+    // Storers are indexed by the type of their resources
+    return static_cast<Storer<T> *>(findStorer(filename, typeid(T)));
+}
 
 } // namespace gloperate
@@ -40,6 +40,9 @@ public:
     */
     virtual ~Storer();
 
+    // Virtual AbstractStorer functions
+    virtual std::type_index resourceType() const override;
+
     /**
     *  @brief
     *    Store resource to file
@@ -2,6 +2,9 @@
 #pragma once
 
 
+#include <typeinfo>
+
+
 namespace gloperate
 {
 
@@ -17,5 +20,11 @@ Storer<T>::~Storer()
 {
 }
 
+template <typename T>
+std::type_index Storer<T>::resourceType() const
+{
+    return typeid(T);
+}
+
 
 } // namespace gloperate
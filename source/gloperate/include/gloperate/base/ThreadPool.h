@@ -0,0 +1,136 @@
+
+#pragma once
+
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Work-stealing thread pool
+*
+*    Each worker thread owns a task queue. New tasks are distributed
+*    round-robin over the queues; a worker takes tasks from the back of
+*    its own queue and, when it runs dry, steals from the front of the
+*    queues of the other workers.
+*
+*    The worker threads are created lazily on the first submitted task,
+*    so an unused pool does not occupy any threads.
+*/
+class GLOPERATE_API ThreadPool
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] numThreads
+    *    Number of worker threads (0 to use one less than the number of hardware threads)
+    */
+    ThreadPool(unsigned int numThreads = 0);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Waits until all submitted tasks have been executed.
+    */
+    ~ThreadPool();
+
+    // No copying
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    /**
+    *  @brief
+    *    Get number of worker threads
+    *
+    *  @return
+    *    Number of worker threads
+    */
+    unsigned int numThreads() const;
+
+    /**
+    *  @brief
+    *    Submit task for asynchronous execution
+    *
+    *  @param[in] task
+    *    Task function
+    *
+    *  @return
+    *    Future that becomes ready when the task has been executed
+    */
+    std::future<void> submit(std::function<void()> task);
+
+
+protected:
+    /**
+    *  @brief
+    *    Task queue of a worker thread
+    */
+    struct TaskQueue
+    {
+        std::mutex                             mutex; ///< Mutex for accessing the queue
+        std::deque<std::packaged_task<void()>> tasks; ///< Pending tasks
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Create worker threads
+    */
+    void start();
+
+    /**
+    *  @brief
+    *    Main loop of a worker thread
+    *
+    *  @param[in] index
+    *    Index of the worker thread
+    */
+    void run(unsigned int index);
+
+    /**
+    *  @brief
+    *    Take next task for a worker thread
+    *
+    *  @param[in] index
+    *    Index of the worker thread
+    *  @param[out] task
+    *    Task
+    *
+    *  @return
+    *    'true' if a task has been taken from the own or another queue, else 'false'
+    */
+    bool takeTask(unsigned int index, std::packaged_task<void()> & task);
+
+
+protected:
+    unsigned int                            m_numThreads;   ///< Number of worker threads
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;       ///< Task queues (one per worker thread)
+    std::vector<std::thread>                m_threads;      ///< Worker threads
+    std::once_flag                          m_started;      ///< Flag for lazy creation of the worker threads
+    std::mutex                              m_mutex;        ///< Mutex for m_pendingTasks and m_running
+    std::condition_variable                 m_condition;    ///< Wakes up idle worker threads
+    std::size_t                             m_pendingTasks; ///< Number of tasks that have not been taken yet
+    std::size_t                             m_nextQueue;    ///< Queue that receives the next submitted task
+    bool                                    m_running;      ///< 'false' if the worker threads shall exit
+};
+
+
+} // namespace gloperate
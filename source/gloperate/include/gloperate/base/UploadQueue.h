@@ -0,0 +1,172 @@
+
+#pragma once
+
+
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <chrono>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Queue of resource creations for an OpenGL context
+*
+*    Background loads (see ResourceManager::loadAsync()) read files on
+*    worker threads and queue the creation of the OpenGL objects here.
+*    The canvas of the context runs them on its render thread, so the
+*    objects always belong to the context that requested them, also if
+*    the canvases of an environment do not share their contexts.
+*
+*    A queue is bound to the current thread together with its OpenGL
+*    context using ThreadBinding; without a binding, current() returns null.
+*    Workers keep a weak reference, so a queue may be destroyed while
+*    files are still being read.
+*
+*    Large resources are created in steps (see pushSteps()), so their
+*    uploads are spread over several frames within the time budget.
+*/
+class GLOPERATE_API UploadQueue : public std::enable_shared_from_this<UploadQueue>
+{
+public:
+    /**
+    *  @brief
+    *    Binding of a queue to the current thread
+    *
+    *    While a binding exists, UploadQueue::current() returns the bound
+    *    queue on this thread. The previous binding is restored on destruction.
+    */
+    class GLOPERATE_API ThreadBinding
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] queue
+        *    Queue of the OpenGL context that is current on this thread (can be null)
+        */
+        ThreadBinding(UploadQueue * queue);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~ThreadBinding();
+
+        // No copying
+        ThreadBinding(const ThreadBinding &) = delete;
+        ThreadBinding & operator=(const ThreadBinding &) = delete;
+
+
+    protected:
+        UploadQueue * m_previousQueue; ///< Previously bound queue
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Get queue bound to the current thread
+    *
+    *  @return
+    *    Queue, null if no queue is bound
+    */
+    static UploadQueue * current();
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    UploadQueue();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~UploadQueue();
+
+    // No copying
+    UploadQueue(const UploadQueue &) = delete;
+    UploadQueue & operator=(const UploadQueue &) = delete;
+
+    /**
+    *  @brief
+    *    Queue creation of a resource
+    *
+    *  @param[in] upload
+    *    Function that creates the resource
+    *
+    *  @remarks
+    *    Thread-safe.
+    */
+    void push(std::function<void()> upload);
+
+    /**
+    *  @brief
+    *    Queue creation of a resource in steps
+    *
+    *  @param[in] step
+    *    Function that performs the next step of the creation, returns 'true' after the last step
+    *
+    *  @remarks
+    *    Each step counts as a creation of its own for the time budget of process().
+    *    Unfinished creations stay at the front of the queue, so resources are
+    *    completed in the order they have been queued.
+    *    Thread-safe.
+    */
+    void pushSteps(std::function<bool()> step);
+
+    /**
+    *  @brief
+    *    Create queued resources
+    *
+    *  @param[in] budget
+    *    Time after which no further resources are created
+    *
+    *  @remarks
+    *    At least one resource is created (or one step performed) per call if one
+    *    is pending, the others are left for later calls once the budget is exhausted.
+    *    Must be called with the OpenGL context current.
+    */
+    void process(std::chrono::microseconds budget = std::chrono::microseconds(4000));
+
+    /**
+    *  @brief
+    *    Check if resources are waiting to be created
+    *
+    *  @return
+    *    'true' if process() has no work to do, else 'false'
+    *
+    *  @remarks
+    *    Thread-safe.
+    */
+    bool empty() const;
+
+    /**
+    *  @brief
+    *    Discard queued resource creations
+    *
+    *  @remarks
+    *    Called when the context is destroyed. The futures of discarded
+    *    loads are left without a value, their stages discard them as well.
+    */
+    void clear();
+
+
+protected:
+    mutable std::mutex                m_mutex;   ///< Mutex for accessing m_uploads
+    std::deque<std::function<bool()>> m_uploads; ///< Resource creations waiting for the context thread (return 'true' when finished)
+};
+
+
+} // namespace gloperate
@@ -0,0 +1,60 @@
+
+#pragma once
+
+
+#include <cppassist/logging/logging.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+/**
+*  @brief
+*    Highest debug level that is compiled into gloperate
+*
+*    Debug messages with a higher level are removed at compile time.
+*    Can be set by the CMake option OPTION_MAX_DEBUG_LEVEL.
+*/
+#ifndef GLOPERATE_MAX_DEBUG_LEVEL
+#define GLOPERATE_MAX_DEBUG_LEVEL 4
+#endif
+
+
+/**
+*  @brief
+*    Create debug message in the context "gloperate"
+*
+*    In contrast to cppassist::debug(), the message arguments are only
+*    evaluated if the message is actually logged, so a disabled message
+*    costs a single branch and no allocations. Use it like a stream:
+*
+*      GLOPERATE_DEBUG(2) << stage->qualifiedName() << ": processing";
+*
+*  @param[in] level
+*    Debug level (0 = most important)
+*/
+#define GLOPERATE_DEBUG(level) \
+    if (!((level) <= GLOPERATE_MAX_DEBUG_LEVEL && gloperate::isDebugLogged(level))) {} \
+    else cppassist::debug((level), "gloperate")
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Check if debug messages of a level are logged with the current verbosity
+*
+*  @param[in] level
+*    Debug level
+*
+*  @return
+*    'true' if messages of the level are logged, else 'false'
+*/
+inline bool isDebugLogged(unsigned int level)
+{
+    return cppassist::verbosityLevel() >= static_cast<int>(cppassist::LogMessage::Debug) + static_cast<int>(level);
+}
+
+
+} // namespace gloperate
@@ -2,17 +2,22 @@
 #pragma once
 
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <string>
 
 #include <cppexpose/plugin/plugin_api.h>
 
+#include <glbinding/gl/types.h>
+
 #include <gloperate/gloperate-version.h>
 #include <gloperate/base/Loader.h>
 
 
 namespace globjects
 {
+    class Buffer;
     class Texture;
 }
 
@@ -24,6 +29,22 @@ namespace gloperate
 /**
 *  @brief
 *    File loader for '.raw' files
+*
+*    The image data is streamed from the file into a pixel unpack buffer
+*    and uploaded in chunks, so the memory required does not depend on the
+*    size of the file. Background loads read the file on the I/O thread
+*    instead and upload one chunk per step of the upload queue, so large
+*    textures are uploaded over several frames.
+*
+*    Besides 2D textures, '.glraw' files may describe mipmap chains and
+*    3D or array textures using these properties:
+*      "levels" <int>: Number of mipmap levels, stored consecutively starting with the base level
+*      "depth"  <int>: Depth of a 3D texture
+*      "layers" <int>: Number of layers of a 2D array texture
+*      "size1", "size2", ... <int>: Size of the mipmap levels of compressed data
+*
+*  Supported options:
+*    none
 */
 class GLOPERATE_API GlrawTextureLoader : public gloperate::Loader<globjects::Texture>
 {
@@ -62,32 +83,148 @@ public:
 
     // Virtual gloperate::Loader<globjects::Texture> functions
     virtual globjects::Texture * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
+    virtual std::function<bool (globjects::Texture * &)> read(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
 
 
 protected:
     /**
     *  @brief
-    *    Create Texture from .glraw file
+    *    Description of the image data in a file
+    */
+    struct ImageDescription
+    {
+        gl::GLenum               target;           ///< Texture target (GL_TEXTURE_2D, GL_TEXTURE_3D or GL_TEXTURE_2D_ARRAY)
+        int                      width;            ///< Width of the base level
+        int                      height;           ///< Height of the base level
+        int                      depth;            ///< Depth of the base level or number of layers (1 for 2D textures)
+        gl::GLenum               format;           ///< Pixel format of uncompressed data
+        gl::GLenum               type;             ///< Pixel type of uncompressed data
+        gl::GLenum               compressedFormat; ///< Format of compressed data (GL_NONE if the data is uncompressed)
+        std::uint64_t            offset;           ///< Offset of the data in the file
+        std::vector<std::size_t> levelSizes;       ///< Size of the data of each mipmap level in bytes
+    };
+
+    /**
+    *  @brief
+    *    Part of the image data that is uploaded at once
+    */
+    struct Chunk
+    {
+        int         level;  ///< Mipmap level
+        int         y;      ///< First row
+        int         z;      ///< First slice or layer
+        int         rows;   ///< Number of rows
+        int         slices; ///< Number of slices or layers
+        std::size_t size;   ///< Size of the data in bytes
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Describe image data of a .glraw or .raw file
     *
     *  @param[in] filename
-    *    path of the .glraw file
+    *    path of the file
+    *  @param[out] image
+    *    Description of the image data
     *
     *  @return
-    *    Loaded texture, null on error
+    *    'true' if the file can be loaded, else 'false'
     */
-    globjects::Texture * loadGLRawImage(const std::string & filename) const;
+    bool describeImage(const std::string & filename, ImageDescription & image) const;
 
     /**
     *  @brief
-    *    Create Texture from .raw file
+    *    Describe image data of a .raw file
     *
     *  @param[in] filename
     *    path of the .raw file
+    *  @param[out] image
+    *    Description of the image data
+    *
+    *  @return
+    *    'true' if the file name describes the image data, else 'false'
+    */
+    bool describeRawImage(const std::string & filename, ImageDescription & image) const;
+
+    /**
+    *  @brief
+    *    Read header of a .glraw file
+    *
+    *  @param[in] filename
+    *    path of the .glraw file
+    *  @param[out] image
+    *    Description of the image data
+    *
+    *  @return
+    *    'true' if the header is valid, else 'false'
+    */
+    bool readGLRawHeader(const std::string & filename, ImageDescription & image) const;
+
+    /**
+    *  @brief
+    *    Split image data into chunks
+    *
+    *  @param[in] image
+    *    Description of the image data
+    *
+    *  @return
+    *    Chunks in the order of the data in the file
+    *
+    *  @remarks
+    *    Uncompressed levels are split into whole slices, or rows of a slice if a
+    *    slice exceeds the chunk size. Compressed levels are uploaded at once.
+    */
+    std::vector<Chunk> splitImage(const ImageDescription & image) const;
+
+    /**
+    *  @brief
+    *    Create texture and allocate its uncompressed levels
+    *
+    *  @param[in] image
+    *    Description of the image data
+    *
+    *  @return
+    *    Texture
+    */
+    globjects::Texture * allocateTexture(const ImageDescription & image) const;
+
+    /**
+    *  @brief
+    *    Upload chunk of image data into a texture
+    *
+    *  @param[in] texture
+    *    Texture created by allocateTexture() (must NOT be null!)
+    *  @param[in] image
+    *    Description of the image data
+    *  @param[in] chunk
+    *    Chunk to upload
+    *  @param[in] unpackBuffer
+    *    Pixel unpack buffer with room for the chunk
+    *  @param[in] fill
+    *    Function that writes the data of the chunk into the mapped buffer, returns 'false' on error
+    *
+    *  @return
+    *    'true' if the chunk has been uploaded, else 'false'
+    */
+    bool uploadChunk(globjects::Texture * texture, const ImageDescription & image, const Chunk & chunk, globjects::Buffer & unpackBuffer, const std::function<bool (char *)> & fill) const;
+
+    /**
+    *  @brief
+    *    Create texture and stream image data from a file into it
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] image
+    *    Description of the image data
+    *  @param[in] progress
+    *    Callback function that is invoked with the number of KiB uploaded and in total (can be empty)
     *
     *  @return
-    *    Loaded texture, null on error
+    *    Texture, null if the file could not be read
     */
-    globjects::Texture * loadRawImage(const std::string & filename) const;
+    globjects::Texture * createTexture(const std::string & filename, const ImageDescription & image, std::function<void(int, int)> progress) const;
 
 
 protected:
@@ -2,6 +2,12 @@
 #pragma once
 
 
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+
 #include <cppexpose/reflection/AbstractProperty.h>
 
 #include <gloperate/gloperate_api.h>
@@ -42,6 +48,153 @@ enum class SlotType
 */
 class GLOPERATE_API AbstractSlot : public cppexpose::AbstractProperty
 {
+public:
+    /**
+    *  @brief
+    *    Wave of invalidations that is propagated through the pipeline
+    *
+    *    The outermost wave on a thread draws a new token from a global counter,
+    *    while nested waves (started by invalidations the propagation triggers)
+    *    share the token of the outermost one. Inputs remember the token of the
+    *    last wave that reached them and propagate each wave only once, which
+    *    also stops cyclic propagation without locks or allocations.
+    */
+    class GLOPERATE_API InvalidationWave
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @remarks
+        *    Starts a new wave, if no wave is propagated on the current thread
+        */
+        InvalidationWave();
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~InvalidationWave();
+
+        // No copying
+        InvalidationWave(const InvalidationWave &) = delete;
+        InvalidationWave & operator=(const InvalidationWave &) = delete;
+
+        /**
+        *  @brief
+        *    Get token of the wave
+        *
+        *  @return
+        *    Token that is unique for each outermost wave (never 0)
+        */
+        std::uint64_t token() const;
+
+
+    protected:
+        std::uint64_t m_token; ///< Token of the wave
+    };
+
+    /**
+    *  @brief
+    *    Scope in which notifications of outputs are deferred on the current thread
+    *
+    *    Stages that are processed on a worker thread must not reach signal
+    *    handlers and connected stages, which assume the thread that processes
+    *    the pipeline. While a scope exists, outputs that are changed or
+    *    invalidated on its thread update their own state only and queue their
+    *    notifications, which the processing thread emits later with flush().
+    */
+    class GLOPERATE_API DeferredNotifications
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] notifications
+        *    List the notifications of the current thread are appended to (must NOT be null!)
+        */
+        DeferredNotifications(std::vector<std::function<void()>> * notifications);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~DeferredNotifications();
+
+        // No copying
+        DeferredNotifications(const DeferredNotifications &) = delete;
+        DeferredNotifications & operator=(const DeferredNotifications &) = delete;
+
+        /**
+        *  @brief
+        *    Emit and remove queued notifications
+        *
+        *  @param[in] notifications
+        *    List of queued notifications
+        *
+        *  @remarks
+        *    Must be called on the thread that processes the pipeline.
+        */
+        static void flush(std::vector<std::function<void()>> & notifications);
+
+
+    protected:
+        std::vector<std::function<void()>> * m_previousNotifications; ///< Previously active list of notifications
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Lock propagation of changes between slots
+    *
+    *  @return
+    *    Lock on the propagation mutex, which only owns the mutex while stages are processed concurrently
+    *
+    *  @remarks
+    *    Setting or invalidating a slot value synchronously propagates the change
+    *    to all connected slots and stages. While stages are processed on several
+    *    threads (see Pipeline), these propagations are serialized, because slots
+    *    downstream may be reached from more than one thread.
+    */
+    static std::unique_lock<std::recursive_mutex> lockPropagation();
+
+    /**
+    *  @brief
+    *    Announce that a stage is about to be processed concurrently
+    *
+    *  @remarks
+    *    Must be called on the thread that processes the pipeline before the stage is
+    *    dispatched, and matched by a call to endConcurrentProcessing() when the stage
+    *    has finished, also if it has thrown an exception.
+    */
+    static void beginConcurrentProcessing();
+
+    /**
+    *  @brief
+    *    Announce that a concurrently processed stage has finished
+    *
+    *  @see beginConcurrentProcessing()
+    */
+    static void endConcurrentProcessing();
+
+    /**
+    *  @brief
+    *    Queue notification, if notifications are deferred on the current thread
+    *
+    *  @param[in] notification
+    *    Function that emits the notification
+    *
+    *  @return
+    *    'true' if the notification has been queued, 'false' if it has to be emitted immediately
+    *
+    *  @see DeferredNotifications
+    */
+    static bool deferNotification(std::function<void()> && notification);
+
+
 public:
     /**
     *  @brief
@@ -79,8 +232,22 @@ public:
     *
     *  @return
     *    Name with all parent names, separated by '.'
+    *
+    *  @remarks
+    *    The name is built when the slot is added to its stage, or when the stage
+    *    is added to a pipeline, so reading it never allocates.
+    *    It can be read from any thread.
+    */
+    const std::string & qualifiedName() const;
+
+    /**
+    *  @brief
+    *    Rebuild qualified name from the names of the slot and its parents
+    *
+    *  @remarks
+    *    Called by the parent stage whenever its qualified name has changed.
     */
-    std::string qualifiedName() const;
+    void updateQualifiedName();
 
     /**
     *  @brief
@@ -298,10 +465,11 @@ protected:
 
 
 protected:
-    SlotType m_slotType; ///< Type or role of the slot (input or output)
-    bool     m_dynamic;  ///< 'true' if slot has been added dynamically, else 'false'
-    bool     m_required; ///< Is the data required?
-    bool     m_feedback; ///< Does the slot contain a feedback connection?
+    SlotType            m_slotType;      ///< Type or role of the slot (input or output)
+    bool                m_dynamic;       ///< 'true' if slot has been added dynamically, else 'false'
+    bool                m_required;      ///< Is the data required?
+    bool                m_feedback;      ///< Does the slot contain a feedback connection?
+    std::string         m_qualifiedName; ///< Qualified name (see updateQualifiedName())
 };
 
 
@@ -2,9 +2,8 @@
 #pragma once
 
 
-#include <map>
-#include <thread>
-#include <mutex>
+#include <cstdint>
+#include <atomic>
 
 #include <gloperate/gloperate_api.h>
 #include <gloperate/pipeline/Slot.h>
@@ -95,8 +94,7 @@ protected:
 
 protected:
     // Data
-    std::map<std::thread::id, bool> m_cycleGuard; ///< Protection against cyclic propagation of change-events (one per thread to be thread-safe)
-    std::recursive_mutex            m_cycleMutex; ///< Mutex for accessing the cycle guard map
+    std::atomic<std::uint64_t> m_invalidationToken; ///< Token of the last invalidation wave that reached the input (protection against cyclic propagation)
 };
 
 
@@ -2,7 +2,7 @@
 #pragma once
 
 
-#include <cppassist/logging/logging.h>
+#include <gloperate/base/logging.h>
 
 
 namespace gloperate
@@ -12,12 +12,14 @@ namespace gloperate
 template <typename T>
 Input<T>::Input(const std::string & name, Stage * parent, const T & value)
 : Slot<T>(SlotType::Input, name, parent, value)
+, m_invalidationToken(0)
 {
 }
 
 template <typename T>
 Input<T>::Input(const std::string & name, const T & value)
 : Slot<T>(SlotType::Input, name, value)
+, m_invalidationToken(0)
 {
 }
 
@@ -29,33 +31,18 @@ Input<T>::~Input()
 template <typename T>
 void Input<T>::onValueInvalidated()
 {
-    cppassist::debug(3, "gloperate") << this->qualifiedName() << ": input invalidated";
+    GLOPERATE_DEBUG(3) << this->qualifiedName() << ": input invalidated";
 
-    std::lock_guard<std::recursive_mutex> lock(this->m_cycleMutex);
+    // Propagate each wave only once; reaching the input again means a cyclic
+    // dependency or another path through the pipeline that has already been handled
+    const AbstractSlot::InvalidationWave wave;
 
-    // Get current thread ID
-    std::thread::id this_id = std::this_thread::get_id();
-
-    // Initialize guard for the current thread
-    if (this->m_cycleGuard.find(this_id) == this->m_cycleGuard.end())
-    {
-        this->m_cycleGuard[this_id] = false;
-    }
-
-    // Check if this slot has already been invoked in the current recursion
-    if (this->m_cycleGuard[this_id])
+    if (this->m_invalidationToken.exchange(wave.token(), std::memory_order_relaxed) == wave.token())
     {
-        // Reset guard
-        this->m_cycleGuard[this_id] = false;
-
-        // Stop recursion here to avoid endless recursion
-        cppassist::debug(4, "gloperate") << this->qualifiedName() << ": detected cyclic dependency";
+        GLOPERATE_DEBUG(4) << this->qualifiedName() << ": detected cyclic dependency";
         return;
     }
 
-    // Raise guard
-    this->m_cycleGuard[this_id] = true;
-
     // Emit signal
     this->valueInvalidated();
 
@@ -66,15 +53,12 @@ void Input<T>::onValueInvalidated()
     {
         stage->inputValueInvalidated(this);
     }
-
-    // Reset guard
-    this->m_cycleGuard[this_id] = false;
 }
 
 template <typename T>
 void Input<T>::onValueChanged(const T & value)
 {
-    cppassist::debug(3, "gloperate") << this->qualifiedName() << ": input changed value";
+    GLOPERATE_DEBUG(3) << this->qualifiedName() << ": input changed value";
 
     this->setChanged(true);
 
@@ -2,6 +2,9 @@
 #pragma once
 
 
+#include <gloperate/base/logging.h>
+
+
 namespace gloperate
 {
 
@@ -30,6 +33,12 @@ Output<T>::~Output()
 template <typename T>
 void Output<T>::onRequiredChanged()
 {
+    // Stage may need to produce this output now
+    if (Stage * stage = this->parentStage())
+    {
+        stage->markDirty();
+    }
+
     if (this->isConnected())
     {
         // Promote required-flag to source slot
@@ -48,7 +57,19 @@ void Output<T>::onRequiredChanged()
 template <typename T>
 void Output<T>::onValueInvalidated()
 {
-    cppassist::debug(3, "gloperate") << this->qualifiedName() << ": output invalidated";
+    GLOPERATE_DEBUG(3) << this->qualifiedName() << ": output invalidated";
+
+    // Stage has to produce this output again
+    if (Stage * stage = this->parentStage())
+    {
+        stage->markDirty();
+    }
+
+    // Notify connected slots on the processing thread, if the stage is processed on a worker
+    if (AbstractSlot::deferNotification([this] () { this->valueInvalidated(); }))
+    {
+        return;
+    }
 
     // Emit signal
     this->valueInvalidated();
@@ -58,8 +79,14 @@ void Output<T>::onValueInvalidated()
 template <typename T>
 void Output<T>::onValueChanged(const T & value)
 {
-    cppassist::debug(3, "gloperate") << this->qualifiedName() << ": output changed value";
-    
+    GLOPERATE_DEBUG(3) << this->qualifiedName() << ": output changed value";
+
+    // Notify connected slots on the processing thread, if the stage is processed on a worker
+    if (AbstractSlot::deferNotification([this] () { this->valueChanged(*this->ptr()); }))
+    {
+        return;
+    }
+
     // Emit signal
     this->valueChanged(value);
 }
@@ -5,6 +5,9 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <future>
+#include <functional>
+#include <memory>
 
 #include <gloperate/pipeline/Stage.h>
 
@@ -13,6 +16,9 @@ namespace gloperate
 {
 
 
+class RenderTargetPool;
+
+
 /**
 *  @brief
 *    Pipeline
@@ -33,6 +39,16 @@ namespace gloperate
 *      invalidated, so any change of input data will propagate through the
 *      pipeline immediately and invalidate all outputs that, directly or
 *      indirectly, depend on that input.
+*
+*    Stages that do not require an OpenGL context (see Stage::requiresContext())
+*    are processed on the thread pool of the environment as soon as the stages
+*    they depend on have finished, while all other stages are processed in order
+*    on the calling thread.
+*
+*    When many inputs are changed at once, the changes can be grouped into an
+*    update (see beginUpdate() and UpdateScope). During an update, stages only
+*    remember that their outputs have to be invalidated, and the invalidations
+*    are propagated once in topological order when the update ends.
 */
 class GLOPERATE_API Pipeline : public Stage
 {
@@ -40,6 +56,41 @@ class GLOPERATE_API Pipeline : public Stage
     friend class Canvas;
 
 
+public:
+    /**
+    *  @brief
+    *    Update of a pipeline that lasts for the lifetime of the scope
+    *
+    *  @see beginUpdate()
+    */
+    class GLOPERATE_API UpdateScope
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] pipeline
+        *    Pipeline that is updated (can be null)
+        */
+        UpdateScope(Pipeline * pipeline);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~UpdateScope();
+
+        // No copying
+        UpdateScope(const UpdateScope &) = delete;
+        UpdateScope & operator=(const UpdateScope &) = delete;
+
+
+    protected:
+        Pipeline * m_pipeline; ///< Pipeline that is updated (can be null)
+    };
+
+
 public:
     cppexpose::Signal<Stage *> stageAdded;   ///< Called when a new stage has been added
     cppexpose::Signal<Stage *> stageRemoved; ///< Called when a stage has been removed
@@ -127,17 +178,171 @@ public:
     */
     void invalidateStageOrder();
 
+    /**
+    *  @brief
+    *    Update sorted stage order after the connections of a stage have changed
+    *
+    *  @param[in] stage
+    *    Stage whose input connections have changed (must NOT be null!)
+    *
+    *  @remarks
+    *    Removing a connection never violates a topological order and new
+    *    connections only do so if they lead to a stage that is executed
+    *    later than the given stage. Therefore, the stages are only resorted
+    *    if one of the inputs of the given stage is connected to a stage
+    *    that is not executed before it.
+    */
+    void updateStageOrder(Stage * stage);
+
+    /**
+    *  @brief
+    *    Begin update
+    *
+    *  @remarks
+    *    Until the matching call to endUpdate(), stages of the pipeline (and of
+    *    nested pipelines) defer the invalidation of their outputs. Updates can
+    *    be nested, the invalidations are propagated when the outermost update ends.
+    *    The pipeline must not be processed during an update.
+    */
+    void beginUpdate();
+
+    /**
+    *  @brief
+    *    End update
+    *
+    *  @remarks
+    *    If this ends the outermost update, the deferred invalidations of all
+    *    stages are propagated once, in the order of execution.
+    *
+    *  @see beginUpdate()
+    */
+    void endUpdate();
+
+    /**
+    *  @brief
+    *    Check if the pipeline or one of its parent pipelines is being updated
+    *
+    *  @return
+    *    'true' if invalidations within the pipeline are deferred, else 'false'
+    */
+    bool isUpdating() const;
+
+    /**
+    *  @brief
+    *    Get pool of transient render targets
+    *
+    *  @return
+    *    Pool that shares storage between transient render targets of the stages of this pipeline (never null)
+    */
+    RenderTargetPool * renderTargetPool() const;
+
     // Virtual Stage interface
     virtual bool isPipeline() const override;
+    virtual void pollTimeMeasurements() override;
 
 
 protected:
     /**
     *  @brief
     *    Sort stages by their dependencies
+    *
+    *  @remarks
+    *    Uses Kahn's algorithm on the direct dependencies of the stages,
+    *    which runs in linear time of the number of stages and connections.
+    *    The relative order of independent stages is preserved.
     */
     void sortStages();
 
+    /**
+    *  @brief
+    *    Rebuild execution plan from the sorted stage list
+    *
+    *  @remarks
+    *    Updates the indices and direct dependencies of all stages
+    *    and determines which stages can be processed concurrently.
+    */
+    void updateExecutionPlan();
+
+    /**
+    *  @brief
+    *    Update direct dependencies of a stage in the execution plan
+    *
+    *  @param[in] index
+    *    Index of the stage in m_stages
+    */
+    void updateStageDependencies(std::size_t index);
+
+    /**
+    *  @brief
+    *    Wait until a concurrently processed stage has finished
+    *
+    *  @param[in] index
+    *    Index of the stage in m_stages
+    *
+    *  @remarks
+    *    Does nothing if the stage is not being processed on a worker thread.
+    *    Notifications of outputs that have been deferred by the stage are
+    *    emitted, then an exception thrown by the stage is rethrown.
+    */
+    void finishStage(std::size_t index);
+
+    /**
+    *  @brief
+    *    Wait until all concurrently processed stages have finished
+    *
+    *  @param[in] rethrow
+    *    If 'true', the first exception thrown by a stage is rethrown after all stages have finished, else it is discarded
+    */
+    void finishStages(bool rethrow);
+
+    /**
+    *  @brief
+    *    Get stage of this pipeline that directly provides data to an input
+    *
+    *  @param[in] input
+    *    Input slot of a stage in this pipeline (must NOT be null!)
+    *
+    *  @return
+    *    Stage of this pipeline the input is connected to, null if the input is
+    *    not connected, a feedback connection or connected to a slot outside
+    *    of this pipeline
+    */
+    Stage * sourceStage(const AbstractSlot * input) const;
+
+    /**
+    *  @brief
+    *    Determine lifetimes of transient render targets from the stage order
+    *
+    *  @remarks
+    *    The lifetime of a client of the render target pool ranges from the
+    *    first to the last stage that reads one of its outputs, either directly
+    *    or through render targets, textures or renderbuffers passed on by other
+    *    stages. It does not start at the client itself, as clients only provide
+    *    the storage and are sorted before the stages that draw into it. Outputs that are read through feedback connections or are
+    *    outputs of the pipeline live for the whole frame. If any lifetime has
+    *    changed, the storage is reassigned and the clients are processed again.
+    */
+    void updateRenderTargetLifetimes();
+
+    /**
+    *  @brief
+    *    Schedule stages that draw into shared render target storage before it is read
+    *
+    *  @remarks
+    *    Clean stages are not processed, but other clients of the render target
+    *    pool overwrite shared storage whenever they are processed. If a stage that
+    *    reads shared storage may be processed in this frame, e.g., because one of
+    *    its parameters has changed, the stages that draw into the storage before
+    *    it are invalidated, so the reader never sees contents of another client.
+    */
+    void scheduleRenderTargetWriters();
+
+    /**
+    *  @brief
+    *    Propagate deferred invalidations of all stages, including nested pipelines
+    */
+    void propagateDeferredInvalidations();
+
     /**
     *  @brief
     *    Common implementation of addStage(Stage *) and addStage(std::unique_ptr<Stage> &&)
@@ -153,9 +358,30 @@ protected:
 
 
 protected:
-    std::vector<Stage *>                     m_stages;    ///< List of topologically sorted stages in the pipeline
-    std::unordered_map<std::string, Stage *> m_stagesMap; ///< Map of names -> stages
-    bool                                     m_sorted;    ///< Have the stages of the pipeline already been sorted?
+    /**
+    *  @brief
+    *    Stages that use the render targets of a client of the render target pool
+    */
+    struct RenderTargetUsers
+    {
+        std::vector<std::size_t> readers; ///< Indices of the stages that read the render targets
+        std::vector<std::size_t> writers; ///< Indices of the readers that pass the render targets on, i.e., draw into them
+    };
+
+
+protected:
+    std::vector<Stage *>                                 m_stages;                ///< List of topologically sorted stages in the pipeline (execution plan)
+    std::unordered_map<std::string, Stage *>             m_stagesMap;             ///< Map of names -> stages
+    std::unordered_map<const Stage *, std::size_t>       m_stageIndices;          ///< Map of stages -> index in m_stages
+    std::vector<std::vector<std::size_t>>                m_stageDependencies;     ///< Indices of the stages each stage directly depends on
+    std::vector<bool>                                    m_concurrentStages;      ///< Flags for stages that may be processed on a worker thread
+    std::vector<std::future<void>>                       m_pendingStages;         ///< Stages that are currently processed on a worker thread
+    std::vector<std::vector<std::function<void()>>>      m_deferredNotifications; ///< Notifications of outputs deferred by stages processed on a worker thread
+    bool                                                 m_sorted;                ///< Have the stages of the pipeline already been sorted?
+    bool                                                 m_lifetimesValid;        ///< Have the lifetimes of transient render targets been determined for the current stage order?
+    std::unique_ptr<RenderTargetPool>                    m_renderTargetPool;      ///< Pool of transient render targets
+    std::unordered_map<const Stage *, RenderTargetUsers> m_renderTargetUsers;     ///< Stages that use the render targets of each client of the pool (determined with the lifetimes)
+    std::size_t                                          m_updateDepth;           ///< Number of nested updates (see beginUpdate())
 };
 
 
@@ -18,6 +18,12 @@ namespace gloperate
 *  @brief
 *    Data slot on a stage
 *
+*    A connected slot keeps a pointer to the slot at the start of its
+*    connection chain, which is updated whenever a slot along the chain
+*    is reconnected. Therefore, reading the value via operator*(),
+*    operator->() or ptr() neither walks the chain nor copies the value.
+*    Prefer these over value(), which returns a copy.
+*
 *  @see AbstractSlot
 */
 template <typename T>
@@ -153,6 +159,18 @@ public:
     virtual void setChanged(bool hasChanged) override;
     virtual void onRequiredChanged() override;
 
+    /**
+    *  @brief
+    *    Set value without copying it
+    *
+    *  @param[in] value
+    *    New value, which is moved into the slot
+    *
+    *  @remarks
+    *    As setValue(const T &), this has no effect if the slot is connected.
+    */
+    void setValue(T && value);
+
     // Virtual Typed<T> interface
     virtual T value() const override;
     virtual void setValue(const T & value) override;
@@ -175,6 +193,7 @@ protected:
     bool                        m_valid;      ///< Does the slot have a valid value?
     bool                        m_changed;    ///< Was the slot changed since the last time it's pipeline was processed
     Slot<T>                   * m_source;     ///< Connected slot (can be null)
+    Slot<T>                   * m_valueSlot;  ///< Slot at the start of the connection chain that holds the value (this slot, if not connected)
     cppexpose::ScopedConnection m_valueConnection; ///< Connection to changed-signal of source slot; removes the connection when destroyed
     cppexpose::ScopedConnection m_validConnection; ///< Connection to invalidated-signal of source slot; removes the connection when destroyed
 };
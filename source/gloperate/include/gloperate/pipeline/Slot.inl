@@ -2,10 +2,9 @@
 #pragma once
 
 
-#include <cppassist/logging/logging.h>
-
 #include <cppexpose/typed/Typed.h>
 
+#include <gloperate/base/logging.h>
 #include <gloperate/pipeline/Stage.h>
 #include <gloperate/pipeline/Slot.h>
 
@@ -41,6 +40,7 @@ Slot<T>::Slot(SlotType slotType, const std::string & name, Stage * parent, const
 : cppexpose::DirectValue<T, AbstractSlot>(value)
 , m_valid(true)
 , m_source(nullptr)
+, m_valueSlot(this)
 {
     // Do not add property to object, yet. Just initialize the property itself
     this->initProperty(name, nullptr);
@@ -54,6 +54,7 @@ Slot<T>::Slot(SlotType slotType, const std::string & name, const T & value)
 : cppexpose::DirectValue<T, AbstractSlot>(value)
 , m_valid(true)
 , m_source(nullptr)
+, m_valueSlot(this)
 {
     // Make as a dynamic slot
     this->m_dynamic = true;
@@ -75,7 +76,7 @@ bool Slot<T>::connect(Slot<T> * source)
 {
     assert(source != nullptr);
 
-    cppassist::debug(2, "gloperate") << this->qualifiedName() << ": connect slot " << source->qualifiedName();
+    GLOPERATE_DEBUG(2) << this->qualifiedName() << ": connect slot " << source->qualifiedName();
 
     // Check if source is valid
     if (!source) {
@@ -84,10 +85,14 @@ bool Slot<T>::connect(Slot<T> * source)
 
     // Set source
     m_source = source;
+    m_valueSlot = source->m_valueSlot;
 
     // Connect to data container; no direct binding of member function to achive virtual lookup
     m_valueConnection = m_source->valueChanged.connect([this] (const T & value)
     {
+        // The source emits this signal after it has been (re)connected itself
+        this->m_valueSlot = this->m_source->m_valueSlot;
+
         this->onValueChanged(value);
     } );
     m_validConnection = m_source->valueInvalidated.connect([this] ()
@@ -98,7 +103,7 @@ bool Slot<T>::connect(Slot<T> * source)
     // Emit events
     this->promoteConnection();
     this->promoteRequired();
-    this->onValueChanged(m_source->value());
+    this->onValueChanged(m_valueSlot->m_value);
 
     // Success
     return true;
@@ -148,7 +153,7 @@ bool Slot<T>::connect(AbstractSlot * source)
     // Check if source is valid and compatible data container
     if (!source || !isCompatible(source))
     {
-        cppassist::debug(2, "gloperate") << this->qualifiedName() << ": connect slot failed for " << source->qualifiedName();
+        GLOPERATE_DEBUG(2) << this->qualifiedName() << ": connect slot failed for " << source->qualifiedName();
         return false;
     }
 
@@ -161,10 +166,11 @@ void Slot<T>::disconnect()
 {
     // Reset source property
     m_source     = nullptr;
+    m_valueSlot  = this;
     m_valueConnection = cppexpose::ScopedConnection();
     m_validConnection = cppexpose::ScopedConnection();
 
-    cppassist::debug(2, "gloperate") << this->qualifiedName() << ": disconnect slot";
+    GLOPERATE_DEBUG(2) << this->qualifiedName() << ": disconnect slot";
 
     // Emit events
     this->promoteConnection();
@@ -180,24 +186,23 @@ const AbstractSlot * Slot<T>::source() const
 template <typename T>
 bool Slot<T>::isValid() const
 {
-    // If connected, return validity of source slot
-    if (m_source)
-    {
-        return m_source->isValid();
-    }
-
-    // Return validity of own data
-    return m_valid;
+    // If connected, return validity of the slot at the start of the connection chain
+    return m_valueSlot->m_valid;
 }
 
 template <typename T>
 void Slot<T>::invalidate()
 {
+    auto lock = AbstractSlot::lockPropagation();
+
     if (!m_valid)
     {
         return;
     }
 
+    // All invalidations caused by this one belong to the same wave
+    const AbstractSlot::InvalidationWave wave;
+
     // If connected, abort function
     if (!m_source)
     {
@@ -229,14 +234,8 @@ void Slot<T>::onRequiredChanged()
 template <typename T>
 T Slot<T>::value() const
 {
-    // If connected, return value of source slot
-    if (m_source)
-    {
-        return m_source->value();
-    }
-
-    // Return own data
-    return this->m_value;
+    // If connected, return value of the slot at the start of the connection chain
+    return m_valueSlot->m_value;
 }
 
 template <typename T>
@@ -248,6 +247,8 @@ void Slot<T>::setValue(const T & value)
         return;
     }
 
+    auto lock = AbstractSlot::lockPropagation();
+
     // Set own data
     this->m_value = value;
     this->m_valid = true;
@@ -257,29 +258,36 @@ void Slot<T>::setValue(const T & value)
 }
 
 template <typename T>
-const T * Slot<T>::ptr() const
+void Slot<T>::setValue(T && value)
 {
-    // If connected, return value of source slot
+    // If connected, abort function
     if (m_source)
     {
-        return m_source->ptr();
+        return;
     }
 
-    // Return own data
-    return &this->m_value;
+    auto lock = AbstractSlot::lockPropagation();
+
+    // Take over own data
+    this->m_value = std::move(value);
+    this->m_valid = true;
+
+    // Emit signal
+    this->onValueChanged(this->m_value);
 }
 
 template <typename T>
-T * Slot<T>::ptr()
+const T * Slot<T>::ptr() const
 {
-    // If connected, return value of source slot
-    if (m_source)
-    {
-        return m_source->ptr();
-    }
+    // If connected, return value of the slot at the start of the connection chain
+    return &m_valueSlot->m_value;
+}
 
-    // Return own data
-    return &this->m_value;
+template <typename T>
+T * Slot<T>::ptr()
+{
+    // If connected, return value of the slot at the start of the connection chain
+    return &m_valueSlot->m_value;
 }
 
 template <typename T>
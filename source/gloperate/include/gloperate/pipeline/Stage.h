@@ -2,6 +2,8 @@
 #pragma once
 
 
+#include <array>
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -42,6 +44,7 @@ class Output;
 class GLOPERATE_API Stage : public cppexpose::Object
 {
     friend class Canvas;
+    friend class Pipeline;
 
 
 public:
@@ -88,7 +91,7 @@ public:
     cppexpose::Signal<AbstractSlot *>     outputAdded;   ///< Called when an output slot has been added
     cppexpose::Signal<AbstractSlot *>     outputRemoved; ///< Called when an output slot has been removed
     cppexpose::Signal<AbstractSlot *>     inputChanged;  ///< Called when an input slot has changed its value or options
-    cppexpose::Signal<uint64_t, uint64_t> timeMeasured;  ///< Called when the timing has been measured
+    cppexpose::Signal<uint64_t, uint64_t> timeMeasured;  ///< Called when the timing of an earlier process() call is available (CPU, GPU)
 
 
 public:
@@ -124,6 +127,22 @@ public:
     */
     virtual bool isPipeline() const;
 
+    /**
+    *  @brief
+    *    Check if stage needs an OpenGL context for processing
+    *
+    *  @return
+    *    'true' if the stage issues OpenGL calls in onProcess(), else 'false'
+    *
+    *  @remarks
+    *    Stages that do not need a context may be processed on a worker
+    *    thread of the environment, concurrently to other stages of the
+    *    parent pipeline. Such stages must only access their own inputs,
+    *    outputs, and members in onProcess(). By default, a context is
+    *    assumed to be required.
+    */
+    virtual bool requiresContext() const;
+
     /**
     *  @brief
     *    Get gloperate environment
@@ -203,6 +222,18 @@ public:
     */
     bool needsProcessing() const;
 
+    /**
+    *  @brief
+    *    Mark stage as possibly needing processing
+    *
+    *  @remarks
+    *    This is called whenever an output of the stage has been invalidated
+    *    or has changed its required-state. The parent pipeline skips stages
+    *    that have not been marked since their last check without calling
+    *    needsProcessing() on them.
+    */
+    void markDirty();
+
     /**
     *  @brief
     *    Update the required-state of the stage's input slots
@@ -291,6 +322,10 @@ public:
     /**
     *  @brief
     *    Invalidate all outputs
+    *
+    *  @remarks
+    *    While a parent pipeline is being updated (see Pipeline::beginUpdate()),
+    *    the invalidation is deferred until the update ends.
     */
     void invalidateOutputs();
 
@@ -598,8 +633,13 @@ public:
     *
     *  @return
     *    Name with all parent names, separated by '.'
+    *
+    *  @remarks
+    *    The name is built when the stage is created or added to a pipeline,
+    *    so reading it never allocates. It can be read from any thread,
+    *    including worker threads that process stages concurrently.
     */
-    std::string qualifiedName() const;
+    const std::string & qualifiedName() const;
 
     /**
     *  @brief
@@ -661,7 +701,8 @@ public:
     *    duration in nanoseconds
     *
     *  @remarks
-    *    To be consistent with 'lastGPUTime', this value is one iteration (i.e. frame) late.
+    *    To be consistent with 'lastGPUTime', this value is reported together
+    *    with the GPU time and is therefore usually a few iterations (i.e. frames) late.
     */
     std::uint64_t lastCPUTime() const;
 
@@ -673,7 +714,9 @@ public:
     *    duration in nanoseconds
     *
     *  @remarks
-    *    Due to the async nature of GPU processing, this value is one iteration (i.e. frame) late.
+    *    Due to the async nature of GPU processing, this value is usually a few
+    *    iterations (i.e. frames) late. The timer queries are only evaluated
+    *    once their results are available, so measuring never stalls the CPU.
     */
     std::uint64_t lastGPUTime() const;
 
@@ -700,6 +743,18 @@ public:
     */
     virtual void setTimeMeasurement(bool enabled, bool recursive = false);
 
+    /**
+    *  @brief
+    *    Collect results of earlier time measurements that have become available
+    *
+    *  @remarks
+    *    Called once per frame by the canvas on its render stage, so results
+    *    are also reported for stages that have not been processed in a frame.
+    *    Pipelines collect the results of all their stages. Never waits for
+    *    the GPU. Must be called with the OpenGL context current.
+    */
+    virtual void pollTimeMeasurements();
+
 
 protected:
     /**
@@ -826,18 +881,55 @@ protected:
     */
     void registerOutput(AbstractSlot * output);
 
+    /**
+    *  @brief
+    *    Rebuild qualified names of the stage, its slots and its substages
+    *
+    *  @remarks
+    *    Called whenever the stage has been added to a pipeline.
+    *    Names are updated under the propagation lock (see AbstractSlot::lockPropagation()).
+    */
+    void updateQualifiedName();
+
+    /**
+    *  @brief
+    *    Evaluate timer queries whose results are available
+    *
+    *  @remarks
+    *    Emits timeMeasured for each finished measurement, in the order
+    *    of the process() calls. Never waits for the GPU.
+    */
+    void evaluateTimeQueries();
+
+
+protected:
+    /**
+    *  @brief
+    *    Time measurement of a single process() call
+    */
+    struct TimeQuery
+    {
+        unsigned int startQuery;  ///< OpenGL timestamp query issued before onProcess
+        unsigned int endQuery;    ///< OpenGL timestamp query issued after onProcess
+        uint64_t     cpuDuration; ///< Time spent in onProcess (in nanoseconds)
+        bool         pending;     ///< 'true' if the queries have been issued, but not yet evaluated
+    };
+
+    static const std::size_t s_numTimeQueries = 8; ///< Number of process() calls that can be measured before the GPU has to catch up
+
 
 protected:
-    Environment * m_environment;    ///< Gloperate environment to which the stage belongs
-    bool          m_alwaysProcess;  ///< Is the stage always processed?
-
-    bool                        m_timeMeasurement;      ///< Status of time measurements for CPU and GPU
-    bool                        m_useQueryPairOne;      ///< Flag indicating which queries are currently used
-    bool                        m_resultAvailable;      ///< Flag indicating whether a measurement from previous frames is available for report
-    std::array<unsigned int, 4> m_queries;              ///< OpenGL query objects (front/back; start/end)
-    uint64_t                    m_lastCPUDuration;      ///< Time spent in onProcess last frame (in nanoseconds)
-    uint64_t                    m_currentCPUDuration;   ///< Time spent in onProcess current frame (in nanoseconds)
-    uint64_t                    m_lastGPUDuration;      ///< Time for GPU commands issued during onProcess (in nanoseconds)
+    Environment       * m_environment;          ///< Gloperate environment to which the stage belongs
+    bool                m_alwaysProcess;        ///< Is the stage always processed?
+    std::atomic<bool>   m_dirty;                ///< May the stage need processing? (checked by the parent pipeline, set from any thread)
+    bool                m_invalidationDeferred; ///< Has the invalidation of the outputs been deferred by an update of a parent pipeline?
+    std::string         m_qualifiedName;        ///< Qualified name (see updateQualifiedName())
+
+    bool                                    m_timeMeasurement; ///< Status of time measurements for CPU and GPU
+    std::array<TimeQuery, s_numTimeQueries> m_timeQueries;     ///< Ring of time measurements
+    std::size_t                             m_nextTimeQuery;   ///< Index of the ring entry used for the next measurement (also the oldest entry)
+    uint64_t                                m_lastCPUDuration; ///< Time spent in onProcess in the last evaluated measurement (in nanoseconds)
+    uint64_t                                m_lastGPUDuration; ///< Time for GPU commands issued during onProcess in the last evaluated measurement (in nanoseconds)
 
     std::vector<AbstractSlot *>                     m_inputs;     ///< List of inputs
     std::unordered_map<std::string, AbstractSlot *> m_inputsMap;  ///< Map of names and inputs
@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <gloperate/rendering/RenderTargetType.h>
 #include <gloperate/rendering/AttachmentType.h>
 
@@ -101,6 +103,19 @@ public:
     */
     RenderTargetType currentTargetType() const;
 
+    /**
+    *  @brief
+    *    Get revision of the target
+    *
+    *  @return
+    *    Revision, unique across all render targets
+    *
+    *  @remarks
+    *    The revision only changes if a different target is set or the target is released,
+    *    so framebuffers only have to be reconfigured and validated if it has changed.
+    */
+    std::size_t revision() const;
+
     /**
     *  @brief
     *    Get default framebuffer attachment
@@ -225,6 +240,7 @@ protected:
     globjects::Texture               * m_texture;                  ///< Texture target
     globjects::Renderbuffer          * m_renderbuffer;             ///< Renderbuffer target
     globjects::FramebufferAttachment * m_userDefinedFBOAttachment; ///< User-defined framebuffer attachment target
+    std::size_t                        m_revision;                 ///< Revision, changed on each change of the target
 };
 
 
@@ -5,6 +5,7 @@
 #include <vector>
 #include <unordered_map>
 #include <array>
+#include <memory>
 #include <cstdint>
 
 #include <glbinding/gl/types.h>
@@ -27,9 +28,42 @@ namespace gloperate
 */
 enum class DrawMode : unsigned int
 {
-    Arrays,             ///< Dispatch to glDrawArrays
-    ElementsIndices,    ///< Dispatch to glDrawElements using a CPU index buffer
-    ElementsIndexBuffer ///< Dispatch to glDrawElements using a GPU index buffer
+    Arrays,              ///< Dispatch to glDrawArrays
+    ElementsIndices,     ///< Dispatch to glDrawElements using a CPU index buffer
+    ElementsIndexBuffer, ///< Dispatch to glDrawElements using a GPU index buffer
+    ArraysIndirect,      ///< Dispatch to glMultiDrawArraysIndirect using a GPU command buffer
+    ElementsIndirect     ///< Dispatch to glMultiDrawElementsIndirect using a GPU index buffer and a GPU command buffer
+};
+
+
+/**
+*  @brief
+*    Command for indirect array draw calls
+*
+*    Layout of the commands in the command buffer of DrawMode::ArraysIndirect.
+*/
+struct DrawArraysIndirectCommand
+{
+    std::uint32_t count;         ///< Number of vertices
+    std::uint32_t instanceCount; ///< Number of instances
+    std::uint32_t first;         ///< Index of the first vertex
+    std::uint32_t baseInstance;  ///< Index of the first instance
+};
+
+
+/**
+*  @brief
+*    Command for indirect indexed draw calls
+*
+*    Layout of the commands in the command buffer of DrawMode::ElementsIndirect.
+*/
+struct DrawElementsIndirectCommand
+{
+    std::uint32_t count;         ///< Number of indices
+    std::uint32_t instanceCount; ///< Number of instances
+    std::uint32_t firstIndex;    ///< Index of the first index in the index buffer
+    std::int32_t  baseVertex;    ///< Value added to each index
+    std::uint32_t baseInstance;  ///< Index of the first instance
 };
 
 
@@ -43,8 +77,14 @@ enum class DrawMode : unsigned int
 *
 *    Supported drawing types:
 *    - glDrawArrays
-*    - glDrawElements using CPU index buffer
+*    - glDrawElements using CPU index buffer (uploaded to an owned GPU index buffer when changed)
 *    - glDrawElements using GPU index buffer
+*    - glMultiDrawArraysIndirect using GPU command buffer
+*    - glMultiDrawElementsIndirect using GPU index buffer and GPU command buffer
+*
+*    Non-indirect draw calls render the configured number of instances,
+*    starting at the configured base instance (see setInstanceCount()).
+*    Per-instance attributes are configured using setAttributeBindingDivisor().
 *
 *    Supported buffer arrangements:
 *    - Separate buffer per vertex attribute
@@ -223,6 +263,44 @@ public:
     */
     void drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, globjects::Buffer * indices) const;
 
+    /**
+    *  @brief
+    *    Draw geometry using the commands of the indirect buffer
+    *
+    *  @remarks
+    *    Triggers a glMultiDrawArraysIndirect draw call with the currently
+    *    configured primitive mode and indirect buffer.
+    */
+    void drawArraysIndirect() const;
+
+    /**
+    *  @brief
+    *    Draw geometry using the commands of the indirect buffer, override primitive mode
+    *
+    *  @param[in] mode
+    *    Primitive mode to be used for this specific draw call
+    */
+    void drawArraysIndirect(gl::GLenum mode) const;
+
+    /**
+    *  @brief
+    *    Draw geometry by index-based rendering using the commands of the indirect buffer
+    *
+    *  @remarks
+    *    Triggers a glMultiDrawElementsIndirect draw call with the currently
+    *    configured primitive mode, GPU index buffer, and indirect buffer.
+    */
+    void drawElementsIndirect() const;
+
+    /**
+    *  @brief
+    *    Draw geometry by index-based rendering using the commands of the indirect buffer, override primitive mode
+    *
+    *  @param[in] mode
+    *    Primitive mode to be used for this specific draw call
+    */
+    void drawElementsIndirect(gl::GLenum mode) const;
+
     /**
     *  @brief
     *    Get vertex count
@@ -245,6 +323,45 @@ public:
     */
     void setSize(gl::GLsizei size);
 
+    /**
+    *  @brief
+    *    Get instance count
+    *
+    *  @return
+    *    Number of instances drawn by non-indirect draw calls (default: 1)
+    */
+    gl::GLsizei instanceCount() const;
+
+    /**
+    *  @brief
+    *    Set instance count
+    *
+    *  @param[in] instanceCount
+    *    Number of instances drawn by non-indirect draw calls
+    */
+    void setInstanceCount(gl::GLsizei instanceCount);
+
+    /**
+    *  @brief
+    *    Get base instance
+    *
+    *  @return
+    *    Index of the first instance drawn by non-indirect draw calls (default: 0)
+    */
+    gl::GLuint baseInstance() const;
+
+    /**
+    *  @brief
+    *    Set base instance
+    *
+    *  @param[in] baseInstance
+    *    Index of the first instance drawn by non-indirect draw calls
+    *
+    *  @remarks
+    *    A base instance other than 0 requires OpenGL 4.2 or ARB_base_instance.
+    */
+    void setBaseInstance(gl::GLuint baseInstance);
+
     /**
     *  @brief
     *    Get primitive mode
@@ -397,6 +514,40 @@ public:
     */
     void setIndexBufferType(gl::GLenum bufferType);
 
+    /**
+    *  @brief
+    *    Get indirect command buffer
+    *
+    *  @return
+    *    GPU command buffer (can be null)
+    */
+    globjects::Buffer * indirectBuffer() const;
+
+    /**
+    *  @brief
+    *    Get number of draw commands in the indirect command buffer
+    *
+    *  @return
+    *    Number of draw commands
+    */
+    gl::GLsizei indirectDrawCount() const;
+
+    /**
+    *  @brief
+    *    Set indirect command buffer
+    *
+    *  @param[in] buffer
+    *    GPU command buffer containing DrawArraysIndirectCommand or DrawElementsIndirectCommand structures (can be null)
+    *  @param[in] drawCount
+    *    Number of draw commands
+    *  @param[in] stride
+    *    Distance between consecutive commands in bytes (0 for tightly packed commands)
+    *
+    *  @remarks
+    *    The buffer can be written on the GPU, e.g., by a culling compute shader.
+    */
+    void setIndirectBuffer(globjects::Buffer * buffer, gl::GLsizei drawCount, gl::GLsizei stride = 0);
+
     /**
     *  @brief
     *    Get index buffer data
@@ -412,9 +563,29 @@ public:
     *
     *  @param[in] indices
     *    CPU index buffer (needs to be of type GL_UNSIGNED_INT).
+    *
+    *  @remarks
+    *    The indices are uploaded to a GPU index buffer owned by the drawable
+    *    on the next draw call. Only the range that differs from the previous
+    *    indices is uploaded. If all indices fit into 16 bits, they are stored
+    *    as GL_UNSIGNED_SHORT on the GPU.
     */
     void setIndices(const std::vector<std::uint32_t> & indices);
 
+    /**
+    *  @brief
+    *    Update part of the index buffer data
+    *
+    *  @param[in] offset
+    *    Index of the first index to be replaced
+    *  @param[in] indices
+    *    New indices (offset + indices.size() must not exceed the number of indices)
+    *
+    *  @remarks
+    *    Only the updated range is uploaded on the next draw call.
+    */
+    void updateIndices(size_t offset, const std::vector<std::uint32_t> & indices);
+
     /**
     *  @brief
     *    Get vertex attribute binding
@@ -509,6 +680,17 @@ public:
     */
     void bindAttributes(const std::vector<gl::GLint> & attributeIndices);
 
+    /**
+    *  @brief
+    *    Set divisor for vertex attribute binding
+    *
+    *  @param[in] bindingIndex
+    *    Index of the vertex attribute binding
+    *  @param[in] divisor
+    *    Number of instances per attribute value (0 for per-vertex attributes)
+    */
+    void setAttributeBindingDivisor(size_t bindingIndex, gl::GLuint divisor);
+
     /**
     *  @brief
     *    Enable vertex shader attribute associated with a vertex attribute binding
@@ -525,16 +707,95 @@ public:
     void enableAllAttributeBindings();
 
 
+protected:
+    /**
+    *  @brief
+    *    Bind vertex array for drawing
+    *
+    *  @remarks
+    *    Skips the binding if the RenderStateCache of the
+    *    current thread reports the vertex array as bound.
+    */
+    void bindVertexArray() const;
+
+    /**
+    *  @brief
+    *    Issue indexed draw call for the configured instances
+    *
+    *  @param[in] mode
+    *    Primitive mode
+    *  @param[in] count
+    *    Number of indices
+    *  @param[in] type
+    *    Data type of the indices
+    *  @param[in] indices
+    *    Pointer to the CPU indices, or offset into the bound GPU index buffer
+    */
+    void drawElementsInstanced(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices) const;
+
+    /**
+    *  @brief
+    *    Set index buffer of the vertex array
+    *
+    *  @param[in] buffer
+    *    GPU index buffer (can be null)
+    *
+    *  @remarks
+    *    The vertex array must be bound.
+    */
+    void bindIndexBuffer(globjects::Buffer * buffer) const;
+
+    /**
+    *  @brief
+    *    Upload changed CPU indices to the owned GPU index buffer
+    */
+    void uploadIndices() const;
+
+    /**
+    *  @brief
+    *    Mark range of CPU indices as changed
+    *
+    *  @param[in] begin
+    *    Index of the first changed index
+    *  @param[in] end
+    *    Index after the last changed index
+    */
+    void invalidateIndices(size_t begin, size_t end);
+
+    /**
+    *  @brief
+    *    Called after the vertex array has been configured
+    *
+    *  @remarks
+    *    globjects may bind the vertex array while configuring it,
+    *    so the vertex array binding of the RenderStateCache is reset.
+    */
+    void vertexArrayChanged() const;
+
+
 protected:
     std::unique_ptr<globjects::VertexArray>        m_vao;     ///< The VertexArray used for the vertex shader input specification and draw call triggering
     std::unordered_map<size_t, globjects::Buffer*> m_buffers; ///< The collection of all buffers associated with this geometry. (Note: this class can be used without storing actual buffers here)
 
     DrawMode                   m_drawMode;        ///< The configured draw mode that is used if no specific draw mode is passed in the draw method.
-    gl::GLsizei                m_size;            ///< The configured vertex count that is used if no specific vertex range is passed in the draw method.
-    gl::GLenum                 m_primitiveMode;   ///< The configured primitive mode that is used if no specific primitive mode is passed in the draw method.
-    gl::GLenum                 m_indexBufferType; ///< The configured GPU index buffer type of the currently set index buffer.
-    globjects::Buffer*         m_indexBuffer;     ///< The configured GPU index buffer that is used if no specific index buffer in passed in the draw method.
-    std::vector<std::uint32_t> m_indices;         ///< The configured CPU index buffer that is used if no specific index buffer in passed in the draw method (Note: implied GL_UNSIGNED_INT as index buffer type).
+    gl::GLsizei                m_size;              ///< The configured vertex count that is used if no specific vertex range is passed in the draw method.
+    gl::GLsizei                m_instanceCount;     ///< The configured number of instances for non-indirect draw calls.
+    gl::GLuint                 m_baseInstance;      ///< The configured index of the first instance for non-indirect draw calls.
+    gl::GLenum                 m_primitiveMode;     ///< The configured primitive mode that is used if no specific primitive mode is passed in the draw method.
+    gl::GLenum                 m_indexBufferType;   ///< The configured GPU index buffer type of the currently set index buffer.
+    globjects::Buffer*         m_indexBuffer;       ///< The configured GPU index buffer that is used if no specific index buffer in passed in the draw method.
+    std::vector<std::uint32_t> m_indices;           ///< The configured CPU index buffer that is used if no specific index buffer in passed in the draw method (Note: implied GL_UNSIGNED_INT as index buffer type).
+    std::uint32_t              m_maxIndex;          ///< The largest CPU index, determines the type of the owned GPU index buffer.
+    globjects::Buffer*         m_indirectBuffer;    ///< The configured GPU command buffer for indirect draw calls.
+    gl::GLsizei                m_indirectDrawCount; ///< The configured number of commands in the GPU command buffer.
+    gl::GLsizei                m_indirectStride;    ///< The configured distance between commands in the GPU command buffer (0 for tightly packed).
+
+    mutable std::unique_ptr<globjects::Buffer> m_ownedIndexBuffer; ///< GPU copy of the CPU index buffer, created on first upload.
+    mutable gl::GLenum                         m_ownedIndexType;   ///< Index type of the owned GPU index buffer (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT).
+    mutable size_t                             m_ownedIndexCount;  ///< Number of indices in the owned GPU index buffer.
+    mutable size_t                             m_dirtyBegin;       ///< Index of the first CPU index that has not been uploaded.
+    mutable size_t                             m_dirtyEnd;         ///< Index after the last CPU index that has not been uploaded.
+    mutable globjects::Buffer*                 m_vaoIndexBuffer;   ///< GPU index buffer currently recorded in the vertex array.
 };
 
 
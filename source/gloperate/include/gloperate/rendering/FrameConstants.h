@@ -0,0 +1,51 @@
+
+#pragma once
+
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Constants of a frame, bound once per frame by the canvas
+*
+*    Matches the std140 uniform block 'FrameConstants' declared in
+*    /gloperate/shaders/util/constants.glsl.
+*/
+struct FrameConstants
+{
+    static const unsigned int binding = 0; ///< Uniform buffer binding index
+
+    glm::vec4 viewport;     ///< Viewport of the canvas (x, y, width, height)
+    float     timeDelta;    ///< Time since the last frame in seconds
+    float     time;         ///< Time since the first frame in seconds
+    int       frameCounter; ///< Number of frames rendered before this frame
+    int       padding;      ///< Padding to a multiple of 16 bytes
+};
+
+
+/**
+*  @brief
+*    Transformation constants of a render pass, bound per draw call
+*
+*    Matches the std140 uniform block 'TransformConstants' declared in
+*    /gloperate/shaders/util/constants.glsl.
+*/
+struct TransformConstants
+{
+    static const unsigned int binding = 1; ///< Uniform buffer binding index
+
+    glm::mat4 viewMatrix;                ///< View matrix
+    glm::mat4 projectionMatrix;          ///< Projection matrix
+    glm::mat4 viewProjectionMatrix;      ///< View projection matrix
+    glm::mat4 modelMatrix;               ///< Model matrix
+    glm::mat4 modelViewProjectionMatrix; ///< Model view projection matrix
+};
+
+
+} // namespace gloperate
@@ -0,0 +1,253 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Framebuffer;
+    class Texture;
+    class Renderbuffer;
+}
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Cache of framebuffer objects of a context, keyed by attachments and draw buffers
+*
+*    Instead of reattaching render targets to a single framebuffer whenever
+*    they change, e.g., for stages alternating between render targets, each
+*    configuration of attachments and draw buffers gets its own framebuffer.
+*    Framebuffers are configured and validated once when they are created,
+*    and are evicted in least-recently-used order when the capacity is exceeded.
+*
+*    As globjects does not signal the deletion of textures or renderbuffers,
+*    code that deletes an object that may be attached to a cached framebuffer
+*    has to call releaseTexture() or releaseRenderbuffer() beforehand. This
+*    marks the affected framebuffers of all caches, which are then destroyed
+*    the next time their cache is used in its own context.
+*
+*    A cache is bound to the current thread together with its OpenGL
+*    context using ThreadBinding; without a binding, current() returns null.
+*/
+class GLOPERATE_API FramebufferCache
+{
+public:
+    /**
+    *  @brief
+    *    Binding of a cache to the current thread
+    *
+    *    While a binding exists, FramebufferCache::current() returns the bound
+    *    cache on this thread. The previous binding is restored on destruction.
+    */
+    class GLOPERATE_API ThreadBinding
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] cache
+        *    Cache of the OpenGL context that is current on this thread (can be null)
+        */
+        ThreadBinding(FramebufferCache * cache);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~ThreadBinding();
+
+        // No copying
+        ThreadBinding(const ThreadBinding &) = delete;
+        ThreadBinding & operator=(const ThreadBinding &) = delete;
+
+
+    protected:
+        FramebufferCache * m_previousCache; ///< Previously bound cache
+    };
+
+    /**
+    *  @brief
+    *    Texture or renderbuffer attached to an attachment point
+    */
+    struct GLOPERATE_API Attachment
+    {
+        gl::GLenum                attachment;   ///< Attachment point
+        globjects::Texture      * texture;      ///< Attached texture (can be null)
+        globjects::Renderbuffer * renderbuffer; ///< Attached renderbuffer (can be null)
+        unsigned int              id;           ///< OpenGL name of the attached object, guards against reused addresses
+
+        bool operator==(const Attachment & other) const;
+        bool operator!=(const Attachment & other) const;
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Get cache bound to the current thread
+    *
+    *  @return
+    *    Cache, null if no cache is bound
+    */
+    static FramebufferCache * current();
+
+    /**
+    *  @brief
+    *    Mark framebuffers of all caches that have a texture attached as stale
+    *
+    *  @param[in] texture
+    *    Texture that is about to be deleted
+    *
+    *  @remarks
+    *    Can be called from any thread.
+    */
+    static void releaseTexture(const globjects::Texture * texture);
+
+    /**
+    *  @brief
+    *    Mark framebuffers of all caches that have a renderbuffer attached as stale
+    *
+    *  @param[in] renderbuffer
+    *    Renderbuffer that is about to be deleted
+    *
+    *  @remarks
+    *    Can be called from any thread.
+    */
+    static void releaseRenderbuffer(const globjects::Renderbuffer * renderbuffer);
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] capacity
+    *    Maximum number of cached framebuffers
+    */
+    FramebufferCache(std::size_t capacity = 32);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Framebuffers that are still cached are deleted,
+    *    so clear() should be called while the context is current.
+    */
+    ~FramebufferCache();
+
+    /**
+    *  @brief
+    *    Get maximum number of cached framebuffers
+    *
+    *  @return
+    *    Capacity
+    */
+    std::size_t capacity() const;
+
+    /**
+    *  @brief
+    *    Set maximum number of cached framebuffers
+    *
+    *  @param[in] capacity
+    *    Capacity (at least 1)
+    */
+    void setCapacity(std::size_t capacity);
+
+    /**
+    *  @brief
+    *    Get number of cached framebuffers
+    *
+    *  @return
+    *    Number of cached framebuffers
+    */
+    std::size_t size() const;
+
+    /**
+    *  @brief
+    *    Get framebuffer for a configuration of attachments and draw buffers
+    *
+    *  @param[in] attachments
+    *    Attachments (order is irrelevant)
+    *  @param[in] drawBuffers
+    *    Draw buffers
+    *
+    *  @return
+    *    Framebuffer, which is created and validated on the first request of the configuration
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    globjects::Framebuffer * obtain(const std::vector<Attachment> & attachments, const std::vector<gl::GLenum> & drawBuffers);
+
+    /**
+    *  @brief
+    *    Delete all cached framebuffers
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    void clear();
+
+
+protected:
+    /**
+    *  @brief
+    *    Cached framebuffer
+    */
+    struct Entry
+    {
+        std::vector<Attachment>                 attachments; ///< Attachments, sorted by attachment point
+        std::vector<gl::GLenum>                 drawBuffers; ///< Draw buffers
+        std::unique_ptr<globjects::Framebuffer> fbo;         ///< Framebuffer
+        std::uint64_t                           lastUse;     ///< Use counter value of the last request
+        bool                                    stale;       ///< 'true' if an attached object has been released
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Mark entries that have an object attached as stale
+    *
+    *  @param[in] object
+    *    Texture or renderbuffer
+    */
+    void markStale(const void * object);
+
+    /**
+    *  @brief
+    *    Destroy stale entries
+    *
+    *  @remarks
+    *    Must be called with the mutex locked and the OpenGL context current.
+    */
+    void removeStale();
+
+
+protected:
+    std::vector<Entry> m_entries;    ///< Cached framebuffers
+    std::size_t        m_capacity;   ///< Maximum number of cached framebuffers
+    std::uint64_t      m_useCounter; ///< Counter of requests for LRU eviction
+    bool               m_hasStale;   ///< 'true' if entries have been marked stale since the last request
+    mutable std::mutex m_mutex;      ///< Guards the entries against releases from other threads
+};
+
+
+} // namespace gloperate
@@ -0,0 +1,204 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Buffer;
+}
+
+
+namespace gloperate
+{
+
+
+class Icosahedron;
+
+
+/**
+*  @brief
+*    Library of procedural geometry of a context
+*
+*    Shapes obtain their vertex, texture coordinate and index buffers from
+*    the library of their context, so each configuration of a shape is
+*    generated and uploaded once and its buffers are shared by all shapes
+*    of that configuration. Refined icosahedra are generated once per
+*    refinement level and shared between spheres of different radii.
+*
+*    Geometry that is no longer used by any shape is deleted when new
+*    geometry is created or the library is cleared.
+*
+*    A library is bound to the current thread together with its OpenGL
+*    context using ThreadBinding; without a binding, current() returns null.
+*/
+class GLOPERATE_API GeometryLibrary
+{
+public:
+    /**
+    *  @brief
+    *    Binding of a library to the current thread
+    *
+    *    While a binding exists, GeometryLibrary::current() returns the bound
+    *    library on this thread. The previous binding is restored on destruction.
+    */
+    class GLOPERATE_API ThreadBinding
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] library
+        *    Library of the OpenGL context that is current on this thread (can be null)
+        */
+        ThreadBinding(GeometryLibrary * library);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~ThreadBinding();
+
+        // No copying
+        ThreadBinding(const ThreadBinding &) = delete;
+        ThreadBinding & operator=(const ThreadBinding &) = delete;
+
+
+    protected:
+        GeometryLibrary * m_previousLibrary; ///< Previously bound library
+    };
+
+    /**
+    *  @brief
+    *    Shared buffers of a geometry
+    */
+    struct GLOPERATE_API Geometry
+    {
+        std::unique_ptr<globjects::Buffer> vertices;  ///< Vertex buffer (vec3)
+        std::unique_ptr<globjects::Buffer> texCoords; ///< Texture coordinate buffer (vec2, can be null)
+        std::unique_ptr<globjects::Buffer> indices;   ///< Index buffer (unsigned short)
+        std::size_t                        size;      ///< Number of indices
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Get library bound to the current thread
+    *
+    *  @return
+    *    Library, null if no library is bound
+    */
+    static GeometryLibrary * current();
+
+    /**
+    *  @brief
+    *    Create sphere geometry that is not shared
+    *
+    *  @param[in] icosahedron
+    *    Refined icosahedron
+    *  @param[in] radius
+    *    Sphere radius
+    *  @param[in] texCoords
+    *    'true' if texture coordinates are uploaded (they must have been generated), else 'false'
+    *
+    *  @return
+    *    Geometry
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    static std::shared_ptr<Geometry> createSphere(const Icosahedron & icosahedron, float radius, bool texCoords);
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    GeometryLibrary();
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current, or after clear().
+    */
+    ~GeometryLibrary();
+
+    /**
+    *  @brief
+    *    Get sphere geometry
+    *
+    *  @param[in] radius
+    *    Sphere radius
+    *  @param[in] levels
+    *    Number of refinement levels of the icosahedron
+    *  @param[in] texCoords
+    *    'true' if texture coordinates are required, else 'false'
+    *
+    *  @return
+    *    Geometry, shared with all spheres of the same configuration
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    std::shared_ptr<const Geometry> sphere(float radius, unsigned int levels, bool texCoords);
+
+    /**
+    *  @brief
+    *    Get number of geometries in the library
+    *
+    *  @return
+    *    Number of geometries
+    */
+    std::size_t size() const;
+
+    /**
+    *  @brief
+    *    Release all geometries and icosahedra
+    *
+    *  @remarks
+    *    Buffers that are still used by shapes are deleted with the last shape.
+    *    Must be called with the OpenGL context current.
+    */
+    void clear();
+
+
+protected:
+    /**
+    *  @brief
+    *    Configuration of a sphere
+    */
+    struct SphereEntry
+    {
+        float                     radius;    ///< Sphere radius
+        unsigned int              levels;    ///< Number of refinement levels
+        bool                      texCoords; ///< 'true' if texture coordinates are included
+        std::shared_ptr<Geometry> geometry;  ///< Shared geometry
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Delete geometries that are no longer used by any shape
+    */
+    void collectGarbage();
+
+
+protected:
+    std::vector<SphereEntry>                  m_spheres;    ///< Sphere geometries
+    std::vector<std::unique_ptr<Icosahedron>> m_icosahedra; ///< Refined icosahedra by refinement level (can be null)
+};
+
+
+} // namespace gloperate
@@ -4,7 +4,7 @@
 
 #include <array>
 #include <vector>
-#include <unordered_map>
+#include <utility>
 
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
@@ -145,8 +145,9 @@ private:
     *    Index of the second point in points
     *  @param[in] points
     *    Vertex array
-    *  @param[in] cache
-    *    Point cache
+    *  @param[in] midpoints
+    *    Flat edge table of the current level, holding up to six pairs of
+    *    (greater vertex, midpoint) per smaller vertex of an edge
     *
     *  @return
     *    Index of the new point
@@ -155,7 +156,7 @@ private:
         gl::GLushort a
     ,   gl::GLushort b
     ,   std::vector<glm::vec3> & points
-    ,   std::unordered_map<glm::uint, gl::GLushort> & cache);
+    ,   std::vector<std::pair<gl::GLushort, gl::GLushort>> & midpoints);
 
 
 private:
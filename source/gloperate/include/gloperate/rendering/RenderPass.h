@@ -2,7 +2,8 @@
 #pragma once
 
 
-#include <unordered_map>
+#include <vector>
+#include <utility>
 #include <cstdint>
 #include <cstddef>
 
@@ -39,6 +40,24 @@ namespace gloperate
 */
 class GLOPERATE_API RenderPass : public AbstractDrawable
 {
+public:
+    /**
+    *  @brief
+    *    Assign the binding indices of the constant blocks of a program
+    *
+    *  @param[in] program
+    *    Linked program (must NOT be null!)
+    *
+    *  @remarks
+    *    The blocks declared in /gloperate/shaders/util/constants.glsl have no
+    *    explicit binding, which would require GLSL 4.20. Their bindings are
+    *    reset when the program is linked again, so this has to be called after
+    *    each link. Blocks that the program does not use are skipped.
+    *    Must be called with the OpenGL context current.
+    */
+    static void bindConstantBlocks(globjects::Program * program);
+
+
 public:
     /**
     *  @brief
@@ -331,6 +350,15 @@ public:
     */
     globjects::Texture * removeTexture(gl::GLenum index);
 
+    /**
+    *  @brief
+    *    Get all textures used by the render pass
+    *
+    *  @return
+    *    Pairs of texture index and texture, sorted by texture index
+    */
+    const std::vector<std::pair<size_t, globjects::Texture *>> & textures() const;
+
     /**
     *  @brief
     *    Get sampler used by the render pass
@@ -521,11 +549,58 @@ public:
     */
     globjects::Buffer * removeTransformFeedbackBuffer(size_t index);
 
+    /**
+    *  @brief
+    *    Set constants of a uniform block
+    *
+    *  @param[in] index
+    *    Uniform buffer binding index
+    *  @param[in] data
+    *    Constants in std140 layout (are copied)
+    *  @param[in] size
+    *    Size of the constants in bytes
+    *
+    *  @remarks
+    *    The constants are packed into the UniformRing bound to the current
+    *    thread on each draw and bound by range, instead of being set as
+    *    uniforms of the program. Without a bound ring, they are not bound.
+    *    Constants take precedence over a uniform buffer at the same index.
+    */
+    void setUniformBlock(size_t index, const void * data, size_t size);
+
+    /**
+    *  @brief
+    *    Set constants of a uniform block
+    *
+    *  @param[in] index
+    *    Uniform buffer binding index
+    *  @param[in] constants
+    *    Constants in std140 layout (are copied)
+    */
+    template <typename T>
+    void setUniformBlock(size_t index, const T & constants);
+
+    /**
+    *  @brief
+    *    Remove constants of a uniform block
+    *
+    *  @param[in] index
+    *    Uniform buffer binding index
+    *
+    *  @return
+    *    'true' if constants were set for this index, else 'false'
+    */
+    bool removeUniformBlock(size_t index);
+
 
 protected:
     /**
     *  @brief
     *    Bind all configured resources before rendering
+    *
+    *  @remarks
+    *    If a RenderStateCache is bound to the current thread,
+    *    resources that are already bound are skipped.
     */
     void bindResources() const;
 
@@ -541,13 +616,17 @@ protected:
     globjects::TransformFeedback * m_drawTransformFeedback;       ///< Transform feedback object for playback (can be null)
     gl::GLenum                     m_drawTransformFeedbackMode;   ///< Primitive mode for playback transform feedback
 
-    std::unordered_map<size_t, globjects::Texture*> m_textures;                 /// Collection of all textures associated with this render pass. The key is used as the active texture binding.
-    std::unordered_map<size_t, globjects::Sampler*> m_samplers;                 /// Collection of all samplers associated with this render pass. The key is used as the sampler binding index.
-    std::unordered_map<size_t, globjects::Buffer*>  m_uniformBuffers;           /// Collection of all uniform buffers associated with this render pass. The key is used as the uniform buffer binding index.
-    std::unordered_map<size_t, globjects::Buffer*>  m_atomicCounterBuffers;     /// Collection of all atomic counter buffers associated with this render pass. The key is used as the atomic counter buffer binding index.
-    std::unordered_map<size_t, globjects::Buffer*>  m_shaderStorageBuffers;     /// Collection of all shader storage buffers associated with this render pass. The key is used as the shader storage buffer binding index.
-    std::unordered_map<size_t, globjects::Buffer*>  m_transformFeedbackBuffers; /// Collection of all transform feedback buffers associated with this render pass. The key is used as the transform feedback buffer binding index.
+    std::vector<std::pair<size_t, globjects::Texture *>> m_textures;                 ///< Textures associated with this render pass, sorted by active texture binding
+    std::vector<std::pair<size_t, globjects::Sampler *>> m_samplers;                 ///< Samplers associated with this render pass, sorted by sampler binding index
+    std::vector<std::pair<size_t, globjects::Buffer *>>  m_uniformBuffers;           ///< Uniform buffers associated with this render pass, sorted by uniform buffer binding index
+    std::vector<std::pair<size_t, globjects::Buffer *>>  m_atomicCounterBuffers;     ///< Atomic counter buffers associated with this render pass, sorted by atomic counter buffer binding index
+    std::vector<std::pair<size_t, globjects::Buffer *>>  m_shaderStorageBuffers;     ///< Shader storage buffers associated with this render pass, sorted by shader storage buffer binding index
+    std::vector<std::pair<size_t, globjects::Buffer *>>  m_transformFeedbackBuffers; ///< Transform feedback buffers associated with this render pass, sorted by transform feedback buffer binding index
+    std::vector<std::pair<size_t, std::vector<unsigned char>>> m_uniformBlocks; ///< Constants of uniform blocks associated with this render pass, bound through the current UniformRing
 };
 
 
 } // namespace gloperate
+
+
+#include <gloperate/rendering/RenderPass.inl>
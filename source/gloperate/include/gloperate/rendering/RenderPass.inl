@@ -0,0 +1,16 @@
+
+#pragma once
+
+
+namespace gloperate
+{
+
+
+template <typename T>
+void RenderPass::setUniformBlock(size_t index, const T & constants)
+{
+    setUniformBlock(index, &constants, sizeof(T));
+}
+
+
+} // namespace gloperate
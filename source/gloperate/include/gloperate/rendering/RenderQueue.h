@@ -0,0 +1,165 @@
+
+#pragma once
+
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+#include <gloperate/rendering/AbstractDrawable.h>
+#include <gloperate/rendering/RenderStateCache.h>
+
+
+namespace globjects
+{
+    class Framebuffer;
+}
+
+
+namespace gloperate
+{
+
+
+class RenderPass;
+
+
+/**
+*  @brief
+*    Queue that draws render passes sorted by their state
+*
+*    Render passes can be submitted to the queue by one or more stages
+*    during a frame. When the queue is drawn, the passes are sorted by a
+*    64-bit key built from (in order of priority) their framebuffer,
+*    program, state, set of textures, geometry, and depth, so that passes
+*    sharing a configuration are drawn one after another. Together with
+*    the RenderStateCache, bindings that are shared by consecutive passes
+*    are then only applied once.
+*
+*    Passes without a framebuffer are drawn first, into the framebuffer
+*    that is bound when draw() is called.
+*
+*    Passes with equal keys are drawn in the order of submission. As the
+*    queue reorders passes, it should only be used for passes whose result
+*    does not depend on the drawing order (e.g., opaque geometry with
+*    depth test enabled).
+*
+*    The queue does not own the submitted objects; they must stay valid
+*    until the queue is cleared.
+*/
+class GLOPERATE_API RenderQueue : public AbstractDrawable
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    RenderQueue();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    virtual ~RenderQueue();
+
+    /**
+    *  @brief
+    *    Submit render pass
+    *
+    *  @param[in] pass
+    *    Render pass (must NOT be null!)
+    *  @param[in] depth
+    *    Normalized depth in [0, 1], passes with equal state are drawn front to back
+    *  @param[in] framebuffer
+    *    Framebuffer that is bound before drawing the pass (can be null to draw into the framebuffer bound when the queue is drawn)
+    */
+    void submit(const RenderPass * pass, float depth = 0.0f, globjects::Framebuffer * framebuffer = nullptr);
+
+    /**
+    *  @brief
+    *    Get number of submitted render passes
+    *
+    *  @return
+    *    Number of render passes
+    */
+    std::size_t size() const;
+
+    /**
+    *  @brief
+    *    Remove all submitted render passes
+    *
+    *  @remarks
+    *    Should be called once per frame, before the passes are submitted.
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Draw all submitted render passes in sorted order
+    */
+    virtual void draw() const override;
+
+
+protected:
+    /**
+    *  @brief
+    *    Submitted render pass
+    */
+    struct Item
+    {
+        std::uint64_t            key;         ///< Sort key
+        std::uint32_t            order;       ///< Submission order, used for passes with equal keys
+        const RenderPass       * pass;        ///< Render pass
+        globjects::Framebuffer * framebuffer; ///< Framebuffer (can be null)
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Sort submitted render passes by their keys, if they are not sorted yet
+    */
+    void sort() const;
+
+    /**
+    *  @brief
+    *    Get small ID for an object, in order of first submission
+    *
+    *  @param[in,out] ids
+    *    IDs of the objects submitted so far
+    *  @param[in] object
+    *    Object identity (pointer or hash)
+    *  @param[in] bits
+    *    Number of bits available for the ID
+    *
+    *  @return
+    *    ID of the object (saturated to the largest ID if there are too many objects)
+    */
+    static std::uint64_t id(std::unordered_map<std::uint64_t, std::uint64_t> & ids, std::uint64_t object, unsigned int bits);
+
+    /**
+    *  @brief
+    *    Compute identity of the set of textures of a render pass
+    *
+    *  @param[in] pass
+    *    Render pass
+    *
+    *  @return
+    *    Hash of the texture bindings
+    */
+    static std::uint64_t textureSet(const RenderPass * pass);
+
+
+protected:
+    mutable std::vector<Item>                          m_items;        ///< Submitted render passes
+    mutable bool                                       m_sorted;       ///< 'true' if m_items is sorted, else 'false'
+    mutable RenderStateCache                           m_stateCache;   ///< Cache used if none is bound to the drawing thread
+    std::unordered_map<std::uint64_t, std::uint64_t>   m_framebuffers; ///< Framebuffer IDs
+    std::unordered_map<std::uint64_t, std::uint64_t>   m_programs;     ///< Program IDs
+    std::unordered_map<std::uint64_t, std::uint64_t>   m_states;       ///< State IDs
+    std::unordered_map<std::uint64_t, std::uint64_t>   m_textureSets;  ///< Texture set IDs
+    std::unordered_map<std::uint64_t, std::uint64_t>   m_geometries;   ///< Geometry IDs
+};
+
+
+} // namespace gloperate
@@ -0,0 +1,322 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Shadow copy of the OpenGL bindings of a context
+*
+*    The cache records which objects have been bound by RenderPass and
+*    Drawable, so that binding an object that is already bound can be
+*    skipped. Each update function records the new binding and returns
+*    'true' if the binding has actually changed and must be applied to
+*    OpenGL, or 'false' if the call can be avoided.
+*
+*    The cache only knows about bindings that went through it. It is
+*    invalidated once at the start of each frame, as the windowing backend
+*    may change any binding. During the frame, every component that binds
+*    vertex arrays or textures or toggles capabilities directly has to
+*    keep the cache in sync, e.g., using applyCapability(),
+*    vertexArrayChanged(), and texturesChanged(). Programs are not cached,
+*    as Program::use() also relinks changed programs and globjects may use
+*    programs implicitly when setting uniforms.
+*
+*    A cache is bound to the current thread together with its OpenGL
+*    context using ThreadBinding; without a binding, current() returns
+*    null and all bindings are applied unconditionally.
+*/
+class GLOPERATE_API RenderStateCache
+{
+public:
+    /**
+    *  @brief
+    *    Binding of a cache to the current thread
+    *
+    *    While a binding exists, RenderStateCache::current() returns the bound
+    *    cache on this thread. The previous binding is restored on destruction.
+    */
+    class GLOPERATE_API ThreadBinding
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] cache
+        *    Cache of the OpenGL context that is current on this thread (can be null)
+        */
+        ThreadBinding(RenderStateCache * cache);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~ThreadBinding();
+
+        // No copying
+        ThreadBinding(const ThreadBinding &) = delete;
+        ThreadBinding & operator=(const ThreadBinding &) = delete;
+
+
+    protected:
+        RenderStateCache * m_previousCache; ///< Previously bound cache
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Get cache bound to the current thread
+    *
+    *  @return
+    *    Cache, null if no cache is bound
+    */
+    static RenderStateCache * current();
+
+    /**
+    *  @brief
+    *    Enable or disable capability
+    *
+    *  @param[in] capability
+    *    Capability (e.g., GL_DEPTH_TEST)
+    *  @param[in] enabled
+    *    'true' to enable the capability, 'false' to disable it
+    *
+    *  @remarks
+    *    The call is skipped if the cache bound to the current thread
+    *    reports the capability as already set.
+    */
+    static void applyCapability(gl::GLenum capability, bool enabled);
+
+    /**
+    *  @brief
+    *    Forget vertex array binding of the cache bound to the current thread
+    *
+    *  @remarks
+    *    Must be called after a vertex array has been bound directly,
+    *    e.g., by a renderer of another library.
+    */
+    static void vertexArrayChanged();
+
+    /**
+    *  @brief
+    *    Forget texture bindings of the cache bound to the current thread
+    *
+    *  @remarks
+    *    Must be called after textures have been bound directly. This
+    *    includes creating and modifying textures, as globjects binds them
+    *    to the active texture unit without direct state access.
+    */
+    static void texturesChanged();
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    RenderStateCache();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~RenderStateCache();
+
+    /**
+    *  @brief
+    *    Forget all recorded bindings
+    *
+    *  @remarks
+    *    Must be called when bindings have been changed without the cache.
+    */
+    void invalidate();
+
+    /**
+    *  @brief
+    *    Forget recorded capabilities
+    *
+    *  @remarks
+    *    Must be called after a globjects::State has been applied,
+    *    as it may enable or disable any capability.
+    */
+    void invalidateCapabilities();
+
+    /**
+    *  @brief
+    *    Forget recorded vertex array binding
+    *
+    *  @remarks
+    *    Must be called after a vertex array has been bound directly,
+    *    e.g., by globjects while configuring it.
+    */
+    void invalidateVertexArray();
+
+    /**
+    *  @brief
+    *    Forget recorded texture and sampler bindings
+    *
+    *  @remarks
+    *    Must be called after textures or samplers have been bound directly.
+    */
+    void invalidateTextures();
+
+    /**
+    *  @brief
+    *    Record vertex array binding
+    *
+    *  @param[in] vertexArray
+    *    Vertex array name (0 to unbind)
+    *
+    *  @return
+    *    'true' if the binding has changed and must be applied, else 'false'
+    */
+    bool updateVertexArray(gl::GLuint vertexArray);
+
+    /**
+    *  @brief
+    *    Record texture binding
+    *
+    *  @param[in] unit
+    *    Texture unit
+    *  @param[in] texture
+    *    Texture name
+    *
+    *  @return
+    *    'true' if the binding has changed and must be applied, else 'false'
+    */
+    bool updateTexture(std::size_t unit, gl::GLuint texture);
+
+    /**
+    *  @brief
+    *    Record sampler binding
+    *
+    *  @param[in] unit
+    *    Texture unit
+    *  @param[in] sampler
+    *    Sampler name
+    *
+    *  @return
+    *    'true' if the binding has changed and must be applied, else 'false'
+    */
+    bool updateSampler(std::size_t unit, gl::GLuint sampler);
+
+    /**
+    *  @brief
+    *    Record indexed buffer binding
+    *
+    *  @param[in] target
+    *    Buffer target (e.g., GL_UNIFORM_BUFFER)
+    *  @param[in] index
+    *    Binding index
+    *  @param[in] buffer
+    *    Buffer name
+    *
+    *  @return
+    *    'true' if the binding has changed and must be applied, else 'false'
+    */
+    bool updateBufferBase(gl::GLenum target, std::size_t index, gl::GLuint buffer);
+
+    /**
+    *  @brief
+    *    Forget recorded indexed buffer binding
+    *
+    *  @param[in] target
+    *    Buffer target (e.g., GL_UNIFORM_BUFFER)
+    *  @param[in] index
+    *    Binding index
+    *
+    *  @remarks
+    *    Must be called when a range of a buffer has been bound to the index.
+    */
+    void invalidateBufferBase(gl::GLenum target, std::size_t index);
+
+    /**
+    *  @brief
+    *    Record capability
+    *
+    *  @param[in] capability
+    *    Capability (e.g., GL_RASTERIZER_DISCARD)
+    *  @param[in] enabled
+    *    'true' if the capability is enabled, else 'false'
+    *
+    *  @return
+    *    'true' if the capability has changed and must be applied, else 'false'
+    */
+    bool updateCapability(gl::GLenum capability, bool enabled);
+
+    /**
+    *  @brief
+    *    Get number of avoided OpenGL calls
+    *
+    *  @return
+    *    Number of update calls that returned 'false' since the last reset
+    */
+    std::uint64_t avoidedCalls() const;
+
+    /**
+    *  @brief
+    *    Reset number of avoided OpenGL calls
+    */
+    void resetAvoidedCalls();
+
+
+protected:
+    /**
+    *  @brief
+    *    Record binding in a list indexed by unit or binding index
+    *
+    *  @param[in,out] bindings
+    *    List of bindings
+    *  @param[in] index
+    *    Unit or binding index
+    *  @param[in] name
+    *    Object name
+    *
+    *  @return
+    *    'true' if the binding has changed, else 'false'
+    */
+    bool update(std::vector<gl::GLuint> & bindings, std::size_t index, gl::GLuint name);
+
+    /**
+    *  @brief
+    *    Record binding of a single binding point
+    *
+    *  @param[in,out] binding
+    *    Binding
+    *  @param[in] name
+    *    Object name
+    *
+    *  @return
+    *    'true' if the binding has changed, else 'false'
+    */
+    bool update(gl::GLuint & binding, gl::GLuint name);
+
+
+protected:
+    static const gl::GLuint s_unknown; ///< Marks a binding that is not known to the cache
+
+    gl::GLuint                                                  m_vertexArray;     ///< Bound vertex array
+    std::vector<gl::GLuint>                                     m_textures;        ///< Bound textures per texture unit
+    std::vector<gl::GLuint>                                     m_samplers;        ///< Bound samplers per texture unit
+    std::vector<std::pair<gl::GLenum, std::vector<gl::GLuint>>> m_buffers;         ///< Bound buffers per indexed target and binding index
+    std::vector<std::pair<gl::GLenum, bool>>                    m_capabilities;    ///< Known capabilities
+    std::uint64_t                                               m_avoidedCalls;    ///< Number of avoided OpenGL calls
+};
+
+
+} // namespace gloperate
@@ -0,0 +1,308 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <unordered_map>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Texture;
+    class Renderbuffer;
+}
+
+
+namespace gloperate
+{
+
+
+class Stage;
+
+
+/**
+*  @brief
+*    Pool of transient render target storage of a pipeline
+*
+*    Render target stages that are marked as transient request their
+*    texture or renderbuffer from the pool of their pipeline instead of
+*    allocating it themselves. The pipeline determines the lifetime of
+*    each client as the range of its sorted stages from the first to
+*    the last stage that uses its render targets, and clients whose
+*    lifetimes do not overlap share the same texture or renderbuffer if
+*    they request the same internal format and size.
+*
+*    The contents of transient render targets are therefore only valid
+*    until the last stage of their lifetime has been processed, and only
+*    in frames in which the render target is drawn before it is read.
+*
+*    Clients with unknown lifetime never share their storage.
+*/
+class GLOPERATE_API RenderTargetPool
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    RenderTargetPool();
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Storage that is still allocated is deleted,
+    *    so clear() should be called while the context is current.
+    */
+    virtual ~RenderTargetPool();
+
+    /**
+    *  @brief
+    *    Register client
+    *
+    *  @param[in] client
+    *    Stage that requests storage (must NOT be null)
+    *
+    *  @remarks
+    *    Registering a new client marks the lifetimes as outdated.
+    */
+    void addClient(const Stage * client);
+
+    /**
+    *  @brief
+    *    Unregister client and release its storage
+    *
+    *  @param[in] client
+    *    Stage that requested storage
+    *
+    *  @remarks
+    *    Unused storage is only deleted by collectGarbage().
+    */
+    void removeClient(const Stage * client);
+
+    /**
+    *  @brief
+    *    Check if a stage is a registered client
+    *
+    *  @param[in] client
+    *    Stage
+    *
+    *  @return
+    *    'true' if the stage is a client, else 'false'
+    */
+    bool isClient(const Stage * client) const;
+
+    /**
+    *  @brief
+    *    Check if clients have been registered since the storage has been reassigned
+    *
+    *  @return
+    *    'true' if lifetimes have to be updated, else 'false'
+    */
+    bool lifetimesOutdated() const;
+
+    /**
+    *  @brief
+    *    Set lifetime of a client
+    *
+    *  @param[in] client
+    *    Registered client
+    *  @param[in] first
+    *    Index of the first stage that uses the storage
+    *  @param[in] last
+    *    Index of the last stage that uses the storage
+    *
+    *  @return
+    *    'true' if the lifetime has changed, else 'false'
+    */
+    bool setLifetime(const Stage * client, std::size_t first, std::size_t last);
+
+    /**
+    *  @brief
+    *    Get lifetime of a client
+    *
+    *  @param[in] client
+    *    Registered client
+    *
+    *  @return
+    *    Indices of the first and last stage that use the storage
+    *    (the maximum index as last stage if the lifetime is unknown)
+    */
+    std::pair<std::size_t, std::size_t> lifetime(const Stage * client) const;
+
+    /**
+    *  @brief
+    *    Check if the storage of a client is shared with other clients
+    *
+    *  @param[in] client
+    *    Registered client
+    *
+    *  @return
+    *    'true' if other clients currently use the same storage, else 'false'
+    *
+    *  @remarks
+    *    Other clients may overwrite shared storage whenever they are processed,
+    *    so its contents have to be drawn again before they are read.
+    */
+    bool isShared(const Stage * client) const;
+
+    /**
+    *  @brief
+    *    Release storage of all clients, so it is shared according to the current lifetimes
+    *
+    *    The storage itself is kept for the following requests. Clients have
+    *    to request their storage again, so their stages have to be processed.
+    */
+    void reassign();
+
+    /**
+    *  @brief
+    *    Get texture for a client
+    *
+    *  @param[in] client
+    *    Registered client
+    *  @param[in] internalFormat
+    *    OpenGL internal image format
+    *  @param[in] format
+    *    OpenGL image format
+    *  @param[in] type
+    *    OpenGL data type
+    *  @param[in] width
+    *    Width
+    *  @param[in] height
+    *    Height
+    *
+    *  @return
+    *    2D texture with allocated storage, which may be shared with other clients
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    globjects::Texture * obtainTexture(const Stage * client, gl::GLenum internalFormat, gl::GLenum format, gl::GLenum type, int width, int height);
+
+    /**
+    *  @brief
+    *    Get renderbuffer for a client
+    *
+    *  @param[in] client
+    *    Registered client
+    *  @param[in] internalFormat
+    *    OpenGL internal image format
+    *  @param[in] width
+    *    Width
+    *  @param[in] height
+    *    Height
+    *
+    *  @return
+    *    Renderbuffer with allocated storage, which may be shared with other clients
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    globjects::Renderbuffer * obtainRenderbuffer(const Stage * client, gl::GLenum internalFormat, int width, int height);
+
+    /**
+    *  @brief
+    *    Get number of allocated textures and renderbuffers
+    *
+    *  @return
+    *    Number of allocated textures and renderbuffers
+    */
+    std::size_t size() const;
+
+    /**
+    *  @brief
+    *    Delete textures and renderbuffers that are not used by any client
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    void collectGarbage();
+
+    /**
+    *  @brief
+    *    Delete all textures and renderbuffers
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    void clear();
+
+
+protected:
+    /**
+    *  @brief
+    *    Allocated texture or renderbuffer
+    */
+    struct Resource
+    {
+        bool                                     isRenderbuffer; ///< 'true' for a renderbuffer, 'false' for a texture
+        gl::GLenum                               internalFormat; ///< OpenGL internal image format
+        int                                      width;          ///< Width
+        int                                      height;         ///< Height
+        std::unique_ptr<globjects::Texture>      texture;        ///< Texture (null for renderbuffers)
+        std::unique_ptr<globjects::Renderbuffer> renderbuffer;   ///< Renderbuffer (null for textures)
+        std::vector<const Stage *>               users;          ///< Clients that currently use the storage
+    };
+
+    /**
+    *  @brief
+    *    Registered client
+    */
+    struct Client
+    {
+        std::size_t first;    ///< Index of the first stage that uses the storage
+        std::size_t last;     ///< Index of the last stage that uses the storage
+        Resource  * resource; ///< Assigned storage (can be null)
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Find storage for a client, or allocate it
+    *
+    *  @param[in] client
+    *    Registered client
+    *  @param[in] isRenderbuffer
+    *    'true' for a renderbuffer, 'false' for a texture
+    *  @param[in] internalFormat
+    *    OpenGL internal image format
+    *  @param[in] width
+    *    Width
+    *  @param[in] height
+    *    Height
+    *
+    *  @return
+    *    Assigned storage (a new resource has neither texture nor renderbuffer yet)
+    */
+    Resource * assign(const Stage * client, bool isRenderbuffer, gl::GLenum internalFormat, int width, int height);
+
+    /**
+    *  @brief
+    *    Release storage of a client
+    *
+    *  @param[in] client
+    *    Registered client
+    *  @param[in,out] entry
+    *    Entry of the client
+    */
+    void unassign(const Stage * client, Client & entry);
+
+
+protected:
+    std::vector<std::unique_ptr<Resource>>    m_resources;         ///< Allocated textures and renderbuffers
+    std::unordered_map<const Stage *, Client> m_clients;           ///< Registered clients
+    bool                                      m_lifetimesOutdated; ///< 'true' if clients have been registered since the last reassignment
+};
+
+
+} // namespace gloperate
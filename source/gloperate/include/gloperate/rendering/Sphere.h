@@ -4,11 +4,9 @@
 
 #include <memory>
 
-#include <globjects/Buffer.h>
-
 #include <gloperate/rendering/Shape.h>
 #include <gloperate/rendering/Drawable.h>
-#include <gloperate/rendering/Icosahedron.h>
+#include <gloperate/rendering/GeometryLibrary.h>
 
 
 namespace gloperate
@@ -18,6 +16,10 @@ namespace gloperate
 /**
 *  @brief
 *    Sphere drawable
+*
+*    The buffers of the sphere are obtained from the GeometryLibrary bound
+*    to the current thread, so spheres of the same radius and options share
+*    their geometry. Without a bound library, each sphere creates its own.
 */
 class GLOPERATE_API Sphere : public Shape
 {
@@ -44,11 +46,8 @@ public:
 
 
 protected:
-    std::unique_ptr<Icosahedron>       m_icosahedron; ///< Refinable icosahedron
-    std::unique_ptr<Drawable>          m_drawable;    ///< Underlying drawable object
-    std::unique_ptr<globjects::Buffer> m_vertices;    ///< Vertex buffer
-    std::unique_ptr<globjects::Buffer> m_texCoords;   ///< Texture coordinate buffer
-    std::unique_ptr<globjects::Buffer> m_indices;     ///< Index buffer
+    std::unique_ptr<Drawable>                        m_drawable; ///< Underlying drawable object
+    std::shared_ptr<const GeometryLibrary::Geometry> m_geometry; ///< Vertex, texture coordinate and index buffers
 };
 
 
@@ -0,0 +1,171 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Buffer;
+    class Sync;
+}
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Buffer for data that is rewritten every frame
+*
+*    The buffer is partitioned into regions that are written in turn, so
+*    the CPU writes the data of a frame while the GPU may still read the
+*    data of previous frames. Each region is guarded by a fence sync, which
+*    is placed when the next region is mapped, i.e., after all commands that
+*    read the region have been issued, and waited for before the region is
+*    written again.
+*
+*    If immutable buffer storage is available (OpenGL 4.4 or
+*    GL_ARB_buffer_storage), the buffer is mapped persistently and coherently
+*    once, so writes go straight into mapped memory. Otherwise, each region is
+*    mapped unsynchronized and has to be unmapped before it is used.
+*
+*    The storage only grows if a frame requests more than the region size,
+*    in which case the whole buffer is reallocated.
+*/
+class GLOPERATE_API StreamingBuffer
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] regionSize
+    *    Initial size of a region in bytes
+    *  @param[in] numRegions
+    *    Number of regions (at least 1)
+    *
+    *  @remarks
+    *    The storage is allocated on the first call to map().
+    */
+    StreamingBuffer(std::size_t regionSize = 4096, std::size_t numRegions = 3);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    ~StreamingBuffer();
+
+    /**
+    *  @brief
+    *    Get buffer
+    *
+    *  @return
+    *    Buffer, null before the first call to map()
+    *
+    *  @remarks
+    *    The buffer may change on calls to map().
+    */
+    globjects::Buffer * buffer() const;
+
+    /**
+    *  @brief
+    *    Get offset of the current region
+    *
+    *  @return
+    *    Offset in bytes, a multiple of the region alignment
+    */
+    std::size_t offset() const;
+
+    /**
+    *  @brief
+    *    Get size of a region
+    *
+    *  @return
+    *    Size in bytes
+    */
+    std::size_t regionSize() const;
+
+    /**
+    *  @brief
+    *    Get number of regions
+    *
+    *  @return
+    *    Number of regions
+    */
+    std::size_t numRegions() const;
+
+    /**
+    *  @brief
+    *    Check if the buffer is mapped persistently
+    *
+    *  @return
+    *    'true' if mapped memory stays valid while the buffer is used, so unmap() can be omitted, else 'false'
+    */
+    bool persistent() const;
+
+    /**
+    *  @brief
+    *    Advance to the next region and map it for writing
+    *
+    *  @param[in] size
+    *    Number of bytes that will be written
+    *
+    *  @return
+    *    Pointer to the mapped region, null on failure
+    *
+    *  @remarks
+    *    Blocks only if the GPU has not finished reading the region yet.
+    *    Must be called with the OpenGL context current.
+    */
+    void * map(std::size_t size);
+
+    /**
+    *  @brief
+    *    Finish writing to the current region
+    *
+    *  @remarks
+    *    Must be called before the region is used by OpenGL commands.
+    *    Must be called with the OpenGL context current.
+    */
+    void unmap();
+
+
+protected:
+    /**
+    *  @brief
+    *    Allocate buffer storage for the current region size
+    */
+    void allocate();
+
+    /**
+    *  @brief
+    *    Wait until the GPU has finished reading a region
+    *
+    *  @param[in] region
+    *    Index of the region
+    */
+    void waitForRegion(std::size_t region);
+
+
+protected:
+    std::unique_ptr<globjects::Buffer>            m_buffer;     ///< Buffer
+    std::vector<std::unique_ptr<globjects::Sync>> m_fences;     ///< Fence syncs guarding the regions (can be null)
+    std::size_t                                   m_regionSize; ///< Size of a region in bytes
+    std::size_t                                   m_region;     ///< Index of the current region
+    bool                                          m_persistent; ///< 'true' if the buffer is mapped persistently
+    bool                                          m_mapped;     ///< 'true' if the current region is mapped
+    unsigned char                               * m_data;       ///< Persistently mapped memory (can be null)
+};
+
+
+} // namespace gloperate
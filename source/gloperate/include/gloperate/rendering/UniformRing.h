@@ -0,0 +1,177 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Buffer;
+}
+
+
+namespace gloperate
+{
+
+
+class StreamingBuffer;
+
+
+/**
+*  @brief
+*    Ring-allocated uniform buffer for per-frame and per-object constants
+*
+*    Constants are packed into the current region of a streaming buffer and
+*    bound by range, so updating the constants of a draw call costs a copy
+*    and a single binding instead of one glUniform call per value and program.
+*    Regions are recycled after the GPU has finished the frame that read
+*    them (see StreamingBuffer).
+*
+*    If the constants of a frame exceed the region size, the remaining
+*    constants are uploaded to a separate buffer that is respecified for
+*    each binding, and the region grows for the next frame.
+*
+*    A ring is bound to the current thread together with its OpenGL
+*    context using ThreadBinding; without a binding, current() returns null.
+*/
+class GLOPERATE_API UniformRing
+{
+public:
+    /**
+    *  @brief
+    *    Binding of a ring to the current thread
+    *
+    *    While a binding exists, UniformRing::current() returns the bound
+    *    ring on this thread. The previous binding is restored on destruction.
+    */
+    class GLOPERATE_API ThreadBinding
+    {
+    public:
+        /**
+        *  @brief
+        *    Constructor
+        *
+        *  @param[in] ring
+        *    Ring of the OpenGL context that is current on this thread (can be null)
+        */
+        ThreadBinding(UniformRing * ring);
+
+        /**
+        *  @brief
+        *    Destructor
+        */
+        ~ThreadBinding();
+
+        // No copying
+        ThreadBinding(const ThreadBinding &) = delete;
+        ThreadBinding & operator=(const ThreadBinding &) = delete;
+
+
+    protected:
+        UniformRing * m_previousRing; ///< Previously bound ring
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Get ring bound to the current thread
+    *
+    *  @return
+    *    Ring, null if no ring is bound
+    */
+    static UniformRing * current();
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] regionSize
+    *    Initial number of bytes available per frame
+    *  @param[in] numRegions
+    *    Number of frames that may be in flight
+    */
+    UniformRing(std::size_t regionSize = 65536, std::size_t numRegions = 3);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current, or after clear().
+    */
+    ~UniformRing();
+
+    /**
+    *  @brief
+    *    Start allocating constants of a new frame
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    void beginFrame();
+
+    /**
+    *  @brief
+    *    Copy constants into the ring and bind them to a uniform buffer binding
+    *
+    *  @param[in] index
+    *    Uniform buffer binding index
+    *  @param[in] data
+    *    Constants in std140 layout
+    *  @param[in] size
+    *    Size of the constants in bytes
+    *
+    *  @return
+    *    'true' if the constants have been packed into the ring, 'false' if they have been uploaded to the overflow buffer
+    *
+    *  @remarks
+    *    The constants are bound in either case.
+    *    Must be called with the OpenGL context current.
+    */
+    bool bind(std::size_t index, const void * data, std::size_t size);
+
+    /**
+    *  @brief
+    *    Copy constants into the ring and bind them to a uniform buffer binding
+    *
+    *  @param[in] index
+    *    Uniform buffer binding index
+    *  @param[in] constants
+    *    Constants in std140 layout
+    *
+    *  @return
+    *    'true' if the constants have been packed into the ring, 'false' if they have been uploaded to the overflow buffer
+    */
+    template <typename T>
+    bool bind(std::size_t index, const T & constants);
+
+    /**
+    *  @brief
+    *    Delete the buffer
+    *
+    *  @remarks
+    *    Must be called with the OpenGL context current.
+    */
+    void clear();
+
+
+protected:
+    std::unique_ptr<StreamingBuffer>   m_buffer;   ///< Buffer the constants are packed into
+    std::unique_ptr<globjects::Buffer> m_overflow; ///< Buffer for constants that do not fit into the current region (created on first use)
+    unsigned char                    * m_data;     ///< Mapped memory of the current region (null if it is written with setSubData())
+    std::size_t                        m_used;     ///< Number of bytes requested in the current frame
+    bool                               m_ready;    ///< 'true' if the current region can be written
+};
+
+
+} // namespace gloperate
+
+
+#include <gloperate/rendering/UniformRing.inl>
@@ -0,0 +1,16 @@
+
+#pragma once
+
+
+namespace gloperate
+{
+
+
+template <typename T>
+bool UniformRing::bind(std::size_t index, const T & constants)
+{
+    return bind(index, &constants, sizeof(T));
+}
+
+
+} // namespace gloperate
@@ -22,6 +22,7 @@ class GLOPERATE_API CubeMapProjectionsStage : public gloperate::Stage
 public:
     CubeMapProjectionsStage(gloperate::Environment * environment, const std::string & name = "CubeMapProjectionsStage");
     virtual void onContextInit(gloperate::AbstractGLContext * context) override;
+    virtual bool requiresContext() const override;
 
 
 public:
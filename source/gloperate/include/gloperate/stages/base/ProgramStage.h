@@ -83,11 +83,12 @@ protected:
 protected:
     // OpenGL objects
     std::unique_ptr<globjects::Program>             m_program; ///< Program object
-    std::vector<std::unique_ptr<globjects::Shader>> m_shaders; ///< collection of self created shaders for later removal
+    std::vector<std::shared_ptr<globjects::Shader>> m_shaders; ///< collection of shaders loaded from files, shared with other stages of the context using the same files
 
     // Signal connections
     cppexpose::ScopedConnection m_inputAddedConnection;
     cppexpose::ScopedConnection m_inputRemovedConnection;
+    cppexpose::ScopedConnection m_resourceChangedConnection;
 };
 
 
@@ -42,6 +42,11 @@ class RenderPass;
 *    globjects::Texture  -  textures are attached via their input name
 *    globjects::Buffer   -  buffers are added as shader storage buffers
 *    uniforms of type T  -  other types are added as uniforms via their input name
+*
+*    The camera and model matrix are provided to shaders in the transform
+*    constants block (see TransformConstants and util/constants.glsl).
+*    For shaders that do not use the block, all matrices, including
+*    inverses and normal matrices, are also set as uniforms.
 */
 class GLOPERATE_API RenderPassStage : public Stage
 {
@@ -51,6 +51,7 @@ public:
     // Inputs
     Input<gl::GLenum> internalFormat;     ///< OpenGL internal image format
     Input<glm::vec4>  size;               ///< Viewport size (only z and w component is used as width and height)
+    Input<bool>       transient;          ///< Share storage with other transient render targets of the pipeline (contents are only valid within a frame)
 
     // Outputs
     Output<globjects::Renderbuffer *>        renderbuffer;        ///< Renderbuffer
@@ -2,9 +2,12 @@
 #pragma once
 
 
+#include <memory>
+
 #include <cppfs/FilePath.h>
 
 #include <cppexpose/plugin/plugin_api.h>
+#include <cppexpose/signal/ScopedConnection.h>
 
 #include <gloperate/gloperate-version.h>
 #include <gloperate/pipeline/Stage.h>
@@ -76,7 +79,8 @@ protected:
 
 
 protected:
-    std::unique_ptr<globjects::Shader> m_shader; ///< Shader object
+    std::shared_ptr<globjects::Shader> m_shader;                    ///< Shader object, shared with other stages of the context using the same file
+    cppexpose::ScopedConnection        m_resourceChangedConnection; ///< Connection to reload the shader when its file has been modified
 };
 
 
@@ -3,8 +3,11 @@
 
 
 #include <string>
+#include <memory>
+#include <future>
 
 #include <cppexpose/plugin/plugin_api.h>
+#include <cppexpose/signal/ScopedConnection.h>
 
 #include <globjects/Texture.h>
 
@@ -22,6 +25,12 @@ namespace gloperate
 /**
 *  @brief
 *    Stage that loads a texture from a file
+*
+*    The texture is loaded in the background (see ResourceManager::loadAsync()).
+*    Until it is ready, the stage keeps providing the previous texture, or a
+*    default texture if none has been loaded yet. The texture is shared with
+*    other stages of the same context that load the same file, and it is
+*    reloaded when the file has been modified.
 */
 class GLOPERATE_API TextureLoadStage : public Stage
 {
@@ -72,7 +81,9 @@ protected:
 
 
 protected:
-    std::unique_ptr<globjects::Texture> m_texture; ///< Texture
+    std::shared_ptr<globjects::Texture>              m_texture;                   ///< Texture
+    std::future<std::shared_ptr<globjects::Texture>> m_pendingTexture;            ///< Texture that is being loaded
+    cppexpose::ScopedConnection                      m_resourceChangedConnection; ///< Connection to reload the texture when its file has been modified
 };
 
 
@@ -53,6 +53,7 @@ public:
     Input<gl::GLenum> format;         ///< OpenGL image format
     Input<gl::GLenum> type;           ///< OpenGL data type
     Input<glm::vec4>  size;           ///< Viewport size (only z and w component is used as width and height)
+    Input<bool>       transient;      ///< Share storage with other transient render targets of the pipeline (contents are only valid within a frame)
 
     // Outputs
     Output<globjects::Texture *>             texture;             ///< Texture
@@ -63,6 +63,9 @@ public:
     */
     virtual ~TransformStage();
 
+    // Virtual Stage interface
+    virtual bool requiresContext() const override;
+
 
 protected:
     // Virtual Stage functions
@@ -25,6 +25,7 @@ class ColorRenderTarget;
 class DepthRenderTarget;
 class DepthStencilRenderTarget;
 class StencilRenderTarget;
+class FramebufferCache;
 
 
 /**
@@ -81,6 +82,9 @@ public:
     *
     *  @return
     *    'true', if all registered render targets are compatible using one single FBO, else 'false'
+    *
+    *  @remarks
+    *    The result is cached and only determined again if a render target has changed.
     */
     bool allRenderTargetsCompatible() const;
 
@@ -89,6 +93,10 @@ public:
     *    Get a configured framebuffer containing all render targets as attachments
     *
     *    Further, the draw buffers are updated on the framebuffer.
+    *    If a FramebufferCache is bound to the current thread, user-defined
+    *    attachments are served by a cached framebuffer for this configuration.
+    *    Otherwise, attachments and draw buffers are only updated and validated
+    *    if a render target has changed since the last call.
     *
     *  @param[in] fbo
     *    The user-defined framebuffer used for user-defined attachments
@@ -111,11 +119,13 @@ public:
     *    The next color attachment index
     *  @param[in] renderTarget
     *    The render target to attach
+    *  @param[out] attachmentChanged
+    *    Set to 'true' if the attachment of the framebuffer has been changed (can be null)
     *
     *  @return
     *    The matching framebuffer; either a user-defined FBO or an default FBO, depending on the type of the render target attachment
     */
-    globjects::Framebuffer * obtainFBO(size_t index, AbstractRenderTarget * renderTarget) const;
+    globjects::Framebuffer * obtainFBO(size_t index, AbstractRenderTarget * renderTarget, bool * attachmentChanged = nullptr) const;
 
     /**
     *  @brief
@@ -127,11 +137,30 @@ public:
     *    The render target to attach
     *  @param[in] fbo
     *    The user-defined framebuffer used for user-defined attachments
+    *  @param[in] defaultFBO
+    *    The default framebuffer used for default framebuffer attachments
+    *  @param[out] attachmentChanged
+    *    Set to 'true' if the attachment of fbo has been changed (can be null)
     *
     *  @return
     *    The matching framebuffer; either fbo or defaultFBO, depending on the type of the render target attachment
     */
-    static globjects::Framebuffer * obtainFBO(size_t index, AbstractRenderTarget * renderTarget, globjects::Framebuffer * fbo, globjects::Framebuffer * defaultFBO);
+    static globjects::Framebuffer * obtainFBO(size_t index, AbstractRenderTarget * renderTarget, globjects::Framebuffer * fbo, globjects::Framebuffer * defaultFBO, bool * attachmentChanged = nullptr);
+
+    /**
+    *  @brief
+    *    Check completeness of a framebuffer and print its status if it is incomplete
+    *
+    *    Checking the status is a synchronous query, so it is only performed
+    *    if the attachments have changed. In debug builds, the status is
+    *    checked on each call.
+    *
+    *  @param[in] fbo
+    *    Framebuffer (can be null)
+    *  @param[in] attachmentsChanged
+    *    'true' if the attachments of the framebuffer have changed since the last check, else 'false'
+    */
+    static void validateFBO(globjects::Framebuffer * fbo, bool attachmentsChanged);
 
     /**
     *  @brief
@@ -466,6 +495,41 @@ public:
 	void pairwiseStencilRenderTargetsDo(std::function<void(Input<StencilRenderTarget *> *, Output<StencilRenderTarget *> *)> callback, bool includeIncompletePairs = false);
 
 
+protected:
+    /**
+    *  @brief
+    *    Get a cached framebuffer containing all render targets as attachments
+    *
+    *  @param[in] cache
+    *    Framebuffer cache of the context
+    *
+    *  @return
+    *    Framebuffer, null if a render target cannot be attached to a user-defined framebuffer
+    */
+    globjects::Framebuffer * obtainCachedFBO(FramebufferCache * cache) const;
+
+    /**
+    *  @brief
+    *    Test if all registered render targets can be attached to a single FBO, without using the cached result
+    *
+    *  @return
+    *    'true', if all registered render targets are compatible using one single FBO, else 'false'
+    */
+    bool checkRenderTargetsCompatible() const;
+
+    /**
+    *  @brief
+    *    Update list of render target revisions
+    *
+    *  @param[in,out] revisions
+    *    Revisions of all input render targets (0 for empty inputs)
+    *
+    *  @return
+    *    'true' if a revision has changed, else 'false'
+    */
+    bool updateRevisions(std::vector<std::size_t> & revisions) const;
+
+
 public:
     /**
     *  @brief
@@ -487,6 +551,11 @@ public:
 protected:
     std::unique_ptr<globjects::Framebuffer>           m_defaultFBO;                      ///< Default FBO for configuration
     std::unique_ptr<globjects::Framebuffer>           m_fbo;                             ///< Intermediate FBO for configuration
+    mutable std::vector<std::size_t>                  m_compatibilityRevisions;          ///< Render target revisions the cached compatibility has been determined for
+    mutable bool                                      m_compatibilityValid;              ///< 'true' if the cached compatibility is up to date
+    mutable bool                                      m_compatible;                      ///< Cached result of allRenderTargetsCompatible()
+    mutable std::vector<std::size_t>                  m_fboRevisions;                    ///< Render target revisions m_configuredFBO has been configured for
+    mutable globjects::Framebuffer                  * m_configuredFBO;                   ///< Framebuffer configured by the last call of obtainFBO() (null if reconfiguration is required)
     std::vector<Input <ColorRenderTarget        *> *> m_colorRenderTargetInputs;         ///< List of input color render targets
     std::vector<Input <DepthRenderTarget        *> *> m_depthRenderTargetInputs;         ///< List of input depth render targets
     std::vector<Input <DepthStencilRenderTarget *> *> m_depthStencilRenderTargetInputs;  ///< List of input depth-stencil render targets
@@ -4,6 +4,8 @@
 
 #include <cppexpose/plugin/plugin_api.h>
 
+#include <glbinding/gl/types.h>
+
 #include <gloperate/gloperate-version.h>
 #include <gloperate/pipeline/Stage.h>
 #include <gloperate/pipeline/Output.h>
@@ -21,6 +23,7 @@ namespace gloperate
 
 
 struct Light;
+class StreamingBuffer;
 
 
 /**
@@ -85,14 +88,30 @@ protected:
     // Helper functions
     void setupBufferTextures();
 
+    /**
+    *  @brief
+    *    Attach the current region of a streaming buffer to a buffer texture
+    *
+    *  @param[in] texture
+    *    Buffer texture
+    *  @param[in] internalFormat
+    *    Internal format of the texture
+    *  @param[in] buffer
+    *    Streaming buffer that has been written
+    *  @param[in] size
+    *    Number of bytes that have been written
+    */
+    void attachRegion(globjects::Texture * texture, gl::GLenum internalFormat, StreamingBuffer * buffer, std::size_t size);
+
 
 protected:
     std::unique_ptr<globjects::Texture> m_colorTypeTexture;   ///< Buffer texture for color & type information
     std::unique_ptr<globjects::Texture> m_positionTexture;    ///< Buffer texture for position information
     std::unique_ptr<globjects::Texture> m_attenuationTexture; ///< Buffer texture for attenuation information
-    std::unique_ptr<globjects::Buffer>  m_colorTypeBuffer;    ///< Buffer for color & type information
-    std::unique_ptr<globjects::Buffer>  m_positionBuffer;     ///< Buffer for position information
-    std::unique_ptr<globjects::Buffer>  m_attenuationBuffer;  ///< Buffer for attenuation information
+    std::unique_ptr<StreamingBuffer>    m_colorTypeBuffer;    ///< Buffer for color & type information
+    std::unique_ptr<StreamingBuffer>    m_positionBuffer;     ///< Buffer for position information
+    std::unique_ptr<StreamingBuffer>    m_attenuationBuffer;  ///< Buffer for attenuation information
+    std::unique_ptr<globjects::Buffer>  m_emptyBuffer;        ///< Empty buffer, attached to the buffer textures if there are no lights
 
     std::vector< Input<Light> * > m_lightInputs; ///< Light inputs
 };
@@ -64,6 +64,9 @@ public:
     */
     virtual ~LightCreationStage();
 
+    // Virtual Stage interface
+    virtual bool requiresContext() const override;
+
 
 protected:
     // Virtual Stage interface
@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <algorithm>
+#include <cassert>
 
 #include <glm/glm.hpp>
 
@@ -15,9 +16,17 @@
 #include <cppexpose/variant/Variant.h>
 
 #include <globjects/Framebuffer.h>
+#include <globjects/NamedString.h>
+#include <globjects/base/File.h>
 
+#include <gloperate/gloperate.h>
 #include <gloperate/base/Environment.h>
+#include <gloperate/base/ResourceManager.h>
 #include <gloperate/base/ComponentManager.h>
+#include <gloperate/base/FrameProfiler.h>
+#include <gloperate/base/UploadQueue.h>
+#include <gloperate/base/ResourceCache.h>
+#include <gloperate/base/logging.h>
 #include <gloperate/pipeline/Pipeline.h>
 #include <gloperate/pipeline/Slot.h>
 #include <gloperate/input/MouseDevice.h>
@@ -27,6 +36,11 @@
 #include <gloperate/rendering/DepthStencilRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
 #include <gloperate/rendering/AttachmentType.h>
+#include <gloperate/rendering/RenderStateCache.h>
+#include <gloperate/rendering/FramebufferCache.h>
+#include <gloperate/rendering/UniformRing.h>
+#include <gloperate/rendering/FrameConstants.h>
+#include <gloperate/rendering/GeometryLibrary.h>
 #include <gloperate/stages/base/BlitStage.h>
 
 
@@ -50,15 +64,28 @@ Canvas::Canvas(Environment * environment)
 , m_openGLContext(nullptr)
 , m_initialized(false)
 , m_timeDelta(0.0f)
+, m_resourceCache(cppassist::make_unique<ResourceCache>())
 , m_blitStage(cppassist::make_unique<BlitStage>(environment, "FinalBlit"))
 , m_mouseDevice(cppassist::make_unique<MouseDevice>(m_environment->inputManager(), "mouse"))
 , m_keyboardDevice(cppassist::make_unique<KeyboardDevice>(m_environment->inputManager(), "keyboard"))
+, m_profiler(nullptr)
+, m_stateCache(cppassist::make_unique<RenderStateCache>())
+, m_framebufferCache(cppassist::make_unique<FramebufferCache>())
+, m_uniformRing(cppassist::make_unique<UniformRing>())
+, m_geometryLibrary(cppassist::make_unique<GeometryLibrary>())
+, m_uploadQueue(std::make_shared<UploadQueue>())
+, m_time(0.0f)
+, m_frameCounter(0)
 , m_replaceStage(false)
+, m_inputEvents(1024)
 , m_rendered(false)
 , m_colorTarget(cppassist::make_unique<ColorRenderTarget>())
 , m_depthTarget(cppassist::make_unique<DepthRenderTarget>())
 , m_depthStencilTarget(cppassist::make_unique<DepthStencilRenderTarget>())
 , m_stencilTarget(cppassist::make_unique<StencilRenderTarget>())
+, m_timeDeltaInput(nullptr)
+, m_viewportInput(nullptr)
+, m_viewportOutput(nullptr)
 {
     // Register functions
     addFunction("onStageInputChanged", this, &Canvas::scr_onStageInputChanged);
@@ -74,6 +101,13 @@ Canvas::Canvas(Environment * environment)
     addFunction("getSlot",             this, &Canvas::scr_getSlot);
     addFunction("getValue",            this, &Canvas::scr_getValue);
     addFunction("setValue",            this, &Canvas::scr_setValue);
+    addFunction("beginUpdate",         this, &Canvas::scr_beginUpdate);
+    addFunction("endUpdate",           this, &Canvas::scr_endUpdate);
+
+    // Add frame profiler
+    auto profiler = cppassist::make_unique<FrameProfiler>("profiler");
+    m_profiler = profiler.get();
+    addProperty(std::move(profiler));
 
     // Register canvas
     m_environment->registerCanvas(this);
@@ -105,8 +139,61 @@ Stage * Canvas::renderStage()
     return m_renderStage.get();
 }
 
+const FrameProfiler * Canvas::profiler() const
+{
+    return m_profiler;
+}
+
+FrameProfiler * Canvas::profiler()
+{
+    return m_profiler;
+}
+
+const RenderStateCache * Canvas::renderStateCache() const
+{
+    return m_stateCache.get();
+}
+
+RenderStateCache * Canvas::renderStateCache()
+{
+    return m_stateCache.get();
+}
+
+const FramebufferCache * Canvas::framebufferCache() const
+{
+    return m_framebufferCache.get();
+}
+
+FramebufferCache * Canvas::framebufferCache()
+{
+    return m_framebufferCache.get();
+}
+
+const UniformRing * Canvas::uniformRing() const
+{
+    return m_uniformRing.get();
+}
+
+UniformRing * Canvas::uniformRing()
+{
+    return m_uniformRing.get();
+}
+
+const GeometryLibrary * Canvas::geometryLibrary() const
+{
+    return m_geometryLibrary.get();
+}
+
+GeometryLibrary * Canvas::geometryLibrary()
+{
+    return m_geometryLibrary.get();
+}
+
 void Canvas::setRenderStage(std::unique_ptr<Stage> && stage)
 {
+    // Updates of the old stage end with it
+    m_scriptUpdates.clear();
+
     // Save old stage
     m_oldStage = std::move(m_renderStage);
 
@@ -116,6 +203,14 @@ void Canvas::setRenderStage(std::unique_ptr<Stage> && stage)
     // Connect to changes on the stage's input slots
     m_inputChangedConnection = m_renderStage->inputChanged.connect(this, &Canvas::stageInputChanged);
 
+    // Bind well-known slots, and rebind them if the stage's slots change
+    m_inputAddedConnection    = m_renderStage->inputAdded.connect([this] (AbstractSlot *) { bindRenderStageSlots(); });
+    m_inputRemovedConnection  = m_renderStage->inputRemoved.connect([this] (AbstractSlot *) { bindRenderStageSlots(); });
+    m_outputAddedConnection   = m_renderStage->outputAdded.connect([this] (AbstractSlot *) { bindRenderStageSlots(); });
+    m_outputRemovedConnection = m_renderStage->outputRemoved.connect([this] (AbstractSlot *) { bindRenderStageSlots(); });
+
+    bindRenderStageSlots();
+
     // Issue a redraw
     m_replaceStage = true;
     redraw();
@@ -149,7 +244,7 @@ void Canvas::setOpenGLContext(AbstractGLContext * context)
     // Deinitialize renderer in old context
     if (m_openGLContext)
     {
-        cppassist::debug(2, "gloperate") << "deinitContext()";
+        GLOPERATE_DEBUG(2) << "deinitContext()";
 
         if (m_renderStage)
         {
@@ -158,13 +253,22 @@ void Canvas::setOpenGLContext(AbstractGLContext * context)
 
         m_blitStage->deinitContext(m_openGLContext);
 
+        m_profiler->deinitContext();
+
+        m_framebufferCache->clear();
+        m_uniformRing->clear();
+        m_geometryLibrary->clear();
+        m_uploadQueue->clear();
+        m_resourceCache->clear();
+        m_constantsNamedString.reset();
+
         m_openGLContext = nullptr;
     }
 
     // Initialize renderer in new context
     if (context)
     {
-        cppassist::debug(2, "gloperate") << "initContext()";
+        GLOPERATE_DEBUG(2) << "initContext()";
 
         m_openGLContext = context;
 
@@ -175,6 +279,9 @@ void Canvas::setOpenGLContext(AbstractGLContext * context)
         }*/
         m_replaceStage = true;
 
+        // Make the declarations of the constant blocks available to the shaders of all stages
+        m_constantsNamedString = globjects::NamedString::create("/gloperate/shaders/util/constants.glsl", new globjects::File(gloperate::dataPath() + "/gloperate/shaders/util/constants.glsl"));
+
         m_blitStage->initContext(m_openGLContext);
     }
 
@@ -184,37 +291,27 @@ void Canvas::setOpenGLContext(AbstractGLContext * context)
 
 void Canvas::updateTime()
 {
-    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::updateTime");
 
     // In multithreaded viewers, updateTime() might get called several times
     // before render(). Therefore, the time delta is accumulated until the
     // pipeline is actually rendered, and then reset by the method render().
 
-    // Get number of milliseconds since last call
-    auto duration = m_clock.elapsed();
-    m_clock.reset();
-
-    // Determine time delta and virtual time
-    float timeDelta = std::chrono::duration_cast<std::chrono::duration<float>>(duration).count();
-    m_timeDelta += timeDelta;
+    // Determine time delta and pass it on to the render thread
+    InputEvent event;
+    event.type = InputEvent::Type::TimeDelta;
 
-    if (!m_renderStage)
     {
-        return;
-    }
+        // Get number of milliseconds since last call
+        std::lock_guard<std::mutex> lock(m_clockMutex);
 
-    // Update timing
-    auto slotTimeDelta = m_renderStage->findInput<float>([](Input<float>* input) { return input->name() == "timeDelta"; });
-    if (slotTimeDelta)
-    {
-        slotTimeDelta->setValue(m_timeDelta);
-    }
+        auto duration = m_clock.elapsed();
+        m_clock.reset();
 
-    // Check if a redraw is required
-    checkRedraw();
+        event.timeDelta = std::chrono::duration_cast<std::chrono::duration<float>>(duration).count();
+    }
 
-    // Promote changed input value to scripting
-    promoteChangedInputs();
+    queueInputEvent(event);
 }
 
 void Canvas::setViewport(const glm::vec4 & deviceViewport)
@@ -231,8 +328,7 @@ void Canvas::setViewport(const glm::vec4 & deviceViewport)
     }
 
     // Promote new viewport
-    auto slotViewport = m_renderStage->findInput<glm::vec4>([](Input<glm::vec4>* input) { return input->name() == "viewport"; });
-    if (slotViewport) slotViewport->setValue(m_viewport);
+    if (m_viewportInput) m_viewportInput->setValue(m_viewport);
 
     // Check if a redraw is required
     checkRedraw();
@@ -247,11 +343,39 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
 {
     std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
 
+    // Record spans of all stages processed during this frame
+    FrameProfiler::ThreadBinding profilerBinding(m_profiler, true);
+    m_profiler->beginFrame();
+
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::render");
+
+    // Skip redundant bindings of render passes, the windowing backend may have changed any binding
+    RenderStateCache::ThreadBinding stateCacheBinding(m_stateCache.get());
+    m_stateCache->invalidate();
+
+    // Serve render targets of stages from framebuffers that are configured once per attachment set
+    FramebufferCache::ThreadBinding framebufferCacheBinding(m_framebufferCache.get());
+
+    // Pack per-frame and per-object constants into one uniform buffer
+    UniformRing::ThreadBinding uniformRingBinding(m_uniformRing.get());
+
+    // Share the buffers of procedural geometry between shapes
+    GeometryLibrary::ThreadBinding geometryLibraryBinding(m_geometryLibrary.get());
+
+    // Create resources loaded in the background by stages of this canvas in its own context
+    UploadQueue::ThreadBinding uploadQueueBinding(m_uploadQueue.get());
+
+    // Share resources only between the stages of this context
+    ResourceCache::ThreadBinding resourceCacheBinding(m_resourceCache.get());
+
+    // Apply input events and time updates that arrived since the last frame
+    processInputEvents();
+
     // Reset time delta
+    const auto timeDelta = m_timeDelta;
     m_timeDelta = 0.0f;
 
-    auto fboName = targetFBO->hasName() ? targetFBO->name() : std::to_string(targetFBO->id());
-    cppassist::debug(2, "gloperate") << "render(); " << "targetFBO: " << fboName;
+    GLOPERATE_DEBUG(2) << "render(); " << "targetFBO: " << (targetFBO->hasName() ? targetFBO->name() : std::to_string(targetFBO->id()));
 
     // Abort if not initialized
     if (!m_initialized || !m_renderStage)
@@ -259,6 +383,9 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
         return;
     }
 
+    // Changes of an update a script has left open would be hidden from this frame
+    endScriptUpdates();
+
     // Check if the render stage is to be replaced
     if (m_replaceStage)
     {
@@ -276,18 +403,31 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
         m_renderStage->initContext(m_openGLContext);
 
         // Promote viewport information
-        auto slotViewport = m_renderStage->findInput<glm::vec4>([](Input<glm::vec4>* input) { return input->name() == "viewport"; });
-        if (slotViewport) slotViewport->setValue(m_viewport);
+        if (m_viewportInput) m_viewportInput->setValue(m_viewport);
 
         // Mark output as required
-        m_renderStage->forAllOutputs<ColorRenderTarget *>([](Output<ColorRenderTarget *> * output) {
+        for (auto output : m_colorTargetOutputs)
+        {
             output->setRequired(true);
-        });
+        }
 
         // Replace finished
         m_replaceStage = false;
     }
 
+    // Update frame constants once, instead of setting them as uniforms of each program
+    m_time += timeDelta;
+
+    FrameConstants frameConstants;
+    frameConstants.viewport     = m_viewport;
+    frameConstants.timeDelta    = timeDelta;
+    frameConstants.time         = m_time;
+    frameConstants.frameCounter = m_frameCounter++;
+    frameConstants.padding      = 0;
+
+    m_uniformRing->beginFrame();
+    m_uniformRing->bind(FrameConstants::binding, frameConstants);
+
     // Extract default color and depth buffer from FBO
     if (targetFBO->isDefault())
     {
@@ -342,34 +482,59 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
         }
     }
 
-    // Update render stage input render targets
-    m_renderStage->forAllInputs<gloperate::ColorRenderTarget *>([this](Input<ColorRenderTarget *> * input) {
-        input->setValue(m_colorTarget.get());
-    });
-    m_renderStage->forAllInputs<gloperate::DepthRenderTarget *>([this](Input<DepthRenderTarget *> * input) {
-        input->setValue(m_depthTarget.get());
-    });
-    m_renderStage->forAllInputs<gloperate::DepthStencilRenderTarget *>([this](Input<DepthStencilRenderTarget *> * input) {
-        input->setValue(m_depthStencilTarget.get());
-    });
-    m_renderStage->forAllInputs<gloperate::StencilRenderTarget *>([this](Input<StencilRenderTarget *> * input) {
-        input->setValue(m_stencilTarget.get());
-    });
+    // Update render stage input render targets, propagating the invalidations only once
+    {
+        Pipeline::UpdateScope update(m_renderStage->isPipeline() ? static_cast<Pipeline *>(m_renderStage.get()) : nullptr);
+
+        for (auto input : m_colorTargetInputs)
+        {
+            input->setValue(m_colorTarget.get());
+        }
+        for (auto input : m_depthTargetInputs)
+        {
+            input->setValue(m_depthTarget.get());
+        }
+        for (auto input : m_depthStencilTargetInputs)
+        {
+            input->setValue(m_depthStencilTarget.get());
+        }
+        for (auto input : m_stencilTargetInputs)
+        {
+            input->setValue(m_stencilTarget.get());
+        }
+    }
+
+    // Let stages reload resources whose files have been modified, in this context and with the canvas locked
+    m_resourceCache->processChanges();
+
+    // Create resources that finished loading in the background, so stages can pick them up in this frame
+    {
+        FrameProfiler::Scope uploadScope(m_profiler, "Canvas::processUploads");
+
+        m_uploadQueue->process();
+
+        // Loaders create textures, which may have bound them
+        m_stateCache->invalidateTextures();
+    }
+
+    // Collect available time measurements, also of stages that are not processed in this frame
+    m_renderStage->pollTimeMeasurements();
+
+    // Deferred invalidations must have been propagated before the stages are processed
+    assert(!m_renderStage->isPipeline() || !static_cast<Pipeline *>(m_renderStage.get())->isUpdating());
 
     // Render
     m_renderStage->process();
 
-    auto colorOutput = m_renderStage->findOutput<gloperate::ColorRenderTarget *>([this](Output<ColorRenderTarget *> * output) {
+    const auto colorOutputIt = std::find_if(m_colorTargetOutputs.begin(), m_colorTargetOutputs.end(), [](Output<ColorRenderTarget *> * output) {
         return **output != nullptr;
     });
 
     // Check if a blit pass is necessary
-    if (colorOutput)
+    if (colorOutputIt != m_colorTargetOutputs.end())
     {
-        // Get viewport
-        const auto viewport = m_renderStage->findOutput<glm::vec4>([this](Output<glm::vec4> *) {
-            return true;
-        });
+        const auto colorOutput = *colorOutputIt;
+        const auto viewport    = m_viewportOutput;
 
         // Check if either viewport or color output target are different than the input
         const auto viewportDiffering = viewport && glm::distance(**viewport, m_viewport) > glm::epsilon<float>();
@@ -378,6 +543,8 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
         // If so, blit color output to target
         if (viewportDiffering || colorOutputDiffering)
         {
+            FrameProfiler::Scope blitScope(m_profiler, "Canvas::blit");
+
             m_blitStage->source = **colorOutput;
             m_blitStage->sourceViewport = viewport ? **viewport : m_viewport;
             m_blitStage->target = m_colorTarget.get();
@@ -392,80 +559,172 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
 
 void Canvas::promoteKeyPress(int key, int modifier)
 {
-    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::promoteKeyPress");
 
-    cppassist::debug(2, "gloperate") << "keyPressed(" << key << ", " << modifier << ")";
+    GLOPERATE_DEBUG(2) << "keyPressed(" << key << ", " << modifier << ")";
 
     // Promote keyboard event
-    m_keyboardDevice->keyPress(key, modifier);
+    InputEvent event;
+    event.type     = InputEvent::Type::KeyPress;
+    event.key      = key;
+    event.modifier = modifier;
 
-    // Check if a redraw is required
-    checkRedraw();
+    queueInputEvent(event);
 }
 
 void Canvas::promoteKeyRelease(int key, int modifier)
 {
-    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::promoteKeyRelease");
 
-    cppassist::debug(2, "gloperate") << "keyReleased(" << key << ", " << modifier << ")";
+    GLOPERATE_DEBUG(2) << "keyReleased(" << key << ", " << modifier << ")";
 
     // Promote keyboard event
-    m_keyboardDevice->keyRelease(key, modifier);
+    InputEvent event;
+    event.type     = InputEvent::Type::KeyRelease;
+    event.key      = key;
+    event.modifier = modifier;
 
-    // Check if a redraw is required
-    checkRedraw();
+    queueInputEvent(event);
 }
 
 void Canvas::promoteMouseMove(const glm::ivec2 & pos, int modifier)
 {
-    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::promoteMouseMove");
 
-    cppassist::debug(2, "gloperate") << "mouseMoved(" << pos.x << ", " << pos.y << ")";
+    GLOPERATE_DEBUG(2) << "mouseMoved(" << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
-    m_mouseDevice->move(pos, modifier);
+    InputEvent event;
+    event.type     = InputEvent::Type::MouseMove;
+    event.modifier = modifier;
+    event.pos      = pos;
 
-    // Check if a redraw is required
-    checkRedraw();
+    queueInputEvent(event);
 }
 
 void Canvas::promoteMousePress(int button, const glm::ivec2 & pos, int modifier)
 {
-    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::promoteMousePress");
 
-    cppassist::debug(2, "gloperate") << "mousePressed(" << button << ", " << pos.x << ", " << pos.y << ")";
+    GLOPERATE_DEBUG(2) << "mousePressed(" << button << ", " << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
-    m_mouseDevice->buttonPress(button, pos, modifier);
+    InputEvent event;
+    event.type     = InputEvent::Type::MousePress;
+    event.key      = button;
+    event.modifier = modifier;
+    event.pos      = pos;
 
-    // Check if a redraw is required
-    checkRedraw();
+    queueInputEvent(event);
 }
 
 void Canvas::promoteMouseRelease(int button, const glm::ivec2 & pos, int modifier)
 {
-    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::promoteMouseRelease");
 
-    cppassist::debug(2, "gloperate") << "mouseReleased(" << button << ", " << pos.x << ", " << pos.y << ")";
+    GLOPERATE_DEBUG(2) << "mouseReleased(" << button << ", " << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
-    m_mouseDevice->buttonRelease(button, pos, modifier);
+    InputEvent event;
+    event.type     = InputEvent::Type::MouseRelease;
+    event.key      = button;
+    event.modifier = modifier;
+    event.pos      = pos;
 
-    // Check if a redraw is required
-    checkRedraw();
+    queueInputEvent(event);
 }
 
 void Canvas::promoteMouseWheel(const glm::vec2 & delta, const glm::ivec2 & pos, int modifier)
 {
-    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+    FrameProfiler::Scope profilerScope(m_profiler, "Canvas::promoteMouseWheel");
 
-    cppassist::debug(2, "gloperate") << "mouseWheel(" << delta.x << ", " << delta.y << ", " << pos.x << ", " << pos.y << ")";
+    GLOPERATE_DEBUG(2) << "mouseWheel(" << delta.x << ", " << delta.y << ", " << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
-    m_mouseDevice->wheelScroll(delta, pos, modifier);
+    InputEvent event;
+    event.type     = InputEvent::Type::MouseWheel;
+    event.modifier = modifier;
+    event.pos      = pos;
+    event.delta    = delta;
+
+    queueInputEvent(event);
+}
+
+void Canvas::queueInputEvent(const InputEvent & event)
+{
+    // Only wait for the render thread if the queue is full
+    // (other producers may fill it again before this one gets its turn)
+    while (!m_inputEvents.push(event))
+    {
+        std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+
+        processInputEvents();
+    }
+
+    // Apply events right away if the render thread is idle
+    std::unique_lock<std::recursive_mutex> lock(this->m_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        // Events are applied at the start of the next frame
+        redraw();
+        return;
+    }
+
+    processInputEvents();
 
     // Check if a redraw is required
     checkRedraw();
+
+    // Promote changed input value to scripting
+    promoteChangedInputs();
+}
+
+void Canvas::processInputEvents()
+{
+    auto timeChanged = false;
+
+    InputEvent event;
+    while (m_inputEvents.pop(event))
+    {
+        switch (event.type)
+        {
+        case InputEvent::Type::KeyPress:
+            m_keyboardDevice->keyPress(event.key, event.modifier);
+            break;
+
+        case InputEvent::Type::KeyRelease:
+            m_keyboardDevice->keyRelease(event.key, event.modifier);
+            break;
+
+        case InputEvent::Type::MouseMove:
+            m_mouseDevice->move(event.pos, event.modifier);
+            break;
+
+        case InputEvent::Type::MousePress:
+            m_mouseDevice->buttonPress(event.key, event.pos, event.modifier);
+            break;
+
+        case InputEvent::Type::MouseRelease:
+            m_mouseDevice->buttonRelease(event.key, event.pos, event.modifier);
+            break;
+
+        case InputEvent::Type::MouseWheel:
+            m_mouseDevice->wheelScroll(event.delta, event.pos, event.modifier);
+            break;
+
+        case InputEvent::Type::TimeDelta:
+            // The time delta is accumulated until the pipeline is rendered
+            m_timeDelta += event.timeDelta;
+            timeChanged = true;
+            break;
+        }
+    }
+
+    // Update timing once for all time updates
+    if (timeChanged && m_timeDeltaInput)
+    {
+        m_timeDeltaInput->setValue(m_timeDelta);
+    }
 }
 
 void Canvas::checkRedraw()
@@ -492,13 +751,23 @@ void Canvas::checkRedraw()
         return;
     }
 
+    // Only mark resources of modified files, they are reloaded on the render thread
+    m_resourceCache->checkModifiedFiles();
+
     bool redraw = false;
-    m_renderStage->forAllOutputs<ColorRenderTarget *>([& redraw](Output<ColorRenderTarget *> * output) {
+    for (auto output : m_colorTargetOutputs)
+    {
         if (**output && !output->isValid())
         {
             redraw = true;
         }
-    });
+    }
+
+    // Resources loaded in the background are created, and modified resources reloaded, during rendering
+    if (!m_uploadQueue->empty() || m_resourceCache->hasChanges())
+    {
+        redraw = true;
+    }
 
     if (redraw)
     {
@@ -506,6 +775,43 @@ void Canvas::checkRedraw()
     }
 }
 
+void Canvas::bindRenderStageSlots()
+{
+    m_timeDeltaInput = nullptr;
+    m_viewportInput  = nullptr;
+    m_viewportOutput = nullptr;
+    m_colorTargetInputs.clear();
+    m_depthTargetInputs.clear();
+    m_depthStencilTargetInputs.clear();
+    m_stencilTargetInputs.clear();
+    m_colorTargetOutputs.clear();
+
+    if (!m_renderStage)
+    {
+        return;
+    }
+
+    m_timeDeltaInput = m_renderStage->findInput<float>([](Input<float> * input) { return input->name() == "timeDelta"; });
+    m_viewportInput  = m_renderStage->findInput<glm::vec4>([](Input<glm::vec4> * input) { return input->name() == "viewport"; });
+    m_viewportOutput = m_renderStage->findOutput<glm::vec4>([](Output<glm::vec4> *) { return true; });
+
+    m_renderStage->forAllInputs<ColorRenderTarget *>([this](Input<ColorRenderTarget *> * input) {
+        m_colorTargetInputs.push_back(input);
+    });
+    m_renderStage->forAllInputs<DepthRenderTarget *>([this](Input<DepthRenderTarget *> * input) {
+        m_depthTargetInputs.push_back(input);
+    });
+    m_renderStage->forAllInputs<DepthStencilRenderTarget *>([this](Input<DepthStencilRenderTarget *> * input) {
+        m_depthStencilTargetInputs.push_back(input);
+    });
+    m_renderStage->forAllInputs<StencilRenderTarget *>([this](Input<StencilRenderTarget *> * input) {
+        m_stencilTargetInputs.push_back(input);
+    });
+    m_renderStage->forAllOutputs<ColorRenderTarget *>([this](Output<ColorRenderTarget *> * output) {
+        m_colorTargetOutputs.push_back(output);
+    });
+}
+
 void Canvas::promoteChangedInputs()
 {
     std::lock_guard<std::mutex> lock(this->m_changedInputMutex);
@@ -842,6 +1148,66 @@ void Canvas::scr_setValue(const std::string & path, const std::string & slotName
     }
 }
 
+void Canvas::scr_beginUpdate(const std::string & path)
+{
+    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+
+    Stage * stage = getStageObject(path);
+    if (stage && stage->isPipeline())
+    {
+        static_cast<Pipeline *>(stage)->beginUpdate();
+
+        // Remember update, so it can be ended if the script does not end it
+        m_scriptUpdates.push_back(path);
+    }
+}
+
+void Canvas::scr_endUpdate(const std::string & path)
+{
+    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+
+    // Only end updates the script has begun
+    const auto it = std::find(m_scriptUpdates.rbegin(), m_scriptUpdates.rend(), path);
+    if (it == m_scriptUpdates.rend())
+    {
+        cppassist::warning("gloperate") << path << ": endUpdate() without matching beginUpdate()";
+        return;
+    }
+
+    m_scriptUpdates.erase(std::next(it).base());
+
+    Stage * stage = getStageObject(path);
+    if (stage && stage->isPipeline())
+    {
+        static_cast<Pipeline *>(stage)->endUpdate();
+    }
+}
+
+std::unique_lock<std::recursive_mutex> Canvas::lock()
+{
+    return std::unique_lock<std::recursive_mutex>(m_mutex);
+}
+
+void Canvas::endScriptUpdates()
+{
+    std::lock_guard<std::recursive_mutex> lock(this->m_mutex);
+
+    // End innermost updates first
+    while (!m_scriptUpdates.empty())
+    {
+        const auto path = m_scriptUpdates.back();
+        m_scriptUpdates.pop_back();
+
+        cppassist::warning("gloperate") << path << ": update has not been ended by the script, ending it now";
+
+        Stage * stage = getStageObject(path);
+        if (stage && stage->isPipeline())
+        {
+            static_cast<Pipeline *>(stage)->endUpdate();
+        }
+    }
+}
+
 Stage * Canvas::getStageObject(const std::string & path) const
 {
     // Begin with empty stage
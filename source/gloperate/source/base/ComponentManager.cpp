@@ -15,6 +15,7 @@ namespace gloperate
 
 ComponentManager::ComponentManager()
 : cppexpose::Object("components")
+, m_revision(0)
 {
     // Register functions
     addFunction("getPluginPaths",   this, &ComponentManager::scr_getPluginPaths);
@@ -38,6 +39,13 @@ void ComponentManager::scanPlugins()
     #else
         cppexpose::ComponentManager::scanPlugins("-plugins");
     #endif
+
+    ++m_revision;
+}
+
+unsigned int ComponentManager::revision() const
+{
+    return m_revision;
 }
 
 std::string ComponentManager::scr_getPluginPaths()
@@ -2,6 +2,7 @@
 #include <gloperate/base/Environment.h>
 
 #include <algorithm>
+#include <mutex>
 
 #include <cppassist/memory/make_unique.h>
 #include <cppassist/logging/logging.h>
@@ -22,6 +23,7 @@ Environment::Environment()
 , m_system(this)
 , m_inputManager(this)
 , m_timerManager(this)
+, m_threadPool()
 , m_scriptContext(nullptr)
 , m_safeMode(false)
 {
@@ -76,6 +78,16 @@ TimerManager * Environment::timerManager()
     return &m_timerManager;
 }
 
+const ThreadPool * Environment::threadPool() const
+{
+    return &m_threadPool;
+}
+
+ThreadPool * Environment::threadPool()
+{
+    return &m_threadPool;
+}
+
 const std::vector<Canvas *> & Environment::canvases() const
 {
     return m_canvases;
@@ -127,8 +139,23 @@ cppexpose::Variant Environment::executeScript(const std::string & code)
         cmd = "gloperate.system.exit()";
     }
 
+    // Do not render while the script is executed, it may group changes into pipeline updates
+    std::vector<std::unique_lock<std::recursive_mutex>> locks;
+    for (auto canvas : m_canvases)
+    {
+        locks.push_back(canvas->lock());
+    }
+
     // Execute command
-    return m_scriptContext->evaluate(cmd);
+    const auto result = m_scriptContext->evaluate(cmd);
+
+    // Updates must not outlive the script that has begun them
+    for (auto canvas : m_canvases)
+    {
+        canvas->endScriptUpdates();
+    }
+
+    return result;
 }
 
 void Environment::exit(int exitCode)
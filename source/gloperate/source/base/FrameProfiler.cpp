@@ -0,0 +1,419 @@
+
+#include <gloperate/base/FrameProfiler.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+#include <cppassist/logging/logging.h>
+
+#include <glbinding/gl/gl.h>
+
+
+namespace
+{
+
+
+thread_local gloperate::FrameProfiler * t_profiler = nullptr; ///< Profiler bound to the current thread
+thread_local bool t_contextThread = false;                   ///< 'true' if the OpenGL context of the bound profiler is current
+
+
+std::uint32_t currentThreadId()
+{
+    // Small, stable IDs are easier to read in trace viewers than native thread IDs.
+    // ID 0 is reserved for GPU spans.
+    static std::atomic<std::uint32_t> s_nextThreadId(1);
+    thread_local const std::uint32_t id = s_nextThreadId++;
+
+    return id;
+}
+
+bool enabledByEnvironment()
+{
+    const auto value = std::getenv("GLOPERATE_PROFILE");
+
+    return value && *value != '\0' && std::strcmp(value, "0") != 0;
+}
+
+void copyName(char * target, std::size_t size, const char * name)
+{
+    std::strncpy(target, name, size - 1);
+    target[size - 1] = '\0';
+}
+
+void writeEscaped(std::ostream & stream, const char * str)
+{
+    for (; *str; ++str)
+    {
+        const auto c = *str;
+
+        if (c == '"' || c == '\\')
+        {
+            stream << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            stream << ' ';
+        }
+        else
+        {
+            stream << c;
+        }
+    }
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+const std::size_t FrameProfiler::s_numEvents = 16384;
+const std::size_t FrameProfiler::s_maxNumQueries = 1024;
+
+
+FrameProfiler::ThreadBinding::ThreadBinding(FrameProfiler * profiler, bool contextThread)
+: m_previousProfiler(t_profiler)
+, m_previousContextThread(t_contextThread)
+{
+    t_profiler      = profiler;
+    t_contextThread = contextThread;
+}
+
+FrameProfiler::ThreadBinding::~ThreadBinding()
+{
+    t_profiler      = m_previousProfiler;
+    t_contextThread = m_previousContextThread;
+}
+
+
+FrameProfiler::Scope::Scope(FrameProfiler * profiler, const char * name)
+: m_profiler(profiler && profiler->enabled() ? profiler : nullptr)
+, m_name(name)
+, m_gpuSpan(-1)
+{
+    if (!m_profiler)
+    {
+        return;
+    }
+
+    // GPU spans can only be measured on the thread of the profiler's context
+    if (t_profiler == m_profiler && t_contextThread)
+    {
+        m_gpuSpan = m_profiler->beginGPUSpan(m_name);
+    }
+
+    m_begin = clock::now();
+}
+
+FrameProfiler::Scope::~Scope()
+{
+    if (!m_profiler)
+    {
+        return;
+    }
+
+    const auto end = clock::now();
+
+    if (m_gpuSpan >= 0)
+    {
+        m_profiler->endGPUSpan(m_gpuSpan);
+    }
+
+    m_profiler->addSpan(m_name, m_begin, end);
+}
+
+
+FrameProfiler * FrameProfiler::current()
+{
+    return t_profiler && t_profiler->enabled() ? t_profiler : nullptr;
+}
+
+FrameProfiler::FrameProfiler(const std::string & name)
+: cppexpose::Object(name)
+, m_epoch(clock::now())
+, m_enabled(enabledByEnvironment())
+, m_events(new Event[s_numEvents]())
+, m_writeIndex(0)
+, m_numQueries(0)
+, m_gpuOffset(0)
+{
+    // Register functions
+    addFunction("dump",       this, &FrameProfiler::scr_dump);
+    addFunction("enabled",    this, &FrameProfiler::scr_enabled);
+    addFunction("setEnabled", this, &FrameProfiler::scr_setEnabled);
+}
+
+FrameProfiler::~FrameProfiler()
+{
+}
+
+bool FrameProfiler::enabled() const
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+void FrameProfiler::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void FrameProfiler::addSpan(const char * name, const time_point & begin, const time_point & end)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    record(name, toNanoseconds(begin), toNanoseconds(end), currentThreadId());
+}
+
+void FrameProfiler::beginFrame()
+{
+    // Nothing to collect or calibrate while disabled
+    if (!enabled() && m_pendingSpans.empty())
+    {
+        return;
+    }
+
+    // Collect GPU spans in order, stop at the first one the GPU has not finished yet
+    while (!m_pendingSpans.empty())
+    {
+        const auto & span = m_pendingSpans.front();
+
+        gl::GLint available = 0;
+        gl::glGetQueryObjectiv(span.endQuery, gl::GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available)
+        {
+            break;
+        }
+
+        gl::GLuint64 gpu_start, gpu_end;
+        gl::glGetQueryObjectui64v(span.startQuery, gl::GL_QUERY_RESULT, &gpu_start);
+        gl::glGetQueryObjectui64v(span.endQuery, gl::GL_QUERY_RESULT, &gpu_end);
+
+        if (enabled())
+        {
+            record(span.name,
+                   static_cast<std::int64_t>(gpu_start) + span.offset,
+                   static_cast<std::int64_t>(gpu_end) + span.offset,
+                   0);
+        }
+
+        m_freeQueries.push_back(span.startQuery);
+        m_freeQueries.push_back(span.endQuery);
+        m_pendingSpans.pop_front();
+    }
+
+    if (!enabled())
+    {
+        return;
+    }
+
+    // Calibrate GPU clock against the CPU clock, as both clocks may drift
+    gl::GLint64 gpuTime = 0;
+    gl::glGetInteger64v(gl::GL_TIMESTAMP, &gpuTime);
+
+    m_gpuOffset = toNanoseconds(clock::now()) - static_cast<std::int64_t>(gpuTime);
+}
+
+void FrameProfiler::deinitContext()
+{
+    for (const auto & span : m_pendingSpans)
+    {
+        m_freeQueries.push_back(span.startQuery);
+        m_freeQueries.push_back(span.endQuery);
+    }
+
+    for (const auto & span : m_openSpans)
+    {
+        m_freeQueries.push_back(span.startQuery);
+        m_freeQueries.push_back(span.endQuery);
+    }
+
+    if (!m_freeQueries.empty())
+    {
+        gl::glDeleteQueries(static_cast<gl::GLsizei>(m_freeQueries.size()), m_freeQueries.data());
+    }
+
+    m_freeQueries.clear();
+    m_openSpans.clear();
+    m_pendingSpans.clear();
+    m_numQueries = 0;
+}
+
+bool FrameProfiler::dump(const std::string & filename) const
+{
+    struct Span
+    {
+        std::string   name;
+        std::int64_t  begin;
+        std::int64_t  end;
+        std::uint32_t thread;
+    };
+
+    std::vector<Span> spans;
+
+    // Copy all records that are not overwritten while reading them
+    const auto writeIndex = m_writeIndex.load(std::memory_order_acquire);
+    const auto firstIndex = writeIndex > s_numEvents ? writeIndex - s_numEvents : 0;
+
+    spans.reserve(static_cast<std::size_t>(writeIndex - firstIndex));
+
+    for (auto index = firstIndex; index < writeIndex; ++index)
+    {
+        const auto & event = m_events[index % s_numEvents];
+
+        const auto sequence = event.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2)
+        {
+            continue;
+        }
+
+        Span span;
+        char name[sizeof(event.name)];
+        std::memcpy(name, event.name, sizeof(name));
+        span.begin  = event.begin;
+        span.end    = event.end;
+        span.thread = event.thread;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            continue;
+        }
+
+        name[sizeof(name) - 1] = '\0';
+        span.name = name;
+
+        spans.push_back(std::move(span));
+    }
+
+    std::sort(spans.begin(), spans.end(), [] (const Span & a, const Span & b)
+    {
+        return a.begin < b.begin;
+    });
+
+    std::ofstream stream(filename, std::ios::out | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        cppassist::error("gloperate") << "Could not write profile to '" << filename << "'";
+        return false;
+    }
+
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"traceEvents\":[" << std::endl;
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+
+    for (const auto & span : spans)
+    {
+        stream << "," << std::endl << "{\"name\":\"";
+        writeEscaped(stream, span.name.c_str());
+        stream << "\",\"cat\":\"" << (span.thread == 0 ? "gpu" : "cpu") << "\""
+               << ",\"ph\":\"X\""
+               << ",\"ts\":"  << span.begin / 1000.0
+               << ",\"dur\":" << (span.end - span.begin) / 1000.0
+               << ",\"pid\":1,\"tid\":" << span.thread << "}";
+    }
+
+    stream << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+    return stream.good();
+}
+
+int FrameProfiler::beginGPUSpan(const char * name)
+{
+    // Create queries on demand, but limit the number of queries in flight
+    if (m_freeQueries.size() < 2)
+    {
+        if (m_numQueries + 2 > s_maxNumQueries)
+        {
+            return -1;
+        }
+
+        gl::GLuint queries[2];
+        gl::glGenQueries(2, queries);
+
+        m_freeQueries.push_back(queries[0]);
+        m_freeQueries.push_back(queries[1]);
+        m_numQueries += 2;
+    }
+
+    GPUSpan span;
+    copyName(span.name, sizeof(span.name), name);
+    span.endQuery = m_freeQueries.back();
+    m_freeQueries.pop_back();
+    span.startQuery = m_freeQueries.back();
+    m_freeQueries.pop_back();
+    span.offset = m_gpuOffset;
+
+    gl::glQueryCounter(span.startQuery, gl::GL_TIMESTAMP);
+
+    m_openSpans.push_back(std::move(span));
+
+    return static_cast<int>(m_openSpans.size()) - 1;
+}
+
+void FrameProfiler::endGPUSpan(int handle)
+{
+    // Scopes are strictly nested on the context thread
+    assert(handle == static_cast<int>(m_openSpans.size()) - 1);
+
+    if (handle < 0 || handle >= static_cast<int>(m_openSpans.size()))
+    {
+        return;
+    }
+
+    auto & span = m_openSpans.back();
+
+    gl::glQueryCounter(span.endQuery, gl::GL_TIMESTAMP);
+
+    m_pendingSpans.push_back(std::move(span));
+    m_openSpans.pop_back();
+}
+
+void FrameProfiler::record(const char * name, std::int64_t begin, std::int64_t end, std::uint32_t thread)
+{
+    // Claim record; an odd sequence number marks it as being written
+    const auto index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    auto & event = m_events[index % s_numEvents];
+
+    event.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    copyName(event.name, sizeof(event.name), name);
+    event.begin  = begin;
+    event.end    = end;
+    event.thread = thread;
+
+    event.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::int64_t FrameProfiler::toNanoseconds(const time_point & time) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_epoch).count();
+}
+
+bool FrameProfiler::scr_dump(const std::string & filename)
+{
+    return dump(filename);
+}
+
+bool FrameProfiler::scr_enabled()
+{
+    return enabled();
+}
+
+void FrameProfiler::scr_setEnabled(bool enabled)
+{
+    setEnabled(enabled);
+}
+
+
+} // namespace gloperate
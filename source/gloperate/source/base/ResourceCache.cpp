@@ -0,0 +1,192 @@
+
+#include <gloperate/base/ResourceCache.h>
+
+#include <algorithm>
+
+#include <cppfs/fs.h>
+#include <cppfs/FileHandle.h>
+
+#include <cppexpose/variant/Variant.h>
+#include <cppexpose/json/JSON.h>
+
+#include <gloperate/base/ResourceManager.h>
+
+
+namespace
+{
+
+
+thread_local gloperate::ResourceCache * t_cache = nullptr; ///< Cache bound to the current thread
+
+const std::chrono::milliseconds s_checkInterval(500); ///< Minimum time between checks for modified files
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+ResourceCache::ThreadBinding::ThreadBinding(ResourceCache * cache)
+: m_previousCache(t_cache)
+{
+    t_cache = cache;
+}
+
+ResourceCache::ThreadBinding::~ThreadBinding()
+{
+    t_cache = m_previousCache;
+}
+
+
+ResourceCache * ResourceCache::current()
+{
+    return t_cache;
+}
+
+ResourceCache::ResourceCache()
+: m_modified(false)
+{
+}
+
+ResourceCache::~ResourceCache()
+{
+}
+
+std::shared_ptr<void> ResourceCache::find(const std::string & filename, const cppexpose::Variant & options, std::type_index type) const
+{
+    const auto path = ResourceManager::canonicalPath(filename);
+    const auto serializedOptions = cppexpose::JSON::stringify(options);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto & entry : m_entries)
+    {
+        // Resources of modified files are not handed out anymore
+        if (entry.path == path && entry.type == type && entry.options == serializedOptions && !entry.modified)
+        {
+            // Resource may have expired
+            return entry.resource.lock();
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<void> ResourceCache::add(const std::string & filename, const cppexpose::Variant & options, std::type_index type, std::shared_ptr<void> resource)
+{
+    const auto path = ResourceManager::canonicalPath(filename);
+    const auto serializedOptions = cppexpose::JSON::stringify(options);
+    const auto modificationTime = cppfs::fs::open(path).modificationTime();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto & entry : m_entries)
+    {
+        if (entry.path == path && entry.type == type && entry.options == serializedOptions && !entry.modified)
+        {
+            // Prefer a resource that has been loaded meanwhile, so it is not duplicated
+            if (auto cached = entry.resource.lock())
+            {
+                return cached;
+            }
+
+            entry.modificationTime = modificationTime;
+            entry.resource         = resource;
+
+            return resource;
+        }
+    }
+
+    m_entries.push_back(Entry{ path, serializedOptions, type, modificationTime, false, resource });
+
+    return resource;
+}
+
+void ResourceCache::checkModifiedFiles()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Limit the number of file system accesses
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastCheck < s_checkInterval)
+    {
+        return;
+    }
+
+    m_lastCheck = now;
+
+    // Drop resources that are no longer used
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [] (const Entry & entry)
+    {
+        return entry.resource.expired();
+    }), m_entries.end());
+
+    // Mark resources of modified files, they are dropped on the render thread
+    for (auto & entry : m_entries)
+    {
+        if (!entry.modified && cppfs::fs::open(entry.path).modificationTime() != entry.modificationTime)
+        {
+            entry.modified = true;
+            m_modified     = true;
+        }
+    }
+}
+
+bool ResourceCache::hasChanges() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_modified;
+}
+
+void ResourceCache::processChanges()
+{
+    std::vector<std::string> modifiedFiles;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_modified)
+        {
+            return;
+        }
+
+        m_modified = false;
+
+        // Drop resources of modified files, so they are loaded again
+        for (auto it = m_entries.begin(); it != m_entries.end(); )
+        {
+            if (!it->modified)
+            {
+                ++it;
+                continue;
+            }
+
+            if (std::find(modifiedFiles.begin(), modifiedFiles.end(), it->path) == modifiedFiles.end())
+            {
+                modifiedFiles.push_back(it->path);
+            }
+
+            it = m_entries.erase(it);
+        }
+    }
+
+    // Inform users of the resources, which may reload them right away
+    for (const auto & path : modifiedFiles)
+    {
+        resourceChanged(path);
+    }
+}
+
+void ResourceCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_entries.clear();
+    m_modified = false;
+}
+
+
+} // namespace gloperate
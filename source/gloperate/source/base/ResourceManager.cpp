@@ -2,26 +2,84 @@
 #include <gloperate/base/ResourceManager.h>
 
 #include <algorithm>
+#include <sstream>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <cppfs/FilePath.h>
 
 #include <cppexpose/plugin/ComponentManager.h>
 
 #include <gloperate/base/Environment.h>
+#include <gloperate/base/ComponentManager.h>
 #include <gloperate/base/Loader.h>
 #include <gloperate/base/Storer.h>
+#include <gloperate/base/ThreadPool.h>
+
+
+namespace
+{
+
+
+std::string fileExtension(const std::string & filename)
+{
+    // Get file extension without dot
+    std::string ext = cppfs::FilePath(filename).extension();
+    auto pos = ext.find_last_of('.');
+    if (pos != std::string::npos)
+    {
+        ext = ext.substr(pos + 1);
+    }
+
+    return ext;
+}
+
+std::vector<std::string> declaredExtensions(const std::string & types)
+{
+    // Split file types (e.g., "*.png *.jpg") into extensions without dot
+    std::vector<std::string> extensions;
+
+    std::istringstream stream(types);
+    std::string type;
+    while (stream >> type)
+    {
+        const auto pos = type.find_last_of('.');
+        if (pos != std::string::npos && pos + 1 < type.size())
+        {
+            extensions.push_back(type.substr(pos + 1));
+        }
+    }
+
+    return extensions;
+}
+
+
+} // namespace
 
 
 namespace gloperate
 {
 
 
+std::string ResourceManager::canonicalPath(const std::string & filename)
+{
+    return cppfs::FilePath(filename).resolved();
+}
+
 ResourceManager::ResourceManager(Environment * environment)
 : cppexpose::Object("resources")
 , m_environment(environment)
+, m_indexed(false)
+, m_indexedRevision(0)
+, m_ioThreadPool(cppassist::make_unique<ThreadPool>(2))
 {
 }
 
 ResourceManager::~ResourceManager()
 {
+    // Finish reading before the loaders are destroyed
+    m_ioThreadPool = nullptr;
+
     clearComponents();
 }
 
@@ -50,30 +108,124 @@ std::vector<AbstractStorer *> ResourceManager::storers() const
 
 void ResourceManager::updateComponents() const
 {
-    // Release previous components
-    clearComponents();
-
-    // Get available loader components
+    // Create loaders of new components
     auto loaders = m_environment->componentManager()->components<AbstractLoader>();
     for (auto component : loaders) {
+        if (std::find(m_loaderComponents.begin(), m_loaderComponents.end(), component) != m_loaderComponents.end()) {
+            continue;
+        }
+
         // Create loader
         auto loader = component->createInstance(m_environment);
         m_loaders.push_back(std::move(loader));
+        m_loaderComponents.push_back(component);
     }
 
-    // Get available storer components
+    // Create storers of new components
     auto storers = m_environment->componentManager()->components<AbstractStorer>();
     for (auto component : storers) {
+        if (std::find(m_storerComponents.begin(), m_storerComponents.end(), component) != m_storerComponents.end()) {
+            continue;
+        }
+
         // Create storer
         auto storer = component->createInstance(m_environment);
         m_storers.push_back(std::move(storer));
+        m_storerComponents.push_back(component);
+    }
+
+    // Index declared file types, the first loader or storer of a file type takes precedence
+    m_loaderIndex.clear();
+    for (const auto & loader : m_loaders) {
+        auto & index = m_loaderIndex[loader->resourceType()];
+        for (const auto & ext : declaredExtensions(loader->allLoadingTypes())) {
+            index.insert(std::make_pair(ext, loader.get()));
+        }
     }
+
+    m_storerIndex.clear();
+    for (const auto & storer : m_storers) {
+        auto & index = m_storerIndex[storer->resourceType()];
+        for (const auto & ext : declaredExtensions(storer->allStoringTypes())) {
+            index.insert(std::make_pair(ext, storer.get()));
+        }
+    }
+
+    m_indexed         = true;
+    m_indexedRevision = m_environment->componentManager()->revision();
 }
 
 void ResourceManager::clearComponents() const
 {
+    m_loaderIndex.clear();
+    m_storerIndex.clear();
+    m_loaderComponents.clear();
+    m_storerComponents.clear();
     m_loaders.clear();
     m_storers.clear();
+    m_indexed = false;
+}
+
+AbstractLoader * ResourceManager::findLoader(const std::string & filename, std::type_index type) const
+{
+    std::lock_guard<std::mutex> lock(m_componentMutex);
+
+    // Lazy (re-)indexing of loaders
+    if (!m_indexed || m_indexedRevision != m_environment->componentManager()->revision()) {
+        updateComponents();
+    }
+
+    const auto ext = fileExtension(filename);
+
+    // Look up index
+    auto & index = m_loaderIndex[type];
+    const auto it = index.find(ext);
+    if (it != index.end()) {
+        return it->second;
+    }
+
+    // Ask loaders about file types they have not declared, and remember the answer
+    AbstractLoader * found = nullptr;
+    for (const auto & loader : m_loaders) {
+        if (loader->resourceType() == type && loader->canLoad(ext)) {
+            found = loader.get();
+            break;
+        }
+    }
+
+    index[ext] = found;
+    return found;
+}
+
+AbstractStorer * ResourceManager::findStorer(const std::string & filename, std::type_index type) const
+{
+    std::lock_guard<std::mutex> lock(m_componentMutex);
+
+    // Lazy (re-)indexing of storers
+    if (!m_indexed || m_indexedRevision != m_environment->componentManager()->revision()) {
+        updateComponents();
+    }
+
+    const auto ext = fileExtension(filename);
+
+    // Look up index
+    auto & index = m_storerIndex[type];
+    const auto it = index.find(ext);
+    if (it != index.end()) {
+        return it->second;
+    }
+
+    // Ask storers about file types they have not declared, and remember the answer
+    AbstractStorer * found = nullptr;
+    for (const auto & storer : m_storers) {
+        if (storer->resourceType() == type && storer->canStore(ext)) {
+            found = storer.get();
+            break;
+        }
+    }
+
+    index[ext] = found;
+    return found;
 }
 
 
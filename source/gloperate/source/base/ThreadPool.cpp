@@ -0,0 +1,149 @@
+
+#include <gloperate/base/ThreadPool.h>
+
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
+
+
+namespace gloperate
+{
+
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+: m_numThreads(numThreads)
+, m_pendingTasks(0)
+, m_nextQueue(0)
+, m_running(true)
+{
+    if (m_numThreads == 0)
+    {
+        m_numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    for (unsigned int i = 0; i < m_numThreads; ++i)
+    {
+        m_queues.push_back(cppassist::make_unique<TaskQueue>());
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+
+    m_condition.notify_all();
+
+    for (auto & thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+unsigned int ThreadPool::numThreads() const
+{
+    return m_numThreads;
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    std::call_once(m_started, [this] () { start(); });
+
+    std::packaged_task<void()> packagedTask(std::move(task));
+    auto future = packagedTask.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto & queue = *m_queues[m_nextQueue];
+        m_nextQueue = (m_nextQueue + 1) % m_queues.size();
+
+        {
+            std::lock_guard<std::mutex> queueLock(queue.mutex);
+            queue.tasks.push_back(std::move(packagedTask));
+        }
+
+        ++m_pendingTasks;
+    }
+
+    m_condition.notify_one();
+
+    return future;
+}
+
+void ThreadPool::start()
+{
+    for (unsigned int i = 0; i < m_numThreads; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+void ThreadPool::run(unsigned int index)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this] () {
+                return m_pendingTasks > 0 || !m_running;
+            });
+
+            // Exit only after all submitted tasks have been executed
+            if (m_pendingTasks == 0 && !m_running)
+            {
+                return;
+            }
+        }
+
+        std::packaged_task<void()> task;
+        if (takeTask(index, task))
+        {
+            task();
+        }
+    }
+}
+
+bool ThreadPool::takeTask(unsigned int index, std::packaged_task<void()> & task)
+{
+    // Take most recent task from own queue
+    {
+        auto & queue = *m_queues[index];
+        std::lock_guard<std::mutex> queueLock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+
+    // Steal oldest task from the other queues
+    for (unsigned int i = 1; !task.valid() && i < m_numThreads; ++i)
+    {
+        auto & queue = *m_queues[(index + i) % m_numThreads];
+        std::lock_guard<std::mutex> queueLock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (!task.valid())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    --m_pendingTasks;
+
+    return true;
+}
+
+
+} // namespace gloperate
@@ -5,6 +5,10 @@
 
 #include <cppassist/memory/make_unique.h>
 
+#include <gloperate/base/Environment.h>
+#include <gloperate/base/Canvas.h>
+#include <gloperate/base/FrameProfiler.h>
+
 
 // [TODO] Implement garbage collection of stopped scripting timers.
 //
@@ -42,7 +46,17 @@ void TimerManager::update()
 
     float delta = std::chrono::duration_cast<std::chrono::duration<float>>(duration).count();
 
+    const auto begin = FrameProfiler::clock::now();
+
     update(delta);
+
+    // Timer callbacks affect all canvases, so the span is recorded for each of them
+    const auto end = FrameProfiler::clock::now();
+
+    for (auto canvas : m_environment->canvases())
+    {
+        canvas->profiler()->addSpan("TimerManager::update", begin, end);
+    }
 }
 
 void TimerManager::update(float delta)
@@ -0,0 +1,113 @@
+
+#include <gloperate/base/UploadQueue.h>
+
+
+namespace
+{
+
+
+thread_local gloperate::UploadQueue * t_queue = nullptr; ///< Queue bound to the current thread
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+UploadQueue::ThreadBinding::ThreadBinding(UploadQueue * queue)
+: m_previousQueue(t_queue)
+{
+    t_queue = queue;
+}
+
+UploadQueue::ThreadBinding::~ThreadBinding()
+{
+    t_queue = m_previousQueue;
+}
+
+
+UploadQueue * UploadQueue::current()
+{
+    return t_queue;
+}
+
+UploadQueue::UploadQueue()
+{
+}
+
+UploadQueue::~UploadQueue()
+{
+}
+
+void UploadQueue::push(std::function<void()> upload)
+{
+    pushSteps([upload] ()
+    {
+        upload();
+        return true;
+    });
+}
+
+void UploadQueue::pushSteps(std::function<bool()> step)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_uploads.push_back(std::move(step));
+}
+
+void UploadQueue::process(std::chrono::microseconds budget)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    do
+    {
+        // Take next resource creation
+        std::function<bool()> upload;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_uploads.empty())
+            {
+                return;
+            }
+
+            upload = std::move(m_uploads.front());
+            m_uploads.pop_front();
+        }
+
+        // Create resource, or perform next step of its creation
+        if (!upload())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_uploads.push_front(std::move(upload));
+        }
+    }
+    while (std::chrono::steady_clock::now() - start < budget);
+}
+
+bool UploadQueue::empty() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_uploads.empty();
+}
+
+void UploadQueue::clear()
+{
+    std::deque<std::function<bool()>> uploads;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uploads.swap(m_uploads);
+    }
+
+    // Destroy resource creations outside of the lock, they own the promises of their loads
+}
+
+
+} // namespace gloperate
@@ -2,22 +2,132 @@
 #include <gloperate/loaders/GlrawTextureLoader.h>
 
 #include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <numeric>
 
-#include <cppfs/FilePath.h>
+#include <cppassist/memory/make_unique.h>
 
-#include <cppassist/fs/readfile.h>
-#include <cppassist/fs/RawFile.h>
-#include <cppassist/fs/DescriptiveRawFile.h>
+#include <cppfs/FilePath.h>
 
 #include <cppexpose/variant/Variant.h>
 
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
 
+#include <globjects/Buffer.h>
 #include <globjects/Texture.h>
 
 #include <gloperate/loaders/RawFileNameSuffix.h>
 
 
+namespace
+{
+
+
+const std::uint16_t s_magicNumber    = 0xC4F3;          ///< Magic number of .glraw files
+const std::uint8_t  s_intProperty    = 1;               ///< Type of integer properties in .glraw files
+const std::uint8_t  s_doubleProperty = 2;               ///< Type of double properties in .glraw files
+const std::uint8_t  s_stringProperty = 3;               ///< Type of string properties in .glraw files
+const std::size_t   s_chunkSize      = 4 * 1024 * 1024; ///< Number of bytes uploaded at once
+
+
+template <typename T>
+T readValue(std::istream & stream)
+{
+    T value = T();
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return value;
+}
+
+std::string readString(std::istream & stream)
+{
+    std::string string;
+    std::getline(stream, string, '\0');
+    return string;
+}
+
+int levelExtent(int extent, int level)
+{
+    return std::max(extent >> level, 1);
+}
+
+std::size_t componentCount(gl::GLenum format)
+{
+    switch (format)
+    {
+    case gl::GL_RG:
+    case gl::GL_RG_INTEGER:
+        return 2;
+
+    case gl::GL_RGB:
+    case gl::GL_BGR:
+    case gl::GL_RGB_INTEGER:
+    case gl::GL_BGR_INTEGER:
+        return 3;
+
+    case gl::GL_RGBA:
+    case gl::GL_BGRA:
+    case gl::GL_RGBA_INTEGER:
+    case gl::GL_BGRA_INTEGER:
+        return 4;
+
+    default:
+        return 1;
+    }
+}
+
+std::size_t levelSize(gl::GLenum format, gl::GLenum type, int width, int height, int depth)
+{
+    std::size_t pixelSize = 0;
+
+    switch (type)
+    {
+    case gl::GL_UNSIGNED_BYTE:
+    case gl::GL_BYTE:
+        pixelSize = componentCount(format);
+        break;
+
+    case gl::GL_UNSIGNED_SHORT:
+    case gl::GL_SHORT:
+    case gl::GL_HALF_FLOAT:
+        pixelSize = 2 * componentCount(format);
+        break;
+
+    case gl::GL_UNSIGNED_INT:
+    case gl::GL_INT:
+    case gl::GL_FLOAT:
+        pixelSize = 4 * componentCount(format);
+        break;
+
+    // Packed types store all components of a pixel in one value
+    case gl::GL_UNSIGNED_BYTE_3_3_2:
+    case gl::GL_UNSIGNED_BYTE_2_3_3_REV:
+        pixelSize = 1;
+        break;
+
+    case gl::GL_UNSIGNED_SHORT_5_6_5:
+    case gl::GL_UNSIGNED_SHORT_5_6_5_REV:
+    case gl::GL_UNSIGNED_SHORT_4_4_4_4:
+    case gl::GL_UNSIGNED_SHORT_4_4_4_4_REV:
+    case gl::GL_UNSIGNED_SHORT_5_5_5_1:
+    case gl::GL_UNSIGNED_SHORT_1_5_5_5_REV:
+        pixelSize = 2;
+        break;
+
+    default:
+        pixelSize = 4;
+        break;
+    }
+
+    return pixelSize * static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * static_cast<std::size_t>(depth);
+}
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
@@ -64,108 +174,380 @@ std::string GlrawTextureLoader::allLoadingTypes() const
     return allTypes;
 }
 
-globjects::Texture * GlrawTextureLoader::load(const std::string & filename, const cppexpose::Variant &, std::function<void(int, int)>) const
+globjects::Texture * GlrawTextureLoader::load(const std::string & filename, const cppexpose::Variant &, std::function<void(int, int)> progress) const
 {
-    globjects::Texture * texture = nullptr;
+    ImageDescription image;
+
+    if (!describeImage(filename, image))
+        return nullptr;
+
+    return createTexture(filename, image, progress);
+}
+
+std::function<bool (globjects::Texture * &)> GlrawTextureLoader::read(const std::string & filename, const cppexpose::Variant &, std::function<void(int, int)> progress) const
+{
+    // State of the upload, shared by the copies of the returned function
+    struct Upload
+    {
+        ImageDescription                    image;
+        std::vector<Chunk>                  chunks;
+        std::vector<char>                   data;
+        std::size_t                         nextChunk    = 0;
+        std::size_t                         uploadedSize = 0;
+        std::unique_ptr<globjects::Texture> texture;
+        std::unique_ptr<globjects::Buffer>  unpackBuffer;
+    };
+
+    auto upload = std::make_shared<Upload>();
+
+    if (!describeImage(filename, upload->image))
+        return nullptr;
+
+    upload->chunks = splitImage(upload->image);
 
+    // Read image data on the I/O thread, so only the uploads are left to the context thread
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file)
+        return nullptr;
+
+    const auto totalSize = std::accumulate(upload->image.levelSizes.begin(), upload->image.levelSizes.end(), std::size_t(0));
+
+    upload->data.resize(totalSize);
+
+    file.seekg(static_cast<std::streamoff>(upload->image.offset));
+    file.read(upload->data.data(), static_cast<std::streamsize>(totalSize));
+
+    if (!file.good())
+        return nullptr;
+
+    // Upload one chunk per call, so the upload queue spreads them over frames
+    return [this, upload, progress, totalSize] (globjects::Texture * & texture)
+    {
+        if (!upload->texture)
+        {
+            const auto maxChunk = std::max_element(upload->chunks.begin(), upload->chunks.end(), [] (const Chunk & a, const Chunk & b)
+            {
+                return a.size < b.size;
+            });
+
+            upload->texture.reset(allocateTexture(upload->image));
+            upload->unpackBuffer = cppassist::make_unique<globjects::Buffer>();
+            upload->unpackBuffer->setData(static_cast<gl::GLsizeiptr>(maxChunk->size), nullptr, gl::GL_STREAM_DRAW);
+        }
+
+        const auto & chunk = upload->chunks[upload->nextChunk];
+        const auto   data  = upload->data.data() + upload->uploadedSize;
+
+        const auto success = uploadChunk(upload->texture.get(), upload->image, chunk, *upload->unpackBuffer, [data, &chunk] (char * mapped)
+        {
+            std::copy(data, data + chunk.size, mapped);
+            return true;
+        });
+
+        if (!success)
+        {
+            texture = nullptr;
+            return true;
+        }
+
+        ++upload->nextChunk;
+        upload->uploadedSize += chunk.size;
+
+        if (progress)
+        {
+            progress(static_cast<int>(upload->uploadedSize / 1024), static_cast<int>(totalSize / 1024));
+        }
+
+        if (upload->nextChunk < upload->chunks.size())
+        {
+            return false;
+        }
+
+        texture = upload->texture.release();
+        return true;
+    };
+}
+
+bool GlrawTextureLoader::describeImage(const std::string & filename, ImageDescription & image) const
+{
     cppfs::FilePath filePath(filename);
     if (filePath.extension() == ".glraw")
-        texture = loadGLRawImage(filename);
+        return readGLRawHeader(filename, image);
     else if (filePath.extension() == ".raw")
-        texture = loadRawImage(filename);
+        return describeRawImage(filename, image);
 
-    return texture;
+    return false;
+}
+
+bool GlrawTextureLoader::describeRawImage(const std::string & filename, ImageDescription & image) const
+{
+    RawFileNameSuffix suffix(filename);
+
+    if (!suffix.isValid())
+        return false;
+
+    // Determine file size
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    const auto fileSize = static_cast<std::size_t>(file.tellg());
+
+    image.target           = gl::GL_TEXTURE_2D;
+    image.width            = suffix.width();
+    image.height           = suffix.height();
+    image.depth            = 1;
+    image.format           = suffix.format();
+    image.type             = suffix.type();
+    image.compressedFormat = suffix.compressed() ? gl::GL_RGBA8 : gl::GL_NONE;
+    image.offset           = 0;
+    image.levelSizes.push_back(suffix.compressed() ? fileSize : levelSize(image.format, image.type, image.width, image.height, 1));
+
+    return true;
 }
 
-globjects::Texture * GlrawTextureLoader::loadGLRawImage(const std::string & filename) const
+bool GlrawTextureLoader::readGLRawHeader(const std::string & filename, ImageDescription & image) const
 {
-    cppassist::DescriptiveRawFile rawFile;
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file)
+        return false;
 
-    if (!rawFile.load(filename))
-        return nullptr;
+    // Read properties
+    if (readValue<std::uint16_t>(file) != s_magicNumber)
+        return false;
 
-    const int w = rawFile.intProperty("width");
-    const int h = rawFile.intProperty("height");
+    const auto offset = readValue<std::uint64_t>(file);
 
-    globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
+    std::map<std::string, int> intProperties;
 
-    if (rawFile.hasIntProperty("format"))
+    while (file.good() && static_cast<std::uint64_t>(file.tellg()) < offset)
     {
-        auto format = static_cast<gl::GLenum>(rawFile.intProperty("format"));
-        auto type = static_cast<gl::GLenum>(rawFile.intProperty("type"));
-
-        texture->image2D(
-            0,
-            gl::GL_RGBA8,
-            w,
-            h,
-            0,
-            format,
-            type,
-            rawFile.data()
-        );
+        const auto type = readValue<std::uint8_t>(file);
+        const auto key  = readString(file);
+
+        switch (type)
+        {
+        case s_intProperty:
+            intProperties[key] = readValue<std::int32_t>(file);
+            break;
+
+        case s_doubleProperty:
+            readValue<double>(file);
+            break;
+
+        case s_stringProperty:
+            readString(file);
+            break;
+
+        default:
+            return false;
+        }
     }
-    else
+
+    if (!file.good())
+        return false;
+
+    const auto property = [&intProperties] (const std::string & key, int defaultValue)
     {
-        auto compressedFormat = static_cast<gl::GLenum>(rawFile.intProperty("compressedFormat"));
-        auto size = rawFile.intProperty("size");
-
-        texture->compressedImage2D(
-            0,
-            compressedFormat,
-            w,
-            h,
-            0,
-            size,
-            rawFile.data()
-        );
+        const auto it = intProperties.find(key);
+        return it != intProperties.end() ? it->second : defaultValue;
+    };
+
+    // Describe image data
+    const auto depth  = property("depth", 0);
+    const auto layers = property("layers", 0);
+    const auto levels = std::max(property("levels", 1), 1);
+
+    image.target           = depth > 0 ? gl::GL_TEXTURE_3D : (layers > 0 ? gl::GL_TEXTURE_2D_ARRAY : gl::GL_TEXTURE_2D);
+    image.width            = property("width", 0);
+    image.height           = property("height", 0);
+    image.depth            = std::max(std::max(depth, layers), 1);
+    image.format           = static_cast<gl::GLenum>(property("format", 0));
+    image.type             = static_cast<gl::GLenum>(property("type", 0));
+    image.compressedFormat = intProperties.count("format") ? gl::GL_NONE : static_cast<gl::GLenum>(property("compressedFormat", 0));
+    image.offset           = offset;
+
+    if (image.width <= 0 || image.height <= 0)
+        return false;
+
+    for (int level = 0; level < levels; ++level)
+    {
+        if (image.compressedFormat == gl::GL_NONE)
+        {
+            const auto width  = levelExtent(image.width, level);
+            const auto height = levelExtent(image.height, level);
+            const auto depth  = image.target == gl::GL_TEXTURE_3D ? levelExtent(image.depth, level) : image.depth;
+
+            image.levelSizes.push_back(levelSize(image.format, image.type, width, height, depth));
+            continue;
+        }
+
+        // Compressed mipmap levels must be listed explicitly
+        const auto size = property(level == 0 ? "size" : "size" + std::to_string(level), 0);
+        if (size <= 0)
+            break;
+
+        image.levelSizes.push_back(static_cast<std::size_t>(size));
+    }
+
+    return !image.levelSizes.empty();
+}
+
+std::vector<GlrawTextureLoader::Chunk> GlrawTextureLoader::splitImage(const ImageDescription & image) const
+{
+    std::vector<Chunk> chunks;
+
+    for (int level = 0; level < static_cast<int>(image.levelSizes.size()); ++level)
+    {
+        const auto height = levelExtent(image.height, level);
+        const auto depth  = image.target == gl::GL_TEXTURE_3D ? levelExtent(image.depth, level) : image.depth;
+        const auto size   = image.levelSizes[level];
+
+        // Compressed levels are uploaded at once
+        if (image.compressedFormat != gl::GL_NONE)
+        {
+            chunks.push_back(Chunk{ level, 0, 0, height, depth, size });
+            continue;
+        }
+
+        // Upload whole slices per chunk, or rows of a slice if a slice exceeds the chunk size
+        const auto rowSize        = size / static_cast<std::size_t>(height * depth);
+        const auto sliceSize      = rowSize * static_cast<std::size_t>(height);
+        const auto slicesPerChunk = sliceSize <= s_chunkSize ? static_cast<int>(s_chunkSize / sliceSize) : 1;
+        const auto rowsPerChunk   = sliceSize <= s_chunkSize ? height : static_cast<int>(std::max(s_chunkSize / rowSize, std::size_t(1)));
+
+        for (int z = 0; z < depth; z += slicesPerChunk)
+        {
+            const auto slices = std::min(slicesPerChunk, depth - z);
+
+            for (int y = 0; y < height; y += rowsPerChunk)
+            {
+                const auto rows = std::min(rowsPerChunk, height - y);
+
+                chunks.push_back(Chunk{ level, y, z, rows, slices, rowSize * static_cast<std::size_t>(rows * slices) });
+            }
+        }
+    }
+
+    return chunks;
+}
+
+globjects::Texture * GlrawTextureLoader::allocateTexture(const ImageDescription & image) const
+{
+    globjects::Texture * texture = globjects::Texture::createDefault(image.target).release();
+
+    const auto levels = static_cast<int>(image.levelSizes.size());
+    if (levels > 1)
+    {
+        texture->setParameter(gl::GL_TEXTURE_MIN_FILTER, gl::GL_LINEAR_MIPMAP_LINEAR);
+        texture->setParameter(gl::GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+
+    // Compressed levels are allocated by their upload
+    if (image.compressedFormat != gl::GL_NONE)
+        return texture;
+
+    for (int level = 0; level < levels; ++level)
+    {
+        const auto width  = levelExtent(image.width, level);
+        const auto height = levelExtent(image.height, level);
+        const auto depth  = image.target == gl::GL_TEXTURE_3D ? levelExtent(image.depth, level) : image.depth;
+
+        if (image.target == gl::GL_TEXTURE_2D)
+            texture->image2D(level, gl::GL_RGBA8, width, height, 0, image.format, image.type, nullptr);
+        else
+            texture->image3D(level, gl::GL_RGBA8, width, height, depth, 0, image.format, image.type, nullptr);
     }
 
     return texture;
 }
 
-globjects::Texture * GlrawTextureLoader::loadRawImage(const std::string & filename) const
+bool GlrawTextureLoader::uploadChunk(globjects::Texture * texture, const ImageDescription & image, const Chunk & chunk, globjects::Buffer & unpackBuffer, const std::function<bool (char *)> & fill) const
 {
-    RawFileNameSuffix suffix(filename);
+    // Data is written directly into the unpack buffer
+    auto data = unpackBuffer.mapRange(0, static_cast<gl::GLsizeiptr>(chunk.size), gl::GL_MAP_WRITE_BIT | gl::GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!data)
+        return false;
 
-    if (!suffix.isValid())
-        return nullptr;
+    const auto filled = fill(static_cast<char *>(data));
 
-    //read file
-    cppassist::RawFile rawFile;
-    if (!rawFile.load(filename))
-        return nullptr;
+    if (!unpackBuffer.unmap() || !filled)
+        return false;
+
+    const auto width = levelExtent(image.width, chunk.level);
+
+    // Image data is tightly packed
+    gl::GLint unpackAlignment = 4;
+    gl::glGetIntegerv(gl::GL_UNPACK_ALIGNMENT, &unpackAlignment);
+    gl::glPixelStorei(gl::GL_UNPACK_ALIGNMENT, 1);
 
-    globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
+    unpackBuffer.bind(gl::GL_PIXEL_UNPACK_BUFFER);
 
-    if (!suffix.compressed())
+    if (image.compressedFormat != gl::GL_NONE)
     {
-        texture->image2D(
-            0,
-            gl::GL_RGBA8,
-            suffix.width(),
-            suffix.height(),
-            0,
-            suffix.format(),
-            suffix.type(),
-            rawFile.data()
-        );
+        if (image.target == gl::GL_TEXTURE_2D)
+            texture->compressedImage2D(chunk.level, image.compressedFormat, width, chunk.rows, 0, static_cast<gl::GLsizei>(chunk.size), nullptr);
+        else
+            texture->compressedImage3D(chunk.level, image.compressedFormat, width, chunk.rows, chunk.slices, 0, static_cast<gl::GLsizei>(chunk.size), nullptr);
     }
     else
     {
-        texture->compressedImage2D(
-            0,
-            gl::GL_RGBA8,
-            suffix.width(),
-            suffix.height(),
-            0,
-            rawFile.size(),
-            rawFile.data()
-        );
+        if (image.target == gl::GL_TEXTURE_2D)
+            texture->subImage2D(chunk.level, 0, chunk.y, width, chunk.rows, image.format, image.type, nullptr);
+        else
+            texture->subImage3D(chunk.level, 0, chunk.y, chunk.z, width, chunk.rows, chunk.slices, image.format, image.type, nullptr);
     }
 
-    return texture;
+    globjects::Buffer::unbind(gl::GL_PIXEL_UNPACK_BUFFER);
+
+    gl::glPixelStorei(gl::GL_UNPACK_ALIGNMENT, unpackAlignment);
+
+    return true;
 }
 
+globjects::Texture * GlrawTextureLoader::createTexture(const std::string & filename, const ImageDescription & image, std::function<void(int, int)> progress) const
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file)
+        return nullptr;
+
+    file.seekg(static_cast<std::streamoff>(image.offset));
+
+    const auto chunks    = splitImage(image);
+    const auto totalSize = std::accumulate(image.levelSizes.begin(), image.levelSizes.end(), std::size_t(0));
+    const auto maxChunk  = std::max_element(chunks.begin(), chunks.end(), [] (const Chunk & a, const Chunk & b)
+    {
+        return a.size < b.size;
+    });
+
+    std::unique_ptr<globjects::Texture> texture(allocateTexture(image));
+
+    // Data is read from the file directly into the unpack buffer
+    globjects::Buffer unpackBuffer;
+    unpackBuffer.setData(static_cast<gl::GLsizeiptr>(maxChunk->size), nullptr, gl::GL_STREAM_DRAW);
+
+    auto uploadedSize = std::size_t(0);
+
+    for (const auto & chunk : chunks)
+    {
+        const auto success = uploadChunk(texture.get(), image, chunk, unpackBuffer, [&file, &chunk] (char * data)
+        {
+            file.read(data, static_cast<std::streamsize>(chunk.size));
+            return file.good();
+        });
+
+        if (!success)
+            return nullptr;
+
+        uploadedSize += chunk.size;
+
+        if (progress)
+        {
+            progress(static_cast<int>(uploadedSize / 1024), static_cast<int>(totalSize / 1024));
+        }
+    }
+
+    return texture.release();
+}
 
 } // namespace gloperate
@@ -2,15 +2,113 @@
 #include <gloperate/pipeline/AbstractSlot.h>
 
 #include <sstream>
+#include <atomic>
 
+#include <gloperate/base/logging.h>
 #include <gloperate/pipeline/Stage.h>
 #include <gloperate/pipeline/Pipeline.h>
 
 
+namespace
+{
+
+
+std::recursive_mutex       s_propagationMutex;            ///< Mutex for serializing change propagation
+std::atomic<int>           s_concurrentStages { 0 };      ///< Number of stages that are currently processed concurrently
+std::atomic<std::uint64_t> s_nextInvalidationToken { 1 }; ///< Token of the next invalidation wave
+
+thread_local std::uint64_t t_invalidationToken = 0;       ///< Token of the wave that is propagated on the current thread
+thread_local std::size_t   t_invalidationDepth = 0;       ///< Number of nested waves on the current thread
+
+thread_local std::vector<std::function<void()>> * t_deferredNotifications = nullptr; ///< Notifications deferred on the current thread (can be null)
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
 
+AbstractSlot::InvalidationWave::InvalidationWave()
+{
+    if (t_invalidationDepth++ == 0)
+    {
+        t_invalidationToken = s_nextInvalidationToken.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_token = t_invalidationToken;
+}
+
+AbstractSlot::InvalidationWave::~InvalidationWave()
+{
+    --t_invalidationDepth;
+}
+
+std::uint64_t AbstractSlot::InvalidationWave::token() const
+{
+    return m_token;
+}
+
+AbstractSlot::DeferredNotifications::DeferredNotifications(std::vector<std::function<void()>> * notifications)
+: m_previousNotifications(t_deferredNotifications)
+{
+    t_deferredNotifications = notifications;
+}
+
+AbstractSlot::DeferredNotifications::~DeferredNotifications()
+{
+    t_deferredNotifications = m_previousNotifications;
+}
+
+void AbstractSlot::DeferredNotifications::flush(std::vector<std::function<void()>> & notifications)
+{
+    // Notifications may cause further changes, so the list is emptied first
+    auto queued = std::move(notifications);
+    notifications.clear();
+
+    for (auto & notification : queued)
+    {
+        notification();
+    }
+}
+
+std::unique_lock<std::recursive_mutex> AbstractSlot::lockPropagation()
+{
+    // Stages are only processed concurrently between begin- and endConcurrentProcessing(),
+    // which are both called by the processing thread. Therefore, a count of zero seen by
+    // any thread means that the stages it can reach are not processed on another thread.
+    if (s_concurrentStages.load() == 0)
+    {
+        return std::unique_lock<std::recursive_mutex>(s_propagationMutex, std::defer_lock);
+    }
+
+    return std::unique_lock<std::recursive_mutex>(s_propagationMutex);
+}
+
+void AbstractSlot::beginConcurrentProcessing()
+{
+    ++s_concurrentStages;
+}
+
+void AbstractSlot::endConcurrentProcessing()
+{
+    --s_concurrentStages;
+}
+
+bool AbstractSlot::deferNotification(std::function<void()> && notification)
+{
+    if (!t_deferredNotifications)
+    {
+        return false;
+    }
+
+    t_deferredNotifications->push_back(std::move(notification));
+
+    return true;
+}
+
+
 AbstractSlot::AbstractSlot()
 : m_slotType(SlotType::Unknown)
 , m_dynamic(false)
@@ -50,11 +148,16 @@ Stage * AbstractSlot::parentStage() const
     return static_cast<Stage *>(parent());
 }
 
-std::string AbstractSlot::qualifiedName() const
+const std::string & AbstractSlot::qualifiedName() const
 {
-    Stage * stage = parentStage();
+    return m_qualifiedName;
+}
 
-    return (stage != nullptr) ? stage->qualifiedName() + "." + name() : name();
+void AbstractSlot::updateQualifiedName()
+{
+    const auto stage = parentStage();
+
+    m_qualifiedName = stage ? stage->qualifiedName() + "." + name() : name();
 }
 
 bool AbstractSlot::isDynamic() const
@@ -69,6 +172,8 @@ bool AbstractSlot::isRequired() const
 
 void AbstractSlot::setRequired(bool required)
 {
+    auto lock = AbstractSlot::lockPropagation();
+
     if (m_required == required)
     {
         return;
@@ -76,7 +181,7 @@ void AbstractSlot::setRequired(bool required)
 
     m_required = required;
 
-    cppassist::debug(3, "gloperate") << this->qualifiedName() << ": required changed to " << required;
+    GLOPERATE_DEBUG(3) << this->qualifiedName() << ": required changed to " << required;
 
     onRequiredChanged();
 }
@@ -100,6 +205,9 @@ void AbstractSlot::initSlot(SlotType slotType, Stage * parent)
 {
     m_slotType = slotType;
 
+    // Slots that are added to a stage get their qualified name from it
+    m_qualifiedName = name();
+
     if (parent)
     {
         if (m_slotType == SlotType::Input)
@@ -2,30 +2,91 @@
 #include <gloperate/pipeline/Pipeline.h>
 
 #include <iostream>
+#include <exception>
 #include <vector>
-#include <set>
+#include <deque>
+#include <algorithm>
+#include <unordered_set>
 
 #include <cppassist/logging/logging.h>
+#include <cppassist/memory/make_unique.h>
 #include <cppassist/string/manipulation.h>
 
 #include <cppexpose/variant/Variant.h>
 
+#include <globjects/Texture.h>
+#include <globjects/Renderbuffer.h>
+
 #include <gloperate/base/Environment.h>
 #include <gloperate/base/ComponentManager.h>
+#include <gloperate/base/FrameProfiler.h>
+#include <gloperate/base/logging.h>
 #include <gloperate/pipeline/Input.h>
 #include <gloperate/pipeline/Output.h>
+#include <gloperate/rendering/ColorRenderTarget.h>
+#include <gloperate/rendering/DepthRenderTarget.h>
+#include <gloperate/rendering/DepthStencilRenderTarget.h>
+#include <gloperate/rendering/StencilRenderTarget.h>
+#include <gloperate/rendering/RenderTargetPool.h>
+
+
+namespace
+{
+
+
+bool carriesRenderTarget(const gloperate::AbstractSlot * slot)
+{
+    return dynamic_cast<const gloperate::Slot<gloperate::ColorRenderTarget *> *>(slot)
+        || dynamic_cast<const gloperate::Slot<gloperate::DepthRenderTarget *> *>(slot)
+        || dynamic_cast<const gloperate::Slot<gloperate::DepthStencilRenderTarget *> *>(slot)
+        || dynamic_cast<const gloperate::Slot<gloperate::StencilRenderTarget *> *>(slot)
+        || dynamic_cast<const gloperate::Slot<globjects::Texture *> *>(slot)
+        || dynamic_cast<const gloperate::Slot<globjects::Renderbuffer *> *>(slot);
+}
+
+
+// Ends the concurrent processing of a stage when its task is left, also by an exception
+class ConcurrentProcessingGuard
+{
+public:
+    ~ConcurrentProcessingGuard()
+    {
+        gloperate::AbstractSlot::endConcurrentProcessing();
+    }
+};
+
+
+} // namespace
 
 
 namespace gloperate
 {
 
 
-// [TODO] invalidate sorting when stages or connections change
+Pipeline::UpdateScope::UpdateScope(Pipeline * pipeline)
+: m_pipeline(pipeline)
+{
+    if (m_pipeline)
+    {
+        m_pipeline->beginUpdate();
+    }
+}
+
+Pipeline::UpdateScope::~UpdateScope()
+{
+    if (m_pipeline)
+    {
+        m_pipeline->endUpdate();
+    }
+}
 
 
 Pipeline::Pipeline(Environment * environment, const std::string & className, const std::string & name)
 : Stage(environment, className, name)
 , m_sorted(false)
+, m_lifetimesValid(false)
+, m_renderTargetPool(cppassist::make_unique<RenderTargetPool>())
+, m_updateDepth(0)
 {
 }
 
@@ -92,7 +153,9 @@ void Pipeline::registerStage(Stage * stage)
         m_stagesMap.insert(std::make_pair(stage->name(), stage));
     }
 
-    cppassist::debug(1, "gloperate") << stage->qualifiedName() << ": add to pipeline";
+    stage->updateQualifiedName();
+
+    GLOPERATE_DEBUG(1) << stage->qualifiedName() << ": add to pipeline";
 
     // Shouldn't be required if each slot of a stage would disconnect from connections
     // and this would be propagated to the normal stage order invalidation
@@ -118,100 +181,536 @@ bool Pipeline::removeStage(Stage * stage)
     m_stages.erase(it);
     m_stagesMap.erase(stage->name());
 
-    cppassist::debug(1, "gloperate") << stage->qualifiedName() << ": remove from pipeline";
+    m_renderTargetPool->removeClient(stage);
+
+    GLOPERATE_DEBUG(1) << stage->qualifiedName() << ": remove from pipeline";
 
     stageRemoved(stage);
 
     removeProperty(stage);
 
-    // [TODO]
-    // Shouldn't be required if each slot of a stage would disconnect from connections
-    // and this would be propagated to the normal stage order invalidation
-    invalidateStageOrder();
+    // Removing a stage keeps the remaining stages in topological order,
+    // only the execution plan has to be updated
+    updateExecutionPlan();
 
     return true;
 }
 
 void Pipeline::invalidateStageOrder()
 {
-    cppassist::debug(1, "gloperate") << this->name() << ": invalidate stage order; resort on next process";
+    GLOPERATE_DEBUG(1) << this->name() << ": invalidate stage order; resort on next process";
     m_sorted = false;
 }
 
+void Pipeline::updateStageOrder(Stage * stage)
+{
+    assert(stage);
+
+    if (!m_sorted)
+    {
+        return;
+    }
+
+    // Stage has changed its input connections, so it needs to be checked again
+    stage->markDirty();
+
+    const auto stageIt = m_stageIndices.find(stage);
+    if (stageIt == m_stageIndices.end())
+    {
+        // Not a stage of this pipeline (e.g., the pipeline itself)
+        return;
+    }
+
+    // Check if all direct dependencies are still executed before the stage
+    for (auto input : stage->inputs())
+    {
+        const auto source = sourceStage(input);
+        if (source && source != stage && m_stageIndices.at(source) > stageIt->second)
+        {
+            invalidateStageOrder();
+            return;
+        }
+    }
+
+    // Order is still valid, only update the dependencies of the stage
+    updateStageDependencies(stageIt->second);
+
+    // Render targets may be read by other stages now
+    m_lifetimesValid = false;
+}
+
+void Pipeline::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+void Pipeline::endUpdate()
+{
+    if (m_updateDepth == 0)
+    {
+        cppassist::warning("gloperate") << this->qualifiedName() << ": endUpdate() without matching beginUpdate()";
+        return;
+    }
+
+    --m_updateDepth;
+
+    // Parent pipelines that are still being updated propagate the invalidations later
+    if (!isUpdating())
+    {
+        GLOPERATE_DEBUG(3) << this->qualifiedName() << ": propagate deferred invalidations";
+
+        propagateDeferredInvalidations();
+    }
+}
+
+bool Pipeline::isUpdating() const
+{
+    for (auto pipeline = this; pipeline; pipeline = pipeline->parentPipeline())
+    {
+        if (pipeline->m_updateDepth > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+RenderTargetPool * Pipeline::renderTargetPool() const
+{
+    return m_renderTargetPool.get();
+}
+
 bool Pipeline::isPipeline() const
 {
     return true;
 }
 
+void Pipeline::pollTimeMeasurements()
+{
+    Stage::pollTimeMeasurements();
+
+    for (auto stage : m_stages)
+    {
+        stage->pollTimeMeasurements();
+    }
+}
+
 void Pipeline::sortStages()
 {
-    cppassist::debug("gloperate") << this->qualifiedName() << ": sort stages";
+    GLOPERATE_DEBUG(0) << this->qualifiedName() << ": sort stages";
+
+    updateExecutionPlan();
+
+    // Build adjacency lists of direct dependencies (source -> dependent stage)
+    const auto numStages = m_stages.size();
+    std::vector<std::vector<std::size_t>> dependents(numStages);
+    std::vector<std::size_t> numDependencies(numStages, 0);
+
+    for (std::size_t i = 0; i < numStages; ++i)
+    {
+        for (auto input : m_stages[i]->inputs())
+        {
+            const auto source = sourceStage(input);
+            if (!source || source == m_stages[i])
+            {
+                continue;
+            }
+
+            dependents[m_stageIndices.at(source)].push_back(i);
+            ++numDependencies[i];
+        }
+    }
+
+    // Start with all stages that have no dependencies, in their current order
+    std::deque<std::size_t> ready;
+    for (std::size_t i = 0; i < numStages; ++i)
+    {
+        if (numDependencies[i] == 0)
+        {
+            ready.push_back(i);
+        }
+    }
 
-    auto couldBeSorted = true;
     std::vector<Stage *> sorted;
-    std::set<Stage *> touched;
+    sorted.reserve(numStages);
+    std::vector<bool> added(numStages, false);
 
-    std::function<void(Stage *)> addSorted = [&](Stage * stage)
+    while (!ready.empty())
     {
-        m_stages.erase(find(m_stages.begin(), m_stages.end(), stage));
-        sorted.push_back(stage);
-    };
+        const auto index = ready.front();
+        ready.pop_front();
+
+        sorted.push_back(m_stages[index]);
+        added[index] = true;
+
+        for (auto dependent : dependents[index])
+        {
+            if (--numDependencies[dependent] == 0)
+            {
+                ready.push_back(dependent);
+            }
+        }
+    }
 
-    std::function<void(Stage *)> visit = [&](Stage * stage)
+    const auto couldBeSorted = sorted.size() == numStages;
+
+    if (!couldBeSorted)
     {
-        if (!couldBeSorted)
+        cppassist::critical() << "Pipeline is not a directed acyclic graph";
+
+        // Append stages that are part of a cycle in their previous order
+        for (std::size_t i = 0; i < numStages; ++i)
         {
-            addSorted(stage);
-            return;
+            if (!added[i])
+            {
+                sorted.push_back(m_stages[i]);
+            }
         }
+    }
+
+    GLOPERATE_DEBUG(2) << "Stage order after sorting";
+    for (const auto stage : sorted)
+    {
+        GLOPERATE_DEBUG(2) << stage->qualifiedName();
 
-        if (touched.count(stage) > 0)
+        // Connections have changed, so every stage has to be checked again
+        stage->markDirty();
+    }
+
+    m_stages = std::move(sorted);
+    m_sorted = couldBeSorted;
+
+    updateExecutionPlan();
+}
+
+void Pipeline::updateExecutionPlan()
+{
+    const auto numStages = m_stages.size();
+
+    m_lifetimesValid = false;
+
+    m_stageIndices.clear();
+    m_stageDependencies.assign(numStages, std::vector<std::size_t>());
+    m_concurrentStages.assign(numStages, false);
+    m_pendingStages.clear();
+    m_pendingStages.resize(numStages);
+    m_deferredNotifications.clear();
+    m_deferredNotifications.resize(numStages);
+
+    for (std::size_t i = 0; i < numStages; ++i)
+    {
+        m_stageIndices[m_stages[i]] = i;
+        m_concurrentStages[i] = !m_stages[i]->isPipeline() && !m_stages[i]->requiresContext();
+    }
+
+    for (std::size_t i = 0; i < numStages; ++i)
+    {
+        updateStageDependencies(i);
+    }
+}
+
+void Pipeline::updateStageDependencies(std::size_t index)
+{
+    const auto stage = m_stages[index];
+    auto & dependencies = m_stageDependencies[index];
+
+    dependencies.clear();
+
+    for (auto input : stage->inputs())
+    {
+        // Stages on both ends of a feedback connection access the same data
+        // out of order, so they are never processed concurrently
+        if (input->isFeedback() && input->isConnected())
         {
-            cppassist::critical() << "Pipeline is not a directed acyclic graph";
-            couldBeSorted = false;
-            return;
+            const auto sourceIt = m_stageIndices.find(input->source()->parentStage());
+            if (sourceIt != m_stageIndices.end())
+            {
+                m_concurrentStages[sourceIt->second] = false;
+                m_concurrentStages[index] = false;
+            }
+
+            continue;
         }
 
-        touched.insert(stage);
+        const auto source = sourceStage(input);
+        if (!source || source == stage)
+        {
+            continue;
+        }
 
-        for (auto stageIt = m_stages.begin(); stageIt != m_stages.end(); /* nop */)
+        const auto sourceIndex = m_stageIndices.at(source);
+        if (std::find(dependencies.begin(), dependencies.end(), sourceIndex) == dependencies.end())
         {
-            if (!stage->requires(*stageIt, false))
+            dependencies.push_back(sourceIndex);
+        }
+    }
+}
+
+void Pipeline::finishStage(std::size_t index)
+{
+    auto & pending = m_pendingStages[index];
+    if (!pending.valid())
+    {
+        return;
+    }
+
+    pending.wait();
+
+    // Notify connected slots on this thread, now that the outputs are final
+    AbstractSlot::DeferredNotifications::flush(m_deferredNotifications[index]);
+
+    const auto stage = m_stages[index];
+    stage->m_dirty = stage->needsProcessing();
+
+    // Rethrow exceptions from the worker thread
+    pending.get();
+}
+
+void Pipeline::finishStages(bool rethrow)
+{
+    std::exception_ptr exception;
+
+    for (std::size_t i = 0; i < m_pendingStages.size(); ++i)
+    {
+        try
+        {
+            finishStage(i);
+        }
+        catch (...)
+        {
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+        }
+    }
+
+    if (exception && rethrow)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void Pipeline::updateRenderTargetLifetimes()
+{
+    m_lifetimesValid = true;
+
+    const auto numStages = m_stages.size();
+    auto changed = false;
+
+    m_renderTargetUsers.clear();
+
+    for (std::size_t i = 0; i < numStages; ++i)
+    {
+        const auto client = m_stages[i];
+        if (!m_renderTargetPool->isClient(client))
+        {
+            continue;
+        }
+
+        auto & users = m_renderTargetUsers[client];
+
+        // Follow the outputs of the client through the stages that pass them on.
+        // Providers are sorted to the front, so the storage is only used from
+        // the first stage that reads the render targets, not from the client.
+        std::unordered_set<const AbstractSlot *> slots(client->outputs().begin(), client->outputs().end());
+        auto first = numStages;
+        auto last  = i;
+
+        for (std::size_t j = i + 1; j < numStages; ++j)
+        {
+            const auto stage = m_stages[j];
+            auto reads = false;
+
+            for (auto input : stage->inputs())
+            {
+                if (!input->isConnected() || slots.find(input->source()) == slots.end())
+                {
+                    continue;
+                }
+
+                // Contents are read in the next frame
+                if (input->isFeedback())
+                {
+                    first = 0;
+                    last  = numStages;
+                }
+
+                reads = true;
+            }
+
+            if (!reads)
             {
-                ++stageIt;
                 continue;
             }
 
-            auto nextStage = *stageIt;
-            visit(nextStage);
+            first = std::min(first, j);
+            last  = std::max(last, j);
+
+            users.readers.push_back(j);
+
+            auto writes = false;
+
+            for (auto output : stage->outputs())
+            {
+                if (carriesRenderTarget(output))
+                {
+                    slots.insert(output);
+                    writes = true;
+                }
+            }
+
+            if (writes)
+            {
+                users.writers.push_back(j);
+            }
+        }
 
-            if (!couldBeSorted)
+        // Contents are read outside of the pipeline
+        for (auto output : outputs())
+        {
+            if (output->isConnected() && slots.find(output->source()) != slots.end())
             {
-                addSorted(stage);
-                return;
+                last = numStages;
             }
+        }
 
-            stageIt = m_stages.begin();
+        // Render targets that are not read by any stage are only used by the client
+        if (first == numStages)
+        {
+            first = i;
         }
 
-        addSorted(stage);
-    };
+        changed = m_renderTargetPool->setLifetime(client, first, last) || changed;
+    }
 
-    while (!m_stages.empty())
+    if (!changed && !m_renderTargetPool->lifetimesOutdated())
     {
-        auto stageIt = m_stages.begin();
-        auto stage = *stageIt;
-        visit(stage);
+        return;
     }
 
-    cppassist::debug(2, "gloperate") << "Stage order after sorting";
-    for (const auto stage : sorted)
+    GLOPERATE_DEBUG(1) << this->qualifiedName() << ": reassign transient render targets";
+
+    m_renderTargetPool->reassign();
+
+    for (auto stage : m_stages)
     {
-        cppassist::debug(2, "gloperate") << stage->qualifiedName();
+        if (m_renderTargetPool->isClient(stage))
+        {
+            stage->invalidateOutputs();
+            stage->markDirty();
+        }
     }
+}
 
-    m_stages = sorted;
-    m_sorted = couldBeSorted;
+void Pipeline::scheduleRenderTargetWriters()
+{
+    const auto numStages = m_stages.size();
+
+    std::vector<const Stage *> sharedClients;
+    for (const auto & users : m_renderTargetUsers)
+    {
+        if (m_renderTargetPool->isShared(users.first))
+        {
+            sharedClients.push_back(users.first);
+        }
+    }
+
+    if (sharedClients.empty())
+    {
+        return;
+    }
+
+    std::vector<bool> scheduled(numStages, false);
+    auto changed = true;
+
+    // Invalidated writers may in turn schedule readers of other shared storage
+    while (changed)
+    {
+        changed = false;
+
+        // Stages may be processed if they or stages they depend on are dirty
+        for (std::size_t i = 0; i < numStages; ++i)
+        {
+            const auto & dependencies = m_stageDependencies[i];
+
+            scheduled[i] = m_stages[i]->m_dirty || std::any_of(dependencies.begin(), dependencies.end(), [&scheduled] (std::size_t dependency)
+            {
+                return scheduled[dependency];
+            });
+        }
+
+        for (auto client : sharedClients)
+        {
+            const auto & users = m_renderTargetUsers.at(client);
+
+            // Contents read outside of the pipeline are read after all stages
+            auto lastReader = m_renderTargetPool->lifetime(client).second >= numStages ? numStages : 0;
+
+            for (auto reader : users.readers)
+            {
+                if (scheduled[reader])
+                {
+                    lastReader = std::max(lastReader, reader);
+                }
+            }
+
+            for (auto index : users.writers)
+            {
+                const auto writer = m_stages[index];
+
+                if (index >= lastReader || (writer->m_dirty && writer->needsProcessing()))
+                {
+                    continue;
+                }
+
+                GLOPERATE_DEBUG(2) << writer->qualifiedName() << ": draw into shared render target again";
+
+                writer->invalidateOutputs();
+                writer->markDirty();
+
+                changed = writer->needsProcessing() || changed;
+            }
+        }
+    }
+}
+
+void Pipeline::propagateDeferredInvalidations()
+{
+    // In the order of execution, upstream invalidations reach stages that have
+    // also deferred an invalidation before these are visited, which then have
+    // nothing left to do
+    for (std::size_t i = 0; i < m_stages.size(); ++i)
+    {
+        const auto stage = m_stages[i];
+
+        if (stage->m_invalidationDeferred)
+        {
+            stage->invalidateOutputs();
+        }
+
+        if (stage->isPipeline())
+        {
+            static_cast<Pipeline *>(stage)->propagateDeferredInvalidations();
+        }
+    }
+}
+
+Stage * Pipeline::sourceStage(const AbstractSlot * input) const
+{
+    if (input->isFeedback() || !input->isConnected())
+    {
+        return nullptr;
+    }
+
+    const auto source = input->source()->parentStage();
+    if (!source || m_stageIndices.find(source) == m_stageIndices.end())
+    {
+        return nullptr;
+    }
+
+    return source;
 }
 
 void Pipeline::onContextInit(AbstractGLContext * context)
@@ -228,6 +727,8 @@ void Pipeline::onContextDeinit(AbstractGLContext * context)
     {
         stage->deinitContext(context);
     }
+
+    m_renderTargetPool->clear();
 }
 
 void Pipeline::onProcess()
@@ -236,16 +737,92 @@ void Pipeline::onProcess()
         sortStages();
     }
 
-    for (auto stage : m_stages)
+    if (!m_lifetimesValid || m_renderTargetPool->lifetimesOutdated())
     {
-        if (stage->needsProcessing()) {
-            stage->process();
-        }
-        else
+        updateRenderTargetLifetimes();
+    }
+
+    scheduleRenderTargetWriters();
+
+    auto threadPool = m_environment->threadPool();
+
+    try
+    {
+        for (std::size_t i = 0; i < m_stages.size(); ++i)
         {
-            cppassist::debug(2, "gloperate") << stage->qualifiedName() << ": omit execution";
+            const auto stage = m_stages[i];
+
+            // Wait for concurrently processed stages this stage depends on
+            for (auto dependency : m_stageDependencies[i])
+            {
+                finishStage(dependency);
+            }
+
+            // Stages whose outputs have neither been invalidated nor
+            // required since their last check are known to be up to date
+            if (!stage->m_dirty)
+            {
+                continue;
+            }
+
+            if (!stage->needsProcessing())
+            {
+                GLOPERATE_DEBUG(2) << stage->qualifiedName() << ": omit execution";
+
+                stage->m_dirty = false;
+                continue;
+            }
+
+            // Process context-free stages on a worker thread, unless GPU times are measured
+            if (m_concurrentStages[i] && !stage->timeMeasurement() && threadPool->numThreads() > 0)
+            {
+                const auto profiler = FrameProfiler::current();
+                const auto notifications = &m_deferredNotifications[i];
+
+                AbstractSlot::beginConcurrentProcessing();
+
+                try
+                {
+                    m_pendingStages[i] = threadPool->submit([stage, profiler, notifications] ()
+                    {
+                        const ConcurrentProcessingGuard guard;
+
+                        // Record CPU span only, the worker thread has no OpenGL context
+                        FrameProfiler::ThreadBinding profilerBinding(profiler, false);
+
+                        // Connected slots are notified on this thread when the stage is finished
+                        const AbstractSlot::DeferredNotifications deferredNotifications(notifications);
+
+                        stage->process();
+                    });
+                }
+                catch (...)
+                {
+                    AbstractSlot::endConcurrentProcessing();
+                    throw;
+                }
+
+                continue;
+            }
+
+            stage->process();
+
+            // Keep stage scheduled only if it still needs processing (e.g., if it is always processed)
+            stage->m_dirty = stage->needsProcessing();
         }
     }
+    catch (...)
+    {
+        // Do not leave stages running on worker threads
+        finishStages(false);
+        throw;
+    }
+
+    // All outputs of the pipeline have to be available when it has been processed
+    finishStages(true);
+
+    // Delete storage of transient render targets that is no longer requested
+    m_renderTargetPool->collectGarbage();
 }
 
 void Pipeline::onInputValueChanged(AbstractSlot *)
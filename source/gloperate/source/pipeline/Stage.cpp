@@ -4,7 +4,6 @@
 #include <algorithm>
 
 #include <cppassist/string/conversion.h>
-#include <cppassist/logging/logging.h>
 
 #include <cppexpose/variant/Variant.h>
 
@@ -14,20 +13,11 @@
 #include <globjects/Framebuffer.h>
 
 #include <gloperate/base/ExtendedProperties.h>
+#include <gloperate/base/logging.h>
+#include <gloperate/base/FrameProfiler.h>
 #include <gloperate/pipeline/Pipeline.h>
 #include <gloperate/pipeline/AbstractSlot.h>
-
-
-namespace
-{
-    enum Query
-    {
-        PairOneStart = 0,
-        PairOneEnd = 1,
-        PairTwoStart = 2,
-        PairTwoEnd = 3
-    };
-}
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate
@@ -50,15 +40,22 @@ Stage::Stage(Environment * environment, const std::string & className, const std
 : cppexpose::Object((name.empty()) ? className : name)
 , m_environment(environment)
 , m_alwaysProcess(false)
+, m_dirty(true)
+, m_invalidationDeferred(false)
 , m_timeMeasurement(false)
-, m_useQueryPairOne(true)
-, m_resultAvailable(false)
+, m_nextTimeQuery(0)
 , m_lastCPUDuration(0)
-, m_currentCPUDuration(0)
 , m_lastGPUDuration(0)
 {
+    for (auto & timeQuery : m_timeQueries)
+    {
+        timeQuery = { 0, 0, 0, false };
+    }
+
     // Set object class name
     setClassName(className);
+
+    m_qualifiedName = this->name();
 }
 
 Stage::~Stage()
@@ -74,6 +71,11 @@ bool Stage::isPipeline() const
     return false;
 }
 
+bool Stage::requiresContext() const
+{
+    return true;
+}
+
 Environment * Stage::environment() const
 {
     return m_environment;
@@ -105,74 +107,77 @@ bool Stage::requires(const Stage * stage, bool recursive) const
 
 void Stage::initContext(AbstractGLContext * context)
 {
-    cppassist::debug(2, "gloperate") << this->qualifiedName() << ": initContext";
+    GLOPERATE_DEBUG(2) << this->qualifiedName() << ": initContext";
 
     // Create time queries
-    gl::glGenQueries(4, m_queries.data());
+    std::array<gl::GLuint, 2 * s_numTimeQueries> queries;
+    gl::glGenQueries(static_cast<gl::GLsizei>(queries.size()), queries.data());
 
-    // Dummy querys for first frame
-    if (m_useQueryPairOne)
-    {
-        gl::glQueryCounter(m_queries[Query::PairOneStart], gl::GL_TIMESTAMP);
-        gl::glQueryCounter(m_queries[Query::PairOneEnd], gl::GL_TIMESTAMP);
-    }
-    else
+    for (std::size_t i = 0; i < s_numTimeQueries; ++i)
     {
-        gl::glQueryCounter(m_queries[Query::PairTwoStart], gl::GL_TIMESTAMP);
-        gl::glQueryCounter(m_queries[Query::PairTwoEnd], gl::GL_TIMESTAMP);
+        m_timeQueries[i] = { queries[2 * i], queries[2 * i + 1], 0, false };
     }
 
     onContextInit(context);
+
+    // Creating OpenGL objects may bind them directly, which happens only once per context
+    if (const auto stateCache = RenderStateCache::current())
+    {
+        stateCache->invalidate();
+    }
 }
 
 void Stage::deinitContext(AbstractGLContext * context)
 {
-    cppassist::debug(2, "gloperate") << this->qualifiedName() << ": deinitContex";
+    GLOPERATE_DEBUG(2) << this->qualifiedName() << ": deinitContex";
     onContextDeinit(context);
+
+    // Release time queries, pending measurements are lost
+    for (auto & timeQuery : m_timeQueries)
+    {
+        if (timeQuery.startQuery != 0)
+        {
+            gl::glDeleteQueries(1, &timeQuery.startQuery);
+            gl::glDeleteQueries(1, &timeQuery.endQuery);
+        }
+
+        timeQuery = { 0, 0, 0, false };
+    }
 }
 
 void Stage::process()
 {
-    cppassist::debug(1, "gloperate") << this->qualifiedName() << ": processing";
+    GLOPERATE_DEBUG(1) << this->qualifiedName() << ": processing";
 
-    if (m_timeMeasurement)
-    {
-        // Get currently used queries
-        auto usedStartQuery   = m_useQueryPairOne ? Query::PairOneStart : Query::PairTwoStart;
-        auto usedEndQuery     = m_useQueryPairOne ? Query::PairOneEnd   : Query::PairTwoEnd;
-        auto unusedStartQuery = m_useQueryPairOne ? Query::PairTwoStart : Query::PairOneStart;
-        auto unusedEndQuery   = m_useQueryPairOne ? Query::PairTwoEnd   : Query::PairOneEnd;
+    // Record span in the profiler of the canvas that is rendered, if profiling is enabled
+    const auto profiler = FrameProfiler::current();
+    FrameProfiler::Scope profilerScope(profiler, profiler ? qualifiedName().c_str() : nullptr);
+
+    // Measure only if a free ring entry is left, otherwise the GPU is too far behind
+    // (results of earlier measurements are collected once per frame, see pollTimeMeasurements())
+    auto & timeQuery = m_timeQueries[m_nextTimeQuery];
 
+    if (m_timeMeasurement && !timeQuery.pending && timeQuery.startQuery != 0)
+    {
         // Start CPU time measurement
         auto cpu_start = std::chrono::high_resolution_clock::now();
 
         // Start GPU time measurement
-        gl::glQueryCounter(m_queries[unusedStartQuery], gl::GL_TIMESTAMP);
+        gl::glQueryCounter(timeQuery.startQuery, gl::GL_TIMESTAMP);
 
         // Execute stage
         onProcess();
 
-        // Stop CPU time measurement
-        auto cpu_end = std::chrono::high_resolution_clock::now();
-        m_lastCPUDuration = m_currentCPUDuration;
-        m_currentCPUDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(cpu_end - cpu_start).count();
-
         // Stop GPU time measurement
-        gl::glQueryCounter(m_queries[unusedEndQuery], gl::GL_TIMESTAMP);
-
-        // Get GPU values from last frame
-        gl::GLuint64 gpu_start, gpu_end;
-        gl::glGetQueryObjectui64v(m_queries[usedStartQuery], gl::GL_QUERY_RESULT, &gpu_start);
-        gl::glGetQueryObjectui64v(m_queries[usedEndQuery], gl::GL_QUERY_RESULT, &gpu_end);
-        m_lastGPUDuration = gpu_end - gpu_start;
+        gl::glQueryCounter(timeQuery.endQuery, gl::GL_TIMESTAMP);
 
-        // Switch queries for next frame
-        m_useQueryPairOne = !m_useQueryPairOne;
+        // Stop CPU time measurement
+        auto cpu_end = std::chrono::high_resolution_clock::now();
+        timeQuery.cpuDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(cpu_end - cpu_start).count();
 
-        // Emit measured times
-        if (m_resultAvailable) {
-            timeMeasured(m_lastCPUDuration, m_lastGPUDuration);
-        } else m_resultAvailable = true;
+        // Results are evaluated in later calls when available
+        timeQuery.pending = true;
+        m_nextTimeQuery = (m_nextTimeQuery + 1) % s_numTimeQueries;
     }
     else
     {
@@ -188,22 +193,27 @@ void Stage::process()
 bool Stage::needsProcessing() const
 {
     if (m_alwaysProcess) {
-        cppassist::debug(4, "gloperate") << this->qualifiedName() << ": needs processing because it is always processed";
+        GLOPERATE_DEBUG(4) << this->qualifiedName() << ": needs processing because it is always processed";
         return true;
     }
 
     for (auto output : m_outputs)
     {
         if (output->isRequired() && !output->isValid()) {
-            cppassist::debug(4, "gloperate") << this->qualifiedName() << ": needs processing because output is invalid and required (" << output->qualifiedName()<< ")";
+            GLOPERATE_DEBUG(4) << this->qualifiedName() << ": needs processing because output is invalid and required (" << output->qualifiedName()<< ")";
             return true;
         }
     }
 
-    cppassist::debug(4, "gloperate") << this->qualifiedName() << ": needs no processing";
+    GLOPERATE_DEBUG(4) << this->qualifiedName() << ": needs no processing";
     return false;
 }
 
+void Stage::markDirty()
+{
+    m_dirty = true;
+}
+
 bool Stage::alwaysProcessed() const
 {
     return m_alwaysProcess;
@@ -211,13 +221,25 @@ bool Stage::alwaysProcessed() const
 
 void Stage::setAlwaysProcessed(bool alwaysProcess)
 {
-    cppassist::debug(2, "gloperate") << this->qualifiedName() << ": set always processed to " << alwaysProcess;
+    GLOPERATE_DEBUG(2) << this->qualifiedName() << ": set always processed to " << alwaysProcess;
     m_alwaysProcess = alwaysProcess;
+
+    markDirty();
 }
 
 void Stage::invalidateOutputs()
 {
-    cppassist::debug(3, "gloperate") << this->qualifiedName() << ": invalidateOutputs";
+    // Defer invalidation until the update of the parent pipelines has ended
+    const auto pipeline = parentPipeline();
+    if (pipeline && pipeline->isUpdating())
+    {
+        m_invalidationDeferred = true;
+        return;
+    }
+
+    m_invalidationDeferred = false;
+
+    GLOPERATE_DEBUG(3) << this->qualifiedName() << ": invalidateOutputs";
 
     for (auto output : m_outputs)
     {
@@ -347,7 +369,9 @@ void Stage::registerInput(AbstractSlot * input)
         m_inputsMap.insert(std::make_pair(input->name(), input));
     }
 
-    cppassist::debug(2, "gloperate") << input->qualifiedName() << ": add input to stage";
+    input->updateQualifiedName();
+
+    GLOPERATE_DEBUG(2) << input->qualifiedName() << ": add input to stage";
 
     // Emit signal
     inputAdded(input);
@@ -359,7 +383,7 @@ void Stage::removeInput(AbstractSlot * input)
     auto it = std::find(m_inputs.begin(), m_inputs.end(), input);
     if (it != m_inputs.end())
     {
-        cppassist::debug(2, "gloperate") << input->qualifiedName() << ": remove input from stage";
+        GLOPERATE_DEBUG(2) << input->qualifiedName() << ": remove input from stage";
 
         // Remove input
         m_inputs.erase(it);
@@ -437,7 +461,9 @@ void Stage::registerOutput(AbstractSlot * output)
         m_outputsMap.insert(std::make_pair(output->name(), output));
     }
 
-    cppassist::debug(2, "gloperate") << output->qualifiedName() << ": add output to stage";
+    output->updateQualifiedName();
+
+    GLOPERATE_DEBUG(2) << output->qualifiedName() << ": add output to stage";
 
     // Emit signal
     outputAdded(output);
@@ -449,7 +475,7 @@ void Stage::removeOutput(AbstractSlot * output)
     auto it = std::find(m_outputs.begin(), m_outputs.end(), output);
     if (it != m_outputs.end())
     {
-        cppassist::debug(2, "gloperate") << output->qualifiedName() << ": remove output from stage";
+        GLOPERATE_DEBUG(2) << output->qualifiedName() << ": remove output from stage";
 
         // Remove output
         m_outputs.erase(it);
@@ -465,7 +491,7 @@ void Stage::removeOutput(AbstractSlot * output)
 
 void Stage::outputRequiredChanged(AbstractSlot * slot)
 {
-    cppassist::debug(2, "gloperate") << this->qualifiedName() << ": output required changed for " << slot->qualifiedName();
+    GLOPERATE_DEBUG(2) << this->qualifiedName() << ": output required changed for " << slot->qualifiedName();
     onOutputRequiredChanged(slot);
 }
 
@@ -520,19 +546,35 @@ AbstractSlot * Stage::createSlot(const std::string & slotType, const std::string
     return nullptr;
 }
 
-std::string Stage::qualifiedName() const
+const std::string & Stage::qualifiedName() const
+{
+    return m_qualifiedName;
+}
+
+void Stage::updateQualifiedName()
 {
-    std::string path = name();
+    auto lock = AbstractSlot::lockPropagation();
 
-    Pipeline * pipeline = this->parentPipeline();
-    while (pipeline)
+    const auto pipeline = parentPipeline();
+    m_qualifiedName = pipeline ? pipeline->qualifiedName() + "." + name() : name();
+
+    for (auto input : m_inputs)
     {
-        path = pipeline->name() + "." + path;
+        input->updateQualifiedName();
+    }
 
-        pipeline = pipeline->parentPipeline();
+    for (auto output : m_outputs)
+    {
+        output->updateQualifiedName();
     }
 
-    return path;
+    if (isPipeline())
+    {
+        for (auto stage : static_cast<Pipeline *>(this)->stages())
+        {
+            stage->updateQualifiedName();
+        }
+    }
 }
 
 void Stage::onContextInit(AbstractGLContext *)
@@ -584,7 +626,7 @@ void Stage::invalidateInputConnections()
 {
     if (parentPipeline())
     {
-        parentPipeline()->invalidateStageOrder();
+        parentPipeline()->updateStageOrder(this);
     }
 }
 
@@ -621,11 +663,57 @@ bool Stage::timeMeasurement() const
 
 void Stage::setTimeMeasurement(bool enabled, bool)
 {
-    m_timeMeasurement    = enabled;
-    m_resultAvailable    = false;
-    m_currentCPUDuration = 0;
-    m_lastCPUDuration    = 0;
-    m_lastGPUDuration    = 0;
+    m_timeMeasurement = enabled;
+    m_lastCPUDuration = 0;
+    m_lastGPUDuration = 0;
+
+    // Discard pending measurements
+    for (auto & timeQuery : m_timeQueries)
+    {
+        timeQuery.pending = false;
+    }
+}
+
+void Stage::pollTimeMeasurements()
+{
+    if (m_timeMeasurement)
+    {
+        evaluateTimeQueries();
+    }
+}
+
+void Stage::evaluateTimeQueries()
+{
+    // Start with the oldest entry, so results are reported in order
+    for (std::size_t i = 0; i < s_numTimeQueries; ++i)
+    {
+        auto & timeQuery = m_timeQueries[(m_nextTimeQuery + i) % s_numTimeQueries];
+
+        if (!timeQuery.pending)
+        {
+            continue;
+        }
+
+        // Stop at the first measurement the GPU has not finished yet
+        gl::GLint available = 0;
+        gl::glGetQueryObjectiv(timeQuery.endQuery, gl::GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available)
+        {
+            return;
+        }
+
+        gl::GLuint64 gpu_start, gpu_end;
+        gl::glGetQueryObjectui64v(timeQuery.startQuery, gl::GL_QUERY_RESULT, &gpu_start);
+        gl::glGetQueryObjectui64v(timeQuery.endQuery, gl::GL_QUERY_RESULT, &gpu_end);
+
+        m_lastCPUDuration = timeQuery.cpuDuration;
+        m_lastGPUDuration = gpu_end - gpu_start;
+        timeQuery.pending = false;
+
+        // Emit measured times
+        timeMeasured(m_lastCPUDuration, m_lastGPUDuration);
+    }
 }
 
 
@@ -8,6 +8,7 @@
 #include <globjects/Texture.h>
 
 #include <gloperate/rendering/Color.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate
@@ -73,6 +74,7 @@ std::unique_ptr<globjects::Texture> AbstractColorGradient::generateTexture(size_
     std::vector<unsigned char> data = pixelData(numPixels);
 
     texture->image1D(0, gl::GL_RGBA, numPixels, 0, gl::GL_BGRA, gl::GL_UNSIGNED_BYTE, data.data());
+    RenderStateCache::texturesChanged();
 
     return texture;
 }
@@ -1,6 +1,8 @@
 
 #include <gloperate/rendering/AbstractRenderTarget.h>
 
+#include <atomic>
+
 #include <glbinding/gl/types.h>
 #include <glbinding/gl/enum.h>
 
@@ -10,6 +12,23 @@
 #include <globjects/Texture.h>
 
 
+namespace
+{
+
+
+std::size_t nextRevision()
+{
+    // Revisions are unique across all render targets, so a target
+    // that is created at the address of a deleted one is not mistaken for it
+    static std::atomic<std::size_t> s_revision(0);
+
+    return ++s_revision;
+}
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
@@ -20,6 +39,7 @@ AbstractRenderTarget::AbstractRenderTarget()
 , m_texture(nullptr)
 , m_renderbuffer(nullptr)
 , m_userDefinedFBOAttachment(nullptr)
+, m_revision(nextRevision())
 {
 }
 
@@ -29,6 +49,11 @@ AbstractRenderTarget::~AbstractRenderTarget()
 
 void AbstractRenderTarget::releaseTarget()
 {
+    if (m_currentTargetType != RenderTargetType::Invalid)
+    {
+        m_revision = nextRevision();
+    }
+
     switch (m_currentTargetType)
     {
     case RenderTargetType::Texture:
@@ -54,36 +79,60 @@ void AbstractRenderTarget::releaseTarget()
 
 void AbstractRenderTarget::setTarget(globjects::Texture * texture)
 {
+    if (m_currentTargetType == RenderTargetType::Texture && m_texture == texture)
+    {
+        return;
+    }
+
     releaseTarget();
 
     m_currentTargetType = RenderTargetType::Texture;
+    m_revision = nextRevision();
 
     m_texture = texture;
 }
 
 void AbstractRenderTarget::setTarget(globjects::Renderbuffer * renderbuffer)
 {
+    if (m_currentTargetType == RenderTargetType::Renderbuffer && m_renderbuffer == renderbuffer)
+    {
+        return;
+    }
+
     releaseTarget();
 
     m_currentTargetType = RenderTargetType::Renderbuffer;
+    m_revision = nextRevision();
 
     m_renderbuffer = renderbuffer;
 }
 
 void AbstractRenderTarget::setTarget(gl::GLenum attachment)
 {
+    if (m_currentTargetType == RenderTargetType::DefaultFBOAttachment && m_defaultFBOAttachment == attachment)
+    {
+        return;
+    }
+
     releaseTarget();
 
     m_currentTargetType = RenderTargetType::DefaultFBOAttachment;
+    m_revision = nextRevision();
 
     m_defaultFBOAttachment = attachment;
 }
 
 void AbstractRenderTarget::setTarget(globjects::FramebufferAttachment * fboAttachment)
 {
+    if (m_currentTargetType == RenderTargetType::UserDefinedFBOAttachment && m_userDefinedFBOAttachment == fboAttachment)
+    {
+        return;
+    }
+
     releaseTarget();
 
     m_currentTargetType = RenderTargetType::UserDefinedFBOAttachment;
+    m_revision = nextRevision();
 
     m_userDefinedFBOAttachment = fboAttachment;
 }
@@ -93,6 +142,11 @@ RenderTargetType AbstractRenderTarget::currentTargetType() const
     return m_currentTargetType;
 }
 
+std::size_t AbstractRenderTarget::revision() const
+{
+    return m_revision;
+}
+
 gl::GLenum AbstractRenderTarget::defaultFramebufferAttachment() const
 {
     return m_defaultFBOAttachment;
@@ -11,6 +11,7 @@
 
 #include <gloperate/rendering/AbstractColorGradient.h>
 #include <gloperate/rendering/Image.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate
@@ -37,6 +38,7 @@ std::unique_ptr<globjects::Texture> ColorGradientList::generateTexture(const std
     }
 
     texture->image2D(0, gl::GL_RGBA, numPixels, numberOfGradients, 0, gl::GL_BGRA, gl::GL_UNSIGNED_BYTE, data.data());
+    RenderStateCache::texturesChanged();
 
     return texture;
 }
@@ -171,6 +173,7 @@ std::unique_ptr<globjects::Texture> ColorGradientList::generateTexture(size_t nu
     appendPixelData(numPixels, &(data[0]));
 
     texture->image2D(0, gl::GL_RGBA, numPixels, m_gradients.size(), 0, gl::GL_BGRA, gl::GL_UNSIGNED_BYTE, data.data());
+    RenderStateCache::texturesChanged();
 
     return texture;
 }
@@ -2,14 +2,19 @@
 #include <gloperate/rendering/Drawable.h>
 
 #include <cassert>
+#include <algorithm>
+#include <limits>
 
 #include <cppassist/memory/make_unique.h>
 
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
 
 #include <globjects/VertexArray.h>
 #include <globjects/VertexAttributeBinding.h>
 
+#include <gloperate/rendering/RenderStateCache.h>
+
 
 namespace gloperate
 {
@@ -19,9 +24,20 @@ Drawable::Drawable()
 : m_vao(cppassist::make_unique<globjects::VertexArray>())
 , m_drawMode(DrawMode::Arrays)
 , m_size(0)
+, m_instanceCount(1)
+, m_baseInstance(0)
 , m_primitiveMode(gl::GL_TRIANGLES)
 , m_indexBufferType(gl::GL_UNSIGNED_INT)
 , m_indexBuffer(nullptr)
+, m_maxIndex(0)
+, m_indirectBuffer(nullptr)
+, m_indirectDrawCount(0)
+, m_indirectStride(0)
+, m_ownedIndexType(gl::GL_UNSIGNED_SHORT)
+, m_ownedIndexCount(0)
+, m_dirtyBegin(0)
+, m_dirtyEnd(0)
+, m_vaoIndexBuffer(nullptr)
 {
 }
 
@@ -58,6 +74,14 @@ void Drawable::draw(DrawMode drawMode) const
         drawElements();
         break;
 
+    case DrawMode::ArraysIndirect:
+        drawArraysIndirect();
+        break;
+
+    case DrawMode::ElementsIndirect:
+        drawElementsIndirect();
+        break;
+
     case DrawMode::Arrays:
     default:
         drawArrays();
@@ -82,7 +106,20 @@ void Drawable::drawArrays(gl::GLint first, gl::GLsizei count) const
 
 void Drawable::drawArrays(gl::GLenum mode, gl::GLint first, gl::GLsizei count) const
 {
-    m_vao->drawArrays(mode, first, count);
+    bindVertexArray();
+
+    if (m_baseInstance != 0)
+    {
+        gl::glDrawArraysInstancedBaseInstance(mode, first, count, m_instanceCount, m_baseInstance);
+    }
+    else if (m_instanceCount != 1)
+    {
+        gl::glDrawArraysInstanced(mode, first, count, m_instanceCount);
+    }
+    else
+    {
+        gl::glDrawArrays(mode, first, count);
+    }
 }
 
 void Drawable::drawElements() const
@@ -94,7 +131,9 @@ void Drawable::drawElements(gl::GLenum mode) const
 {
     if (m_drawMode == DrawMode::ElementsIndices)
     {
-        drawElements(mode, m_size, gl::GL_UNSIGNED_INT, m_indices.data());
+        uploadIndices();
+
+        drawElements(mode, m_size, m_ownedIndexType, m_ownedIndexBuffer.get());
     }
     else
     {
@@ -104,16 +143,52 @@ void Drawable::drawElements(gl::GLenum mode) const
 
 void Drawable::drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices) const
 {
-    // [TODO]: rethink recorded vao state
-    globjects::Buffer::unbind(gl::GL_ELEMENT_ARRAY_BUFFER);
+    // Client-side indices require that no index buffer is recorded in the vertex array
+    bindVertexArray();
+    bindIndexBuffer(nullptr);
+
+    drawElementsInstanced(mode, count, type, indices);
+}
+
+void Drawable::drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, globjects::Buffer * indices) const
+{
+    bindVertexArray();
+    bindIndexBuffer(indices);
 
-    m_vao->drawElements(mode, count, type, indices);
+    drawElementsInstanced(mode, count, type, nullptr);
 }
 
-void Drawable::drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, globjects::Buffer *) const
+void Drawable::drawArraysIndirect() const
 {
-    // [TODO]: rethink recorded vao state
-    m_vao->drawElements(mode, count, type, nullptr);
+    drawArraysIndirect(m_primitiveMode);
+}
+
+void Drawable::drawArraysIndirect(gl::GLenum mode) const
+{
+    assert(m_indirectBuffer != nullptr);
+
+    bindVertexArray();
+
+    m_indirectBuffer->bind(gl::GL_DRAW_INDIRECT_BUFFER);
+    gl::glMultiDrawArraysIndirect(mode, nullptr, m_indirectDrawCount, m_indirectStride);
+    globjects::Buffer::unbind(gl::GL_DRAW_INDIRECT_BUFFER);
+}
+
+void Drawable::drawElementsIndirect() const
+{
+    drawElementsIndirect(m_primitiveMode);
+}
+
+void Drawable::drawElementsIndirect(gl::GLenum mode) const
+{
+    assert(m_indirectBuffer != nullptr);
+
+    bindVertexArray();
+    bindIndexBuffer(m_indexBuffer);
+
+    m_indirectBuffer->bind(gl::GL_DRAW_INDIRECT_BUFFER);
+    gl::glMultiDrawElementsIndirect(mode, m_indexBufferType, nullptr, m_indirectDrawCount, m_indirectStride);
+    globjects::Buffer::unbind(gl::GL_DRAW_INDIRECT_BUFFER);
 }
 
 gl::GLsizei Drawable::size() const
@@ -126,6 +201,26 @@ void Drawable::setSize(gl::GLsizei size)
     m_size = size;
 }
 
+gl::GLsizei Drawable::instanceCount() const
+{
+    return m_instanceCount;
+}
+
+void Drawable::setInstanceCount(gl::GLsizei instanceCount)
+{
+    m_instanceCount = instanceCount;
+}
+
+gl::GLuint Drawable::baseInstance() const
+{
+    return m_baseInstance;
+}
+
+void Drawable::setBaseInstance(gl::GLuint baseInstance)
+{
+    m_baseInstance = baseInstance;
+}
+
 gl::GLenum Drawable::primitiveMode() const
 {
     return m_primitiveMode;
@@ -171,7 +266,10 @@ void Drawable::setIndexBuffer(globjects::Buffer * buffer)
     m_vao->bind();
     buffer->bind(gl::GL_ELEMENT_ARRAY_BUFFER);
     m_indexBuffer = buffer;
+    m_vaoIndexBuffer = buffer;
     m_vao->unbind();
+
+    vertexArrayChanged();
 }
 
 void Drawable::setIndexBuffer(globjects::Buffer * buffer, gl::GLenum bufferType)
@@ -190,6 +288,23 @@ void Drawable::setIndexBufferType(gl::GLenum bufferType)
     m_indexBufferType = bufferType;
 }
 
+globjects::Buffer * Drawable::indirectBuffer() const
+{
+    return m_indirectBuffer;
+}
+
+gl::GLsizei Drawable::indirectDrawCount() const
+{
+    return m_indirectDrawCount;
+}
+
+void Drawable::setIndirectBuffer(globjects::Buffer * buffer, gl::GLsizei drawCount, gl::GLsizei stride)
+{
+    m_indirectBuffer    = buffer;
+    m_indirectDrawCount = drawCount;
+    m_indirectStride    = stride;
+}
+
 const std::vector<std::uint32_t> & Drawable::indices() const
 {
     return m_indices;
@@ -197,7 +312,42 @@ const std::vector<std::uint32_t> & Drawable::indices() const
 
 void Drawable::setIndices(const std::vector<std::uint32_t> & indices)
 {
+    // Only the range that differs from the current indices has to be uploaded
+    if (indices.size() == m_indices.size())
+    {
+        const auto first = std::mismatch(indices.begin(), indices.end(), m_indices.begin());
+
+        if (first.first == indices.end())
+        {
+            return;
+        }
+
+        const auto last = std::mismatch(indices.rbegin(), indices.rend(), m_indices.rbegin());
+
+        invalidateIndices(static_cast<size_t>(first.first - indices.begin()), static_cast<size_t>(last.first.base() - indices.begin()));
+    }
+    else
+    {
+        invalidateIndices(0, indices.size());
+    }
+
     m_indices = indices;
+    m_maxIndex = m_indices.empty() ? 0 : *std::max_element(m_indices.begin(), m_indices.end());
+}
+
+void Drawable::updateIndices(size_t offset, const std::vector<std::uint32_t> & indices)
+{
+    assert(offset + indices.size() <= m_indices.size());
+
+    if (indices.empty())
+    {
+        return;
+    }
+
+    std::copy(indices.begin(), indices.end(), m_indices.begin() + offset);
+    m_maxIndex = std::max(m_maxIndex, *std::max_element(indices.begin(), indices.end()));
+
+    invalidateIndices(offset, offset + indices.size());
 }
 
 globjects::VertexAttributeBinding * Drawable::attributeBinding(size_t index) const
@@ -210,26 +360,36 @@ void Drawable::setAttributeBindingBuffer(size_t bindingIndex, size_t bufferIndex
     assert(m_buffers.count(bufferIndex) > 0);
 
     m_vao->binding(bindingIndex)->setBuffer(m_buffers.at(bufferIndex), baseOffset, stride);
+
+    vertexArrayChanged();
 }
 
 void Drawable::setAttributeBindingFormat(size_t bindingIndex, gl::GLint size, gl::GLenum type, gl::GLboolean normalized, gl::GLuint relativeOffset)
 {
     m_vao->binding(bindingIndex)->setFormat(size, type, normalized, relativeOffset);
+
+    vertexArrayChanged();
 }
 
 void Drawable::setAttributeBindingFormatI(size_t bindingIndex, gl::GLint size, gl::GLenum type, gl::GLuint relativeOffset)
 {
     m_vao->binding(bindingIndex)->setIFormat(size, type, relativeOffset);
+
+    vertexArrayChanged();
 }
 
 void Drawable::setAttributeBindingFormatL(size_t bindingIndex, gl::GLint size, gl::GLenum type, gl::GLuint relativeOffset)
 {
     m_vao->binding(bindingIndex)->setLFormat(size, type, relativeOffset);
+
+    vertexArrayChanged();
 }
 
 void Drawable::bindAttribute(size_t bindingIndex, gl::GLint attributeIndex)
 {
     m_vao->binding(bindingIndex)->setAttribute(attributeIndex);
+
+    vertexArrayChanged();
 }
 
 void Drawable::bindAttributes(const std::vector<gl::GLint> & attributeIndices)
@@ -238,11 +398,22 @@ void Drawable::bindAttributes(const std::vector<gl::GLint> & attributeIndices)
     {
         m_vao->binding(i)->setAttribute(attributeIndices.at(i));
     }
+
+    vertexArrayChanged();
+}
+
+void Drawable::setAttributeBindingDivisor(size_t bindingIndex, gl::GLuint divisor)
+{
+    m_vao->binding(bindingIndex)->setDivisor(static_cast<gl::GLint>(divisor));
+
+    vertexArrayChanged();
 }
 
 void Drawable::enableAttributeBinding(size_t bindingIndex)
 {
     m_vao->enable(m_vao->binding(bindingIndex)->attributeIndex());
+
+    vertexArrayChanged();
 }
 
 void Drawable::enableAllAttributeBindings()
@@ -251,6 +422,134 @@ void Drawable::enableAllAttributeBindings()
     {
         m_vao->enable(binding->attributeIndex());
     }
+
+    vertexArrayChanged();
+}
+
+
+void Drawable::bindVertexArray() const
+{
+    const auto cache = RenderStateCache::current();
+
+    if (!cache || cache->updateVertexArray(m_vao->id()))
+    {
+        m_vao->bind();
+    }
+}
+
+void Drawable::drawElementsInstanced(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices) const
+{
+    if (m_baseInstance != 0)
+    {
+        gl::glDrawElementsInstancedBaseInstance(mode, count, type, indices, m_instanceCount, m_baseInstance);
+    }
+    else if (m_instanceCount != 1)
+    {
+        gl::glDrawElementsInstanced(mode, count, type, indices, m_instanceCount);
+    }
+    else
+    {
+        gl::glDrawElements(mode, count, type, indices);
+    }
+}
+
+void Drawable::bindIndexBuffer(globjects::Buffer * buffer) const
+{
+    if (m_vaoIndexBuffer == buffer)
+    {
+        return;
+    }
+
+    if (buffer)
+    {
+        buffer->bind(gl::GL_ELEMENT_ARRAY_BUFFER);
+    }
+    else
+    {
+        globjects::Buffer::unbind(gl::GL_ELEMENT_ARRAY_BUFFER);
+    }
+
+    m_vaoIndexBuffer = buffer;
+}
+
+void Drawable::uploadIndices() const
+{
+    const auto type = m_maxIndex <= std::numeric_limits<std::uint16_t>::max() ? gl::GL_UNSIGNED_SHORT : gl::GL_UNSIGNED_INT;
+
+    const auto created = !m_ownedIndexBuffer;
+
+    if (created)
+    {
+        m_ownedIndexBuffer = cppassist::make_unique<globjects::Buffer>();
+    }
+    else if (m_dirtyBegin >= m_dirtyEnd && type == m_ownedIndexType && m_indices.size() == m_ownedIndexCount)
+    {
+        // Nothing changed since the last upload
+        return;
+    }
+
+    // Reallocate if size or type changed, else upload only the changed range
+    auto begin = m_dirtyBegin;
+    auto end   = m_dirtyEnd;
+    const auto reallocate = created || type != m_ownedIndexType || m_indices.size() != m_ownedIndexCount;
+
+    if (reallocate)
+    {
+        begin = 0;
+        end   = m_indices.size();
+    }
+
+    if (type == gl::GL_UNSIGNED_SHORT)
+    {
+        const std::vector<std::uint16_t> indices(m_indices.begin() + begin, m_indices.begin() + end);
+
+        if (reallocate)
+        {
+            m_ownedIndexBuffer->setData(indices, gl::GL_STATIC_DRAW);
+        }
+        else
+        {
+            m_ownedIndexBuffer->setSubData(begin * sizeof(std::uint16_t), indices.size() * sizeof(std::uint16_t), indices.data());
+        }
+    }
+    else
+    {
+        if (reallocate)
+        {
+            m_ownedIndexBuffer->setData(m_indices, gl::GL_STATIC_DRAW);
+        }
+        else
+        {
+            m_ownedIndexBuffer->setSubData(begin * sizeof(std::uint32_t), (end - begin) * sizeof(std::uint32_t), m_indices.data() + begin);
+        }
+    }
+
+    m_ownedIndexType  = type;
+    m_ownedIndexCount = m_indices.size();
+    m_dirtyBegin      = 0;
+    m_dirtyEnd        = 0;
+}
+
+void Drawable::invalidateIndices(size_t begin, size_t end)
+{
+    if (m_dirtyBegin >= m_dirtyEnd)
+    {
+        m_dirtyBegin = begin;
+        m_dirtyEnd   = end;
+    }
+    else
+    {
+        m_dirtyBegin = std::min(m_dirtyBegin, begin);
+        m_dirtyEnd   = std::max(m_dirtyEnd, end);
+    }
+}
+
+void Drawable::vertexArrayChanged() const
+{
+    if (const auto cache = RenderStateCache::current())
+    {
+        cache->invalidateVertexArray();
+    }
 }
 
 
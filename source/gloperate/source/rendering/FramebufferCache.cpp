@@ -0,0 +1,232 @@
+
+#include <gloperate/rendering/FramebufferCache.h>
+
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Framebuffer.h>
+
+
+namespace
+{
+
+
+thread_local gloperate::FramebufferCache * t_cache = nullptr; ///< Cache bound to the current thread
+
+std::vector<gloperate::FramebufferCache *> s_caches;      ///< All existing caches, notified on releases
+std::mutex                                 s_cachesMutex; ///< Guards the list of caches
+
+
+bool attachmentLess(const gloperate::FramebufferCache::Attachment & a, const gloperate::FramebufferCache::Attachment & b)
+{
+    return static_cast<unsigned int>(a.attachment) < static_cast<unsigned int>(b.attachment);
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+FramebufferCache::ThreadBinding::ThreadBinding(FramebufferCache * cache)
+: m_previousCache(t_cache)
+{
+    t_cache = cache;
+}
+
+FramebufferCache::ThreadBinding::~ThreadBinding()
+{
+    t_cache = m_previousCache;
+}
+
+
+bool FramebufferCache::Attachment::operator==(const Attachment & other) const
+{
+    return attachment   == other.attachment
+        && texture      == other.texture
+        && renderbuffer == other.renderbuffer
+        && id           == other.id;
+}
+
+bool FramebufferCache::Attachment::operator!=(const Attachment & other) const
+{
+    return !(*this == other);
+}
+
+
+FramebufferCache * FramebufferCache::current()
+{
+    return t_cache;
+}
+
+void FramebufferCache::releaseTexture(const globjects::Texture * texture)
+{
+    std::lock_guard<std::mutex> lock(s_cachesMutex);
+
+    for (auto cache : s_caches)
+    {
+        cache->markStale(texture);
+    }
+}
+
+void FramebufferCache::releaseRenderbuffer(const globjects::Renderbuffer * renderbuffer)
+{
+    std::lock_guard<std::mutex> lock(s_cachesMutex);
+
+    for (auto cache : s_caches)
+    {
+        cache->markStale(renderbuffer);
+    }
+}
+
+FramebufferCache::FramebufferCache(std::size_t capacity)
+: m_capacity(std::max(capacity, std::size_t(1)))
+, m_useCounter(0)
+, m_hasStale(false)
+{
+    std::lock_guard<std::mutex> lock(s_cachesMutex);
+
+    s_caches.push_back(this);
+}
+
+FramebufferCache::~FramebufferCache()
+{
+    std::lock_guard<std::mutex> lock(s_cachesMutex);
+
+    s_caches.erase(std::remove(s_caches.begin(), s_caches.end(), this), s_caches.end());
+}
+
+std::size_t FramebufferCache::capacity() const
+{
+    return m_capacity;
+}
+
+void FramebufferCache::setCapacity(std::size_t capacity)
+{
+    m_capacity = std::max(capacity, std::size_t(1));
+}
+
+std::size_t FramebufferCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_entries.size();
+}
+
+globjects::Framebuffer * FramebufferCache::obtain(const std::vector<Attachment> & attachments, const std::vector<gl::GLenum> & drawBuffers)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_hasStale)
+    {
+        removeStale();
+    }
+
+    auto sortedAttachments = attachments;
+    std::sort(sortedAttachments.begin(), sortedAttachments.end(), attachmentLess);
+
+    ++m_useCounter;
+
+    // Look up configuration
+    for (auto & entry : m_entries)
+    {
+        if (entry.attachments == sortedAttachments && entry.drawBuffers == drawBuffers)
+        {
+            entry.lastUse = m_useCounter;
+
+            return entry.fbo.get();
+        }
+    }
+
+    // Evict least recently used framebuffer
+    if (m_entries.size() >= m_capacity)
+    {
+        const auto lru = std::min_element(m_entries.begin(), m_entries.end(), [] (const Entry & a, const Entry & b)
+        {
+            return a.lastUse < b.lastUse;
+        });
+
+        m_entries.erase(lru);
+    }
+
+    // Create and validate framebuffer for the new configuration
+    auto fbo = cppassist::make_unique<globjects::Framebuffer>();
+
+    for (const auto & attachment : sortedAttachments)
+    {
+        if (attachment.texture)
+        {
+            fbo->attachTexture(attachment.attachment, attachment.texture);
+        }
+        else if (attachment.renderbuffer)
+        {
+            fbo->attachRenderBuffer(attachment.attachment, attachment.renderbuffer);
+        }
+    }
+
+    fbo->setDrawBuffers(drawBuffers);
+
+    if (fbo->checkStatus() != gl::GL_FRAMEBUFFER_COMPLETE)
+    {
+        fbo->printStatus(true);
+    }
+
+    Entry entry;
+    entry.attachments = std::move(sortedAttachments);
+    entry.drawBuffers = drawBuffers;
+    entry.fbo         = std::move(fbo);
+    entry.lastUse     = m_useCounter;
+    entry.stale       = false;
+
+    m_entries.push_back(std::move(entry));
+
+    return m_entries.back().fbo.get();
+}
+
+void FramebufferCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_entries.clear();
+    m_hasStale = false;
+}
+
+void FramebufferCache::markStale(const void * object)
+{
+    if (!object)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto & entry : m_entries)
+    {
+        for (const auto & attachment : entry.attachments)
+        {
+            if (attachment.texture == object || attachment.renderbuffer == object)
+            {
+                entry.stale = true;
+                m_hasStale  = true;
+            }
+        }
+    }
+}
+
+void FramebufferCache::removeStale()
+{
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [] (const Entry & entry)
+    {
+        return entry.stale;
+    }), m_entries.end());
+
+    m_hasStale = false;
+}
+
+
+} // namespace gloperate
@@ -0,0 +1,154 @@
+
+#include <gloperate/rendering/GeometryLibrary.h>
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+
+#include <gloperate/rendering/Icosahedron.h>
+
+
+namespace
+{
+
+
+thread_local gloperate::GeometryLibrary * t_library = nullptr; ///< Library bound to the current thread
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+GeometryLibrary::ThreadBinding::ThreadBinding(GeometryLibrary * library)
+: m_previousLibrary(t_library)
+{
+    t_library = library;
+}
+
+GeometryLibrary::ThreadBinding::~ThreadBinding()
+{
+    t_library = m_previousLibrary;
+}
+
+
+GeometryLibrary * GeometryLibrary::current()
+{
+    return t_library;
+}
+
+std::shared_ptr<GeometryLibrary::Geometry> GeometryLibrary::createSphere(const Icosahedron & icosahedron, float radius, bool texCoords)
+{
+    auto geometry = std::make_shared<Geometry>();
+
+    // Create vertex buffer
+    auto vertices = icosahedron.vertices();
+
+    for (auto & vertex : vertices)
+    {
+        vertex *= radius;
+    }
+
+    geometry->vertices = cppassist::make_unique<globjects::Buffer>();
+    geometry->vertices->setData(vertices, gl::GL_STATIC_DRAW);
+
+    // Create texture coordinate buffer
+    if (texCoords)
+    {
+        geometry->texCoords = cppassist::make_unique<globjects::Buffer>();
+        geometry->texCoords->setData(icosahedron.texcoords(), gl::GL_STATIC_DRAW);
+    }
+
+    // Create index buffer
+    geometry->indices = cppassist::make_unique<globjects::Buffer>();
+    geometry->indices->setData(icosahedron.indices(), gl::GL_STATIC_DRAW);
+
+    geometry->size = icosahedron.indices().size() * std::tuple_size<Icosahedron::Face>::value;
+
+    return geometry;
+}
+
+GeometryLibrary::GeometryLibrary()
+{
+}
+
+GeometryLibrary::~GeometryLibrary()
+{
+}
+
+std::shared_ptr<const GeometryLibrary::Geometry> GeometryLibrary::sphere(float radius, unsigned int levels, bool texCoords)
+{
+    // Look up configuration
+    const auto it = std::find_if(m_spheres.begin(), m_spheres.end(), [radius, levels, texCoords] (const SphereEntry & entry)
+    {
+        return entry.radius == radius && entry.levels == levels && entry.texCoords == texCoords;
+    });
+
+    if (it != m_spheres.end())
+    {
+        return it->geometry;
+    }
+
+    collectGarbage();
+
+    // Refine icosahedron once per level
+    if (m_icosahedra.size() <= levels)
+    {
+        m_icosahedra.resize(levels + 1);
+    }
+
+    auto & icosahedron = m_icosahedra[levels];
+
+    if (!icosahedron)
+    {
+        icosahedron = cppassist::make_unique<Icosahedron>();
+        icosahedron->generateGeometry(levels);
+    }
+
+    if (texCoords && icosahedron->texcoords().empty())
+    {
+        icosahedron->generateTextureCoordinates();
+    }
+
+    auto geometry = createSphere(*icosahedron, radius, texCoords);
+
+    SphereEntry entry;
+    entry.radius    = radius;
+    entry.levels    = levels;
+    entry.texCoords = texCoords;
+    entry.geometry  = geometry;
+
+    m_spheres.push_back(entry);
+
+    return geometry;
+}
+
+std::size_t GeometryLibrary::size() const
+{
+    return m_spheres.size();
+}
+
+void GeometryLibrary::clear()
+{
+    m_spheres.clear();
+    m_icosahedra.clear();
+}
+
+void GeometryLibrary::collectGarbage()
+{
+    m_spheres.erase(std::remove_if(m_spheres.begin(), m_spheres.end(), [] (const SphereEntry & entry)
+    {
+        return entry.geometry.use_count() == 1;
+    }), m_spheres.end());
+}
+
+
+} // namespace gloperate
@@ -11,6 +11,16 @@
 using namespace glm;
 
 
+namespace
+{
+
+
+const std::size_t s_maxNeighbors = 6; ///< Maximum number of neighbors of a vertex of a refined icosahedron
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
@@ -127,12 +137,19 @@ void Icosahedron::refine(
 ,   std::vector<Face> & indices
 ,   const unsigned char levels)
 {
-    std::unordered_map<uint, gl::GLushort> cache;
+    std::vector<std::pair<gl::GLushort, gl::GLushort>> midpoints;
 
     for(int i = 0; i < levels; ++i)
     {
         const int size(static_cast<int>(indices.size()));
 
+        // Each vertex has at most six neighbors, so the edge table of a level has a fixed size
+        midpoints.assign(vertices.size() * s_maxNeighbors, std::make_pair(gl::GLushort(0), gl::GLushort(0)));
+
+        // Each edge is shared by two faces
+        vertices.reserve(vertices.size() + size * 3 / 2);
+        indices.reserve(size * 4);
+
         for(int f = 0; f < size; ++f)
         {
             Face & face = indices[f];
@@ -141,9 +158,9 @@ void Icosahedron::refine(
             const gl::GLushort b(face[1]);
             const gl::GLushort c(face[2]);
 
-            const gl::GLushort ab(split(a, b, vertices, cache));
-            const gl::GLushort bc(split(b, c, vertices, cache));
-            const gl::GLushort ca(split(c, a, vertices, cache));
+            const gl::GLushort ab(split(a, b, vertices, midpoints));
+            const gl::GLushort bc(split(b, c, vertices, midpoints));
+            const gl::GLushort ca(split(c, a, vertices, midpoints));
 
             face = {{ ab, bc, ca }};
 
@@ -158,26 +175,30 @@ gl::GLushort Icosahedron::split(
     const gl::GLushort a
 ,   const gl::GLushort b
 ,   std::vector<vec3> & points
-,   std::unordered_map<uint, gl::GLushort> & cache)
+,   std::vector<std::pair<gl::GLushort, gl::GLushort>> & midpoints)
 {
     const bool aSmaller(a < b);
 
-    const uint smaller(aSmaller ? a : b);
-    const uint greater(aSmaller ? b : a);
-    const uint hash((smaller << 16) + greater);
+    const gl::GLushort smaller(aSmaller ? a : b);
+    const gl::GLushort greater(aSmaller ? b : a);
 
-    auto h(cache.find(hash));
-    if(cache.end() != h)
-        return h->second;
+    // Greater vertices are never 0, which marks unused entries
+    const auto begin = midpoints.begin() + smaller * s_maxNeighbors;
+    const auto entry = std::find_if(begin, begin + s_maxNeighbors, [greater] (const std::pair<gl::GLushort, gl::GLushort> & edge)
+    {
+        return edge.first == greater || edge.first == 0;
+    });
+
+    if (entry->first == greater)
+        return entry->second;
 
     points.push_back(normalize((points[a] + points[b]) * 0.5f));
 
     const gl::GLushort i = static_cast<gl::GLushort>(points.size() - 1);
 
-    cache[hash] = i;
+    *entry = std::make_pair(greater, i);
 
     return i;
 }
 
-
 } // namespace gloperate
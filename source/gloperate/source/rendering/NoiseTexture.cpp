@@ -10,6 +10,8 @@
 
 #include <globjects/Texture.h>
 
+#include <gloperate/rendering/RenderStateCache.h>
+
 
 namespace gloperate
 {
@@ -24,12 +26,22 @@ NoiseTexture::NoiseTexture(
 
 void NoiseTexture::bindActive(unsigned int index) const
 {
-    m_texture->bindActive(index);
+    const auto cache = RenderStateCache::current();
+
+    if (!cache || cache->updateTexture(index, m_texture->id()))
+    {
+        m_texture->bindActive(index);
+    }
 }
 
 void NoiseTexture::unbindActive(unsigned int index) const
 {
     m_texture->unbindActive(index);
+
+    if (const auto cache = RenderStateCache::current())
+    {
+        cache->updateTexture(index, 0);
+    }
 }
 
 globjects::Texture * NoiseTexture::texture()
@@ -127,6 +139,8 @@ std::unique_ptr<globjects::Texture> NoiseTexture::createTexture(
     texture->setParameter(gl::GL_TEXTURE_WRAP_T, gl::GL_REPEAT);
     texture->setParameter(gl::GL_TEXTURE_WRAP_R, gl::GL_REPEAT);
 
+    RenderStateCache::texturesChanged();
+
     return texture;
 }
 
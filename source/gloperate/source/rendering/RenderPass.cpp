@@ -1,8 +1,11 @@
 
 #include <gloperate/rendering/RenderPass.h>
 
+#include <algorithm>
+
 #include <glbinding/gl/enum.h>
 #include <glbinding/gl/functions.h>
+#include <glbinding/gl/values.h>
 
 #include <globjects/Texture.h>
 #include <globjects/Sampler.h>
@@ -13,12 +16,95 @@
 #include <globjects/State.h>
 
 #include <gloperate/rendering/AbstractDrawable.h>
+#include <gloperate/rendering/RenderStateCache.h>
+#include <gloperate/rendering/UniformRing.h>
+#include <gloperate/rendering/FrameConstants.h>
+
+
+namespace
+{
+
+
+template <typename T>
+typename std::vector<std::pair<size_t, T *>>::const_iterator findBinding(const std::vector<std::pair<size_t, T *>> & bindings, size_t index)
+{
+    return std::lower_bound(bindings.begin(), bindings.end(), index, [] (const std::pair<size_t, T *> & binding, size_t value)
+    {
+        return binding.first < value;
+    });
+}
+
+template <typename T>
+T * binding(const std::vector<std::pair<size_t, T *>> & bindings, size_t index)
+{
+    const auto it = findBinding(bindings, index);
+
+    if (it == bindings.end() || it->first != index)
+    {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+template <typename T>
+void setBinding(std::vector<std::pair<size_t, T *>> & bindings, size_t index, T * object)
+{
+    const auto it = bindings.begin() + (findBinding(bindings, index) - bindings.cbegin());
+
+    if (it == bindings.end() || it->first != index)
+    {
+        bindings.emplace(it, index, object);
+    }
+    else
+    {
+        it->second = object;
+    }
+}
+
+template <typename T>
+T * removeBinding(std::vector<std::pair<size_t, T *>> & bindings, size_t index)
+{
+    const auto it = bindings.begin() + (findBinding(bindings, index) - bindings.cbegin());
+
+    if (it == bindings.end() || it->first != index)
+    {
+        return nullptr;
+    }
+
+    const auto former = it->second;
+
+    bindings.erase(it);
+
+    return former;
+}
+
+
+} // namespace
 
 
 namespace gloperate
 {
 
 
+void RenderPass::bindConstantBlocks(globjects::Program * program)
+{
+    const std::pair<const char *, gl::GLuint> blocks[] = {
+        { "FrameConstants",     FrameConstants::binding },
+        { "TransformConstants", TransformConstants::binding }
+    };
+
+    for (const auto & block : blocks)
+    {
+        const auto index = gl::glGetUniformBlockIndex(program->id(), block.first);
+
+        if (index != gl::GL_INVALID_INDEX)
+        {
+            gl::glUniformBlockBinding(program->id(), index, block.second);
+        }
+    }
+}
+
 RenderPass::RenderPass()
 : m_stateBefore(nullptr)
 , m_stateAfter(nullptr)
@@ -38,11 +124,16 @@ RenderPass::~RenderPass()
 
 void RenderPass::draw() const
 {
+    const auto cache = RenderStateCache::current();
+
     bindResources();
     
     if (m_stateBefore)
     {
         m_stateBefore->apply();
+
+        // A state may enable or disable any capability
+        if (cache) cache->invalidateCapabilities();
     }
 
     if (m_recordTransformFeedback)
@@ -50,15 +141,19 @@ void RenderPass::draw() const
         m_recordTransformFeedback->bind();
         m_recordTransformFeedback->begin(m_recordTransformFeedbackMode);
 
-        gl::glEnable(gl::GL_RASTERIZER_DISCARD);
+        RenderStateCache::applyCapability(gl::GL_RASTERIZER_DISCARD, true);
     }
 
+    // Programs are always bound, as Program::use() also relinks changed programs
     if (m_program)
     {
         m_program->use();
     }
     else if (m_programPipeline)
     {
+        // A bound program would take precedence over the pipeline
+        globjects::Program::release();
+
         m_programPipeline->use();
     }
     else
@@ -80,12 +175,14 @@ void RenderPass::draw() const
     {
         m_recordTransformFeedback->end();
 
-        gl::glDisable(gl::GL_RASTERIZER_DISCARD);
+        RenderStateCache::applyCapability(gl::GL_RASTERIZER_DISCARD, false);
     }
     
     if (m_stateAfter)
     {
         m_stateAfter->apply();
+
+        if (cache) cache->invalidateCapabilities();
     }
 }
 
@@ -181,14 +278,7 @@ void RenderPass::setProgramPipeline(globjects::ProgramPipeline * programPipeline
 
 globjects::Texture * RenderPass::texture(size_t index) const
 {
-    const auto it = m_textures.find(index);
-
-    if (it == m_textures.end())
-    {
-        return nullptr;
-    }
-
-    return it->second;
+    return binding(m_textures, index);
 }
 
 globjects::Texture * RenderPass::texture(gl::GLenum activeTextureIndex) const
@@ -198,16 +288,7 @@ globjects::Texture * RenderPass::texture(gl::GLenum activeTextureIndex) const
 
 void RenderPass::setTexture(size_t index, globjects::Texture * texture)
 {
-    const auto it = m_textures.find(index);
-
-    if (it == m_textures.end())
-    {
-        m_textures.emplace(index, texture);
-    }
-    else
-    {
-        it->second = texture;
-    }
+    setBinding(m_textures, index, texture);
 }
 
 void RenderPass::setTexture(gl::GLenum activeTextureIndex, globjects::Texture * texture)
@@ -217,18 +298,7 @@ void RenderPass::setTexture(gl::GLenum activeTextureIndex, globjects::Texture *
 
 globjects::Texture * RenderPass::removeTexture(size_t index)
 {
-    const auto it = m_textures.find(index);
-
-    if (it == m_textures.end())
-    {
-        return nullptr;
-    }
-
-    const auto former = it->second;
-
-    m_textures.erase(it);
-
-    return former;
+    return removeBinding(m_textures, index);
 }
 
 globjects::Texture * RenderPass::removeTexture(gl::GLenum activeTextureIndex)
@@ -236,246 +306,183 @@ globjects::Texture * RenderPass::removeTexture(gl::GLenum activeTextureIndex)
     return removeTexture(static_cast<size_t>(activeTextureIndex) - static_cast<size_t>(gl::GL_TEXTURE0));
 }
 
-globjects::Sampler * RenderPass::sampler(size_t index) const
+const std::vector<std::pair<size_t, globjects::Texture *>> & RenderPass::textures() const
 {
-    const auto it = m_samplers.find(index);
-
-    if (it == m_samplers.end())
-    {
-        return nullptr;
-    }
+    return m_textures;
+}
 
-    return it->second;
+globjects::Sampler * RenderPass::sampler(size_t index) const
+{
+    return binding(m_samplers, index);
 }
 
 void RenderPass::setSampler(size_t index, globjects::Sampler * sampler)
 {
-    const auto it = m_samplers.find(index);
-
-    if (it == m_samplers.end())
-    {
-        m_samplers.emplace(index, sampler);
-    }
-    else
-    {
-        it->second = sampler;
-    }
+    setBinding(m_samplers, index, sampler);
 }
 
 globjects::Sampler * RenderPass::removeSampler(size_t index)
 {
-    const auto it = m_samplers.find(index);
-
-    if (it == m_samplers.end())
-    {
-        return nullptr;
-    }
-
-    const auto former = it->second;
-
-    m_samplers.erase(it);
-
-    return former;
+    return removeBinding(m_samplers, index);
 }
 
 globjects::Buffer * RenderPass::uniformBuffer(size_t index) const
 {
-    const auto it = m_uniformBuffers.find(index);
-
-    if (it == m_uniformBuffers.end())
-    {
-        return nullptr;
-    }
-
-    return it->second;
+    return binding(m_uniformBuffers, index);
 }
 
 void RenderPass::setUniformBuffer(size_t index, globjects::Buffer * buffer)
 {
-    const auto it = m_uniformBuffers.find(index);
-
-    if (it == m_uniformBuffers.end())
-    {
-        m_uniformBuffers.emplace(index, buffer);
-    }
-    else
-    {
-        it->second = buffer;
-    }
+    setBinding(m_uniformBuffers, index, buffer);
 }
 
 globjects::Buffer * RenderPass::removeUniformBuffer(size_t index)
 {
-    const auto it = m_uniformBuffers.find(index);
-
-    if (it == m_uniformBuffers.end())
-    {
-        return nullptr;
-    }
-
-    const auto former = it->second;
-
-    m_uniformBuffers.erase(it);
-
-    return former;
+    return removeBinding(m_uniformBuffers, index);
 }
 
 globjects::Buffer * RenderPass::atomicCounterBuffer(size_t index) const
 {
-    const auto it = m_atomicCounterBuffers.find(index);
-
-    if (it == m_atomicCounterBuffers.end())
-    {
-        return nullptr;
-    }
-
-    return it->second;
+    return binding(m_atomicCounterBuffers, index);
 }
 
 void RenderPass::setAtomicCounterBuffer(size_t index, globjects::Buffer * buffer)
 {
-    const auto it = m_atomicCounterBuffers.find(index);
-
-    if (it == m_atomicCounterBuffers.end())
-    {
-        m_atomicCounterBuffers.emplace(index, buffer);
-    }
-    else
-    {
-        it->second = buffer;
-    }
+    setBinding(m_atomicCounterBuffers, index, buffer);
 }
 
 globjects::Buffer * RenderPass::removeAtomicCounterBuffer(size_t index)
 {
-    const auto it = m_atomicCounterBuffers.find(index);
-
-    if (it == m_atomicCounterBuffers.end())
-    {
-        return nullptr;
-    }
-
-    const auto former = it->second;
-
-    m_atomicCounterBuffers.erase(it);
-
-    return former;
+    return removeBinding(m_atomicCounterBuffers, index);
 }
 
 globjects::Buffer * RenderPass::shaderStorageBuffer(size_t index) const
 {
-    const auto it = m_shaderStorageBuffers.find(index);
-
-    if (it == m_shaderStorageBuffers.end())
-    {
-        return nullptr;
-    }
-
-    return it->second;
+    return binding(m_shaderStorageBuffers, index);
 }
 
 void RenderPass::setShaderStorageBuffer(size_t index, globjects::Buffer * buffer)
 {
-    const auto it = m_shaderStorageBuffers.find(index);
-
-    if (it == m_shaderStorageBuffers.end())
-    {
-        m_shaderStorageBuffers.emplace(index, buffer);
-    }
-    else
-    {
-        it->second = buffer;
-    }
+    setBinding(m_shaderStorageBuffers, index, buffer);
 }
 
 globjects::Buffer * RenderPass::removeShaderStorageBuffer(size_t index)
 {
-    const auto it = m_shaderStorageBuffers.find(index);
-
-    if (it == m_shaderStorageBuffers.end())
-    {
-        return nullptr;
-    }
-
-    const auto former = it->second;
-
-    m_shaderStorageBuffers.erase(it);
-
-    return former;
+    return removeBinding(m_shaderStorageBuffers, index);
 }
 
 globjects::Buffer * RenderPass::transformFeedbackBuffer(size_t index) const
 {
-    const auto it = m_transformFeedbackBuffers.find(index);
+    return binding(m_transformFeedbackBuffers, index);
+}
 
-    if (it == m_transformFeedbackBuffers.end())
-    {
-        return nullptr;
-    }
+void RenderPass::setTransformFeedbackBuffer(size_t index, globjects::Buffer * buffer)
+{
+    setBinding(m_transformFeedbackBuffers, index, buffer);
+}
 
-    return it->second;
+globjects::Buffer * RenderPass::removeTransformFeedbackBuffer(size_t index)
+{
+    return removeBinding(m_transformFeedbackBuffers, index);
 }
 
-void RenderPass::setTransformFeedbackBuffer(size_t index, globjects::Buffer * buffer)
+void RenderPass::setUniformBlock(size_t index, const void * data, size_t size)
 {
-    const auto it = m_transformFeedbackBuffers.find(index);
+    const auto bytes = static_cast<const unsigned char *>(data);
 
-    if (it == m_transformFeedbackBuffers.end())
+    auto it = std::find_if(m_uniformBlocks.begin(), m_uniformBlocks.end(), [index] (const std::pair<size_t, std::vector<unsigned char>> & block)
     {
-        m_transformFeedbackBuffers.emplace(index, buffer);
-    }
-    else
+        return block.first == index;
+    });
+
+    if (it == m_uniformBlocks.end())
     {
-        it->second = buffer;
+        m_uniformBlocks.emplace_back(index, std::vector<unsigned char>());
+        it = m_uniformBlocks.end() - 1;
     }
+
+    // Reuses the allocation if the size of the constants does not change
+    it->second.assign(bytes, bytes + size);
 }
 
-globjects::Buffer * RenderPass::removeTransformFeedbackBuffer(size_t index)
+bool RenderPass::removeUniformBlock(size_t index)
 {
-    const auto it = m_transformFeedbackBuffers.find(index);
+    const auto it = std::find_if(m_uniformBlocks.begin(), m_uniformBlocks.end(), [index] (const std::pair<size_t, std::vector<unsigned char>> & block)
+    {
+        return block.first == index;
+    });
 
-    if (it == m_transformFeedbackBuffers.end())
+    if (it == m_uniformBlocks.end())
     {
-        return nullptr;
+        return false;
     }
 
-    const auto former = it->second;
-
-    m_transformFeedbackBuffers.erase(it);
+    m_uniformBlocks.erase(it);
 
-    return former;
+    return true;
 }
 
 void RenderPass::bindResources() const
 {
+    const auto cache = RenderStateCache::current();
+
     for (const auto & pair : m_textures)
     {
-        pair.second->bindActive(pair.first);
+        if (!cache || cache->updateTexture(pair.first, pair.second->id()))
+        {
+            pair.second->bindActive(pair.first);
+        }
     }
 
     for (const auto & pair : m_samplers)
     {
-        pair.second->bind(pair.first);
+        if (!cache || cache->updateSampler(pair.first, pair.second->id()))
+        {
+            pair.second->bind(pair.first);
+        }
     }
 
     for (const auto & pair : m_uniformBuffers)
     {
-        pair.second->bindBase(gl::GL_UNIFORM_BUFFER, pair.first);
+        if (!cache || cache->updateBufferBase(gl::GL_UNIFORM_BUFFER, pair.first, pair.second->id()))
+        {
+            pair.second->bindBase(gl::GL_UNIFORM_BUFFER, pair.first);
+        }
+    }
+
+    if (!m_uniformBlocks.empty())
+    {
+        if (const auto ring = UniformRing::current())
+        {
+            for (const auto & block : m_uniformBlocks)
+            {
+                ring->bind(block.first, block.second.data(), block.second.size());
+            }
+        }
     }
 
     for (const auto & pair : m_atomicCounterBuffers)
     {
-        pair.second->bindBase(gl::GL_ATOMIC_COUNTER_BUFFER, pair.first);
+        if (!cache || cache->updateBufferBase(gl::GL_ATOMIC_COUNTER_BUFFER, pair.first, pair.second->id()))
+        {
+            pair.second->bindBase(gl::GL_ATOMIC_COUNTER_BUFFER, pair.first);
+        }
     }
 
     for (const auto & pair : m_shaderStorageBuffers)
     {
-        pair.second->bindBase(gl::GL_SHADER_STORAGE_BUFFER, pair.first);
+        if (!cache || cache->updateBufferBase(gl::GL_SHADER_STORAGE_BUFFER, pair.first, pair.second->id()))
+        {
+            pair.second->bindBase(gl::GL_SHADER_STORAGE_BUFFER, pair.first);
+        }
     }
 
     for (const auto & pair : m_transformFeedbackBuffers)
     {
-        pair.second->bindBase(gl::GL_TRANSFORM_FEEDBACK_BUFFER, pair.first);
+        if (!cache || cache->updateBufferBase(gl::GL_TRANSFORM_FEEDBACK_BUFFER, pair.first, pair.second->id()))
+        {
+            pair.second->bindBase(gl::GL_TRANSFORM_FEEDBACK_BUFFER, pair.first);
+        }
     }
 }
 
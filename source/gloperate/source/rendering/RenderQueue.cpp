@@ -0,0 +1,174 @@
+
+#include <gloperate/rendering/RenderQueue.h>
+
+#include <cassert>
+#include <algorithm>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Framebuffer.h>
+#include <globjects/Texture.h>
+
+#include <gloperate/rendering/RenderPass.h>
+
+
+namespace
+{
+
+
+// Bits of the sort key, from most to least significant (64 in total)
+const unsigned int s_framebufferBits = 6;
+const unsigned int s_programBits     = 12;
+const unsigned int s_stateBits       = 10;
+const unsigned int s_textureSetBits  = 12;
+const unsigned int s_geometryBits    = 12;
+const unsigned int s_depthBits       = 12;
+
+
+std::uint64_t identity(const void * object)
+{
+    return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(object));
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+RenderQueue::RenderQueue()
+: m_sorted(true)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void RenderQueue::submit(const RenderPass * pass, float depth, globjects::Framebuffer * framebuffer)
+{
+    const auto program = pass->program() ? identity(pass->program()) : identity(pass->programPipeline());
+
+    const auto maxDepth = (std::uint64_t(1) << s_depthBits) - 1;
+    const auto clampedDepth = std::min(std::max(depth, 0.0f), 1.0f);
+
+    // Passes without framebuffer get the lowest ID, so they are drawn before any framebuffer is bound
+    const auto maxFramebuffer = (std::uint64_t(1) << s_framebufferBits) - 1;
+    const auto framebufferId = framebuffer ? std::min(id(m_framebuffers, identity(framebuffer), s_framebufferBits) + 1, maxFramebuffer) : 0;
+
+    std::uint64_t key = 0;
+    key = (key << s_framebufferBits) | framebufferId;
+    key = (key << s_programBits)     | id(m_programs, program, s_programBits);
+    key = (key << s_stateBits)       | id(m_states, identity(pass->stateBefore()), s_stateBits);
+    key = (key << s_textureSetBits)  | id(m_textureSets, textureSet(pass), s_textureSetBits);
+    key = (key << s_geometryBits)    | id(m_geometries, identity(pass->geometry()), s_geometryBits);
+    key = (key << s_depthBits)       | static_cast<std::uint64_t>(clampedDepth * maxDepth);
+
+    Item item;
+    item.key         = key;
+    item.order       = static_cast<std::uint32_t>(m_items.size());
+    item.pass        = pass;
+    item.framebuffer = framebuffer;
+
+    m_items.push_back(item);
+    m_sorted = false;
+}
+
+std::size_t RenderQueue::size() const
+{
+    return m_items.size();
+}
+
+void RenderQueue::clear()
+{
+    // Keep the allocated memory for the next frame
+    m_items.clear();
+    m_sorted = true;
+
+    m_framebuffers.clear();
+    m_programs.clear();
+    m_states.clear();
+    m_textureSets.clear();
+    m_geometries.clear();
+}
+
+void RenderQueue::draw() const
+{
+    sort();
+
+    // Without a render state cache, sorting would not save any bindings
+    auto cache = RenderStateCache::current();
+    if (!cache)
+    {
+        cache = &m_stateCache;
+        cache->invalidate();
+    }
+
+    RenderStateCache::ThreadBinding stateCacheBinding(cache);
+
+    // Passes without framebuffer are sorted first and keep the framebuffer bound by the caller
+    globjects::Framebuffer * framebuffer = nullptr;
+
+    for (const auto & item : m_items)
+    {
+        assert(item.framebuffer || !framebuffer);
+
+        if (item.framebuffer && item.framebuffer != framebuffer)
+        {
+            item.framebuffer->bind(gl::GL_FRAMEBUFFER);
+            framebuffer = item.framebuffer;
+        }
+
+        item.pass->draw();
+    }
+}
+
+void RenderQueue::sort() const
+{
+    if (m_sorted)
+    {
+        return;
+    }
+
+    std::sort(m_items.begin(), m_items.end(), [] (const Item & a, const Item & b)
+    {
+        return a.key < b.key || (a.key == b.key && a.order < b.order);
+    });
+
+    m_sorted = true;
+}
+
+std::uint64_t RenderQueue::id(std::unordered_map<std::uint64_t, std::uint64_t> & ids, std::uint64_t object, unsigned int bits)
+{
+    const auto maxId = (std::uint64_t(1) << bits) - 1;
+
+    const auto it = ids.find(object);
+    if (it != ids.end())
+    {
+        return it->second;
+    }
+
+    const auto newId = std::min(static_cast<std::uint64_t>(ids.size()), maxId);
+    ids.emplace(object, newId);
+
+    return newId;
+}
+
+std::uint64_t RenderQueue::textureSet(const RenderPass * pass)
+{
+    // FNV-1a over the (unit, texture) pairs, which are sorted by unit
+    std::uint64_t hash = 14695981039346656037ull;
+
+    for (const auto & binding : pass->textures())
+    {
+        hash = (hash ^ static_cast<std::uint64_t>(binding.first)) * 1099511628211ull;
+        hash = (hash ^ identity(binding.second)) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+
+} // namespace gloperate
@@ -0,0 +1,216 @@
+
+#include <gloperate/rendering/RenderStateCache.h>
+
+#include <algorithm>
+
+#include <glbinding/gl/functions.h>
+
+
+namespace
+{
+
+
+thread_local gloperate::RenderStateCache * t_cache = nullptr; ///< Cache bound to the current thread
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+const gl::GLuint RenderStateCache::s_unknown = ~gl::GLuint(0);
+
+
+RenderStateCache::ThreadBinding::ThreadBinding(RenderStateCache * cache)
+: m_previousCache(t_cache)
+{
+    t_cache = cache;
+}
+
+RenderStateCache::ThreadBinding::~ThreadBinding()
+{
+    t_cache = m_previousCache;
+}
+
+
+RenderStateCache * RenderStateCache::current()
+{
+    return t_cache;
+}
+
+void RenderStateCache::applyCapability(gl::GLenum capability, bool enabled)
+{
+    if (t_cache && !t_cache->updateCapability(capability, enabled))
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        gl::glEnable(capability);
+    }
+    else
+    {
+        gl::glDisable(capability);
+    }
+}
+
+void RenderStateCache::vertexArrayChanged()
+{
+    if (t_cache)
+    {
+        t_cache->invalidateVertexArray();
+    }
+}
+
+void RenderStateCache::texturesChanged()
+{
+    if (t_cache)
+    {
+        t_cache->invalidateTextures();
+    }
+}
+
+RenderStateCache::RenderStateCache()
+: m_vertexArray(s_unknown)
+, m_avoidedCalls(0)
+{
+}
+
+RenderStateCache::~RenderStateCache()
+{
+}
+
+void RenderStateCache::invalidate()
+{
+    m_vertexArray = s_unknown;
+
+    invalidateTextures();
+
+    for (auto & target : m_buffers)
+    {
+        std::fill(target.second.begin(), target.second.end(), s_unknown);
+    }
+
+    invalidateCapabilities();
+}
+
+void RenderStateCache::invalidateCapabilities()
+{
+    m_capabilities.clear();
+}
+
+void RenderStateCache::invalidateVertexArray()
+{
+    m_vertexArray = s_unknown;
+}
+
+void RenderStateCache::invalidateTextures()
+{
+    // Keep the allocated lists, so recording bindings does not allocate in each frame
+    std::fill(m_textures.begin(), m_textures.end(), s_unknown);
+    std::fill(m_samplers.begin(), m_samplers.end(), s_unknown);
+}
+
+bool RenderStateCache::updateVertexArray(gl::GLuint vertexArray)
+{
+    return update(m_vertexArray, vertexArray);
+}
+
+bool RenderStateCache::updateTexture(std::size_t unit, gl::GLuint texture)
+{
+    return update(m_textures, unit, texture);
+}
+
+bool RenderStateCache::updateSampler(std::size_t unit, gl::GLuint sampler)
+{
+    return update(m_samplers, unit, sampler);
+}
+
+bool RenderStateCache::updateBufferBase(gl::GLenum target, std::size_t index, gl::GLuint buffer)
+{
+    // There are only a few indexed targets, so a linear search is fastest
+    auto it = std::find_if(m_buffers.begin(), m_buffers.end(), [target] (const std::pair<gl::GLenum, std::vector<gl::GLuint>> & bindings)
+    {
+        return bindings.first == target;
+    });
+
+    if (it == m_buffers.end())
+    {
+        m_buffers.emplace_back(target, std::vector<gl::GLuint>());
+        it = m_buffers.end() - 1;
+    }
+
+    return update(it->second, index, buffer);
+}
+
+void RenderStateCache::invalidateBufferBase(gl::GLenum target, std::size_t index)
+{
+    for (auto & bindings : m_buffers)
+    {
+        if (bindings.first == target && index < bindings.second.size())
+        {
+            bindings.second[index] = s_unknown;
+        }
+    }
+}
+
+bool RenderStateCache::updateCapability(gl::GLenum capability, bool enabled)
+{
+    auto it = std::find_if(m_capabilities.begin(), m_capabilities.end(), [capability] (const std::pair<gl::GLenum, bool> & state)
+    {
+        return state.first == capability;
+    });
+
+    if (it == m_capabilities.end())
+    {
+        m_capabilities.emplace_back(capability, enabled);
+        return true;
+    }
+
+    if (it->second == enabled)
+    {
+        ++m_avoidedCalls;
+        return false;
+    }
+
+    it->second = enabled;
+    return true;
+}
+
+std::uint64_t RenderStateCache::avoidedCalls() const
+{
+    return m_avoidedCalls;
+}
+
+void RenderStateCache::resetAvoidedCalls()
+{
+    m_avoidedCalls = 0;
+}
+
+bool RenderStateCache::update(std::vector<gl::GLuint> & bindings, std::size_t index, gl::GLuint name)
+{
+    if (index >= bindings.size())
+    {
+        bindings.resize(index + 1, s_unknown);
+    }
+
+    return update(bindings[index], name);
+}
+
+bool RenderStateCache::update(gl::GLuint & binding, gl::GLuint name)
+{
+    if (binding == name)
+    {
+        ++m_avoidedCalls;
+        return false;
+    }
+
+    binding = name;
+    return true;
+}
+
+
+} // namespace gloperate
@@ -0,0 +1,273 @@
+
+#include <gloperate/rendering/RenderTargetPool.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Texture.h>
+#include <globjects/Renderbuffer.h>
+
+#include <gloperate/rendering/FramebufferCache.h>
+#include <gloperate/rendering/RenderStateCache.h>
+
+
+namespace
+{
+
+
+const auto s_unknownLifetime = std::numeric_limits<std::size_t>::max(); ///< Last stage of clients with unknown lifetime
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+RenderTargetPool::RenderTargetPool()
+: m_lifetimesOutdated(false)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+}
+
+void RenderTargetPool::addClient(const Stage * client)
+{
+    if (m_clients.find(client) != m_clients.end())
+    {
+        return;
+    }
+
+    // Overlap with all other clients until the lifetimes are known
+    Client entry;
+    entry.first    = 0;
+    entry.last     = s_unknownLifetime;
+    entry.resource = nullptr;
+
+    m_clients[client] = entry;
+
+    m_lifetimesOutdated = true;
+}
+
+void RenderTargetPool::removeClient(const Stage * client)
+{
+    const auto it = m_clients.find(client);
+    if (it == m_clients.end())
+    {
+        return;
+    }
+
+    unassign(client, it->second);
+
+    m_clients.erase(it);
+}
+
+bool RenderTargetPool::isClient(const Stage * client) const
+{
+    return m_clients.find(client) != m_clients.end();
+}
+
+bool RenderTargetPool::lifetimesOutdated() const
+{
+    return m_lifetimesOutdated;
+}
+
+bool RenderTargetPool::setLifetime(const Stage * client, std::size_t first, std::size_t last)
+{
+    const auto it = m_clients.find(client);
+    if (it == m_clients.end() || (it->second.first == first && it->second.last == last))
+    {
+        return false;
+    }
+
+    it->second.first = first;
+    it->second.last  = last;
+
+    return true;
+}
+
+std::pair<std::size_t, std::size_t> RenderTargetPool::lifetime(const Stage * client) const
+{
+    const auto it = m_clients.find(client);
+    if (it == m_clients.end())
+    {
+        return std::make_pair(std::size_t(0), s_unknownLifetime);
+    }
+
+    return std::make_pair(it->second.first, it->second.last);
+}
+
+bool RenderTargetPool::isShared(const Stage * client) const
+{
+    const auto it = m_clients.find(client);
+    if (it == m_clients.end() || !it->second.resource)
+    {
+        return false;
+    }
+
+    return it->second.resource->users.size() > 1;
+}
+
+void RenderTargetPool::reassign()
+{
+    m_lifetimesOutdated = false;
+
+    for (auto & resource : m_resources)
+    {
+        resource->users.clear();
+    }
+
+    for (auto & client : m_clients)
+    {
+        client.second.resource = nullptr;
+    }
+}
+
+globjects::Texture * RenderTargetPool::obtainTexture(const Stage * client, gl::GLenum internalFormat, gl::GLenum format, gl::GLenum type, int width, int height)
+{
+    const auto resource = assign(client, false, internalFormat, width, height);
+
+    if (!resource->texture)
+    {
+        resource->texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
+        resource->texture->image2D(0, internalFormat, width, height, 0, format, type, nullptr);
+
+        RenderStateCache::texturesChanged();
+    }
+
+    return resource->texture.get();
+}
+
+globjects::Renderbuffer * RenderTargetPool::obtainRenderbuffer(const Stage * client, gl::GLenum internalFormat, int width, int height)
+{
+    const auto resource = assign(client, true, internalFormat, width, height);
+
+    if (!resource->renderbuffer)
+    {
+        resource->renderbuffer = cppassist::make_unique<globjects::Renderbuffer>();
+        resource->renderbuffer->storage(internalFormat, width, height);
+    }
+
+    return resource->renderbuffer.get();
+}
+
+std::size_t RenderTargetPool::size() const
+{
+    return m_resources.size();
+}
+
+void RenderTargetPool::collectGarbage()
+{
+    m_resources.erase(std::remove_if(m_resources.begin(), m_resources.end(), [] (const std::unique_ptr<Resource> & resource)
+    {
+        if (!resource->users.empty())
+        {
+            return false;
+        }
+
+        FramebufferCache::releaseTexture(resource->texture.get());
+        FramebufferCache::releaseRenderbuffer(resource->renderbuffer.get());
+
+        return true;
+    }), m_resources.end());
+}
+
+void RenderTargetPool::clear()
+{
+    for (auto & resource : m_resources)
+    {
+        FramebufferCache::releaseTexture(resource->texture.get());
+        FramebufferCache::releaseRenderbuffer(resource->renderbuffer.get());
+    }
+
+    m_resources.clear();
+
+    for (auto & client : m_clients)
+    {
+        client.second.resource = nullptr;
+    }
+}
+
+RenderTargetPool::Resource * RenderTargetPool::assign(const Stage * client, bool isRenderbuffer, gl::GLenum internalFormat, int width, int height)
+{
+    addClient(client);
+
+    auto & entry = m_clients[client];
+
+    const auto matches = [isRenderbuffer, internalFormat, width, height] (const Resource & resource)
+    {
+        return resource.isRenderbuffer == isRenderbuffer
+            && resource.internalFormat == internalFormat
+            && resource.width          == width
+            && resource.height         == height;
+    };
+
+    // Keep current storage if the request has not changed
+    if (entry.resource && matches(*entry.resource))
+    {
+        return entry.resource;
+    }
+
+    unassign(client, entry);
+
+    // Share storage with clients whose lifetimes do not overlap
+    for (auto & resource : m_resources)
+    {
+        if (!matches(*resource))
+        {
+            continue;
+        }
+
+        const auto overlaps = std::any_of(resource->users.begin(), resource->users.end(), [this, &entry] (const Stage * user)
+        {
+            const auto & other = m_clients.at(user);
+
+            return other.first <= entry.last && entry.first <= other.last;
+        });
+
+        if (!overlaps)
+        {
+            resource->users.push_back(client);
+            entry.resource = resource.get();
+
+            return entry.resource;
+        }
+    }
+
+    // Allocate new storage
+    auto resource = cppassist::make_unique<Resource>();
+    resource->isRenderbuffer = isRenderbuffer;
+    resource->internalFormat = internalFormat;
+    resource->width          = width;
+    resource->height         = height;
+    resource->users.push_back(client);
+
+    entry.resource = resource.get();
+
+    m_resources.push_back(std::move(resource));
+
+    return entry.resource;
+}
+
+void RenderTargetPool::unassign(const Stage * client, Client & entry)
+{
+    if (!entry.resource)
+    {
+        return;
+    }
+
+    auto & users = entry.resource->users;
+    users.erase(std::remove(users.begin(), users.end(), client), users.end());
+
+    entry.resource = nullptr;
+}
+
+
+} // namespace gloperate
@@ -15,6 +15,7 @@
 #include <globjects/base/File.h>
 
 #include <gloperate/gloperate.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate
@@ -88,7 +89,7 @@ void ScreenAlignedQuad::draw() const
     m_texture->bind();
 
     // Disable depth test for screen-aligned quad
-    gl::glDisable(gl::GL_DEPTH_TEST);
+    RenderStateCache::applyCapability(gl::GL_DEPTH_TEST, false);
 
     // Draw geometry
     m_program->use();
@@ -97,6 +98,13 @@ void ScreenAlignedQuad::draw() const
 
     // Unbind texture
     m_texture->unbind();
+
+    // Keep render state cache in sync with the texture binding changed above
+    // (the vertex array is bound by the drawable through the cache)
+    if (const auto cache = RenderStateCache::current())
+    {
+        cache->updateTexture(0, 0);
+    }
 }
 
 void ScreenAlignedQuad::initialize()
@@ -15,6 +15,7 @@
 #include <globjects/base/File.h>
 
 #include <gloperate/rendering/ScreenAlignedQuad.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate
@@ -73,7 +74,7 @@ void ScreenAlignedTriangle::draw() const
     m_texture->bind();
 
     // Disable depth test for screen-aligned quad
-    gl::glDisable(gl::GL_DEPTH_TEST);
+    RenderStateCache::applyCapability(gl::GL_DEPTH_TEST, false);
 
     // Draw geometry
     m_program->use();
@@ -82,6 +83,13 @@ void ScreenAlignedTriangle::draw() const
 
     // Unbind texture
     m_texture->unbind();
+
+    // Keep render state cache in sync with the texture binding changed above
+    // (the vertex array is bound by the drawable through the cache)
+    if (const auto cache = RenderStateCache::current())
+    {
+        cache->updateTexture(0, 0);
+    }
 }
 
 void ScreenAlignedTriangle::initialize()
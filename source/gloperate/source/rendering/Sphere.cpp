@@ -11,6 +11,18 @@
 
 #include <globjects/Buffer.h>
 
+#include <gloperate/rendering/Icosahedron.h>
+
+
+namespace
+{
+
+
+const unsigned int s_levels = 5; ///< Number of refinement levels of the icosahedron
+
+
+} // namespace
+
 
 namespace gloperate
 {
@@ -19,53 +31,48 @@ namespace gloperate
 Sphere::Sphere(float radius, cppassist::Flags<ShapeOption> options)
 : Shape(ShapeType::Sphere, options)
 {
-    // Create icosahedron
-    m_icosahedron = cppassist::make_unique<Icosahedron>();
-    m_icosahedron->generateGeometry(5);
+    const auto texCoords = static_cast<bool>(options & ShapeOption::IncludeTexCoords);
 
-    // Create drawable
-    m_drawable = cppassist::make_unique<Drawable>();
-    m_drawable->setPrimitiveMode(gl::GL_TRIANGLES);
-    m_drawable->setDrawMode(gloperate::DrawMode::ElementsIndexBuffer);
-    m_drawable->setSize(m_icosahedron->indices().size() * std::tuple_size<Icosahedron::Face>::value);
+    // Obtain geometry, which is shared with other spheres of the context
+    if (const auto library = GeometryLibrary::current())
+    {
+        m_geometry = library->sphere(radius, s_levels, texCoords);
+    }
+    else
+    {
+        Icosahedron icosahedron;
+        icosahedron.generateGeometry(s_levels);
 
-    // Create vertex buffer
-    auto vertices = m_icosahedron->vertices();
+        if (texCoords)
+        {
+            icosahedron.generateTextureCoordinates();
+        }
 
-    for (auto & vertex : vertices)
-    {
-        vertex *= radius;
+        m_geometry = GeometryLibrary::createSphere(icosahedron, radius, texCoords);
     }
 
-    m_vertices = cppassist::make_unique<globjects::Buffer>();
-    m_vertices->setData(vertices, gl::GL_STATIC_DRAW);
+    // Create drawable
+    m_drawable = cppassist::make_unique<Drawable>();
+    m_drawable->setPrimitiveMode(gl::GL_TRIANGLES);
+    m_drawable->setDrawMode(gloperate::DrawMode::ElementsIndexBuffer);
+    m_drawable->setSize(m_geometry->size);
 
     m_drawable->bindAttribute(0, 0);
-    m_drawable->setBuffer(0, m_vertices.get());
+    m_drawable->setBuffer(0, m_geometry->vertices.get());
     m_drawable->setAttributeBindingBuffer(0, 0, 0, sizeof(glm::vec3));
     m_drawable->setAttributeBindingFormat(0, 3, gl::GL_FLOAT, gl::GL_FALSE, 0);
     m_drawable->enableAttributeBinding(0);
 
-    // Create texture coordinate buffer
-    if (options & ShapeOption::IncludeTexCoords)
+    if (m_geometry->texCoords)
     {
-        m_icosahedron->generateTextureCoordinates();
-
-        m_texCoords = cppassist::make_unique<globjects::Buffer>();
-        m_texCoords->setData(m_icosahedron->texcoords(), gl::GL_STATIC_DRAW);
-
         m_drawable->bindAttribute(1, 1);
-        m_drawable->setBuffer(1, m_texCoords.get());
+        m_drawable->setBuffer(1, m_geometry->texCoords.get());
         m_drawable->setAttributeBindingBuffer(1, 1, 0, sizeof(glm::vec2));
         m_drawable->setAttributeBindingFormat(1, 2, gl::GL_FLOAT, gl::GL_FALSE, 0);
         m_drawable->enableAttributeBinding(1);
     }
 
-    // Create index buffer
-    m_indices = cppassist::make_unique<globjects::Buffer>();
-    m_indices->setData(m_icosahedron->indices(), gl::GL_STATIC_DRAW);
-
-    m_drawable->setIndexBuffer(m_indices.get(), gl::GL_UNSIGNED_SHORT);
+    m_drawable->setIndexBuffer(m_geometry->indices.get(), gl::GL_UNSIGNED_SHORT);
 }
 
 Sphere::~Sphere()
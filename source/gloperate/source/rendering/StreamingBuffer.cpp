@@ -0,0 +1,195 @@
+
+#include <gloperate/rendering/StreamingBuffer.h>
+
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const std::size_t s_alignment = 256;        ///< Alignment of regions, satisfies the offset alignment of buffer textures and uniform buffers
+const GLuint64    s_waitTimeout = 1000000;  ///< Timeout of a single wait for a fence in nanoseconds
+
+
+std::size_t alignedSize(std::size_t size)
+{
+    return std::max((size + s_alignment - 1) / s_alignment * s_alignment, s_alignment);
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+StreamingBuffer::StreamingBuffer(std::size_t regionSize, std::size_t numRegions)
+: m_fences(std::max(numRegions, std::size_t(1)))
+, m_regionSize(alignedSize(regionSize))
+, m_region(0)
+, m_persistent(false)
+, m_mapped(false)
+, m_data(nullptr)
+{
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    if (m_buffer && (m_persistent || m_mapped))
+    {
+        m_buffer->unmap();
+    }
+}
+
+globjects::Buffer * StreamingBuffer::buffer() const
+{
+    return m_buffer.get();
+}
+
+std::size_t StreamingBuffer::offset() const
+{
+    return m_region * m_regionSize;
+}
+
+std::size_t StreamingBuffer::regionSize() const
+{
+    return m_regionSize;
+}
+
+std::size_t StreamingBuffer::numRegions() const
+{
+    return m_fences.size();
+}
+
+bool StreamingBuffer::persistent() const
+{
+    return m_persistent;
+}
+
+void * StreamingBuffer::map(std::size_t size)
+{
+    unmap();
+
+    if (m_buffer && size <= m_regionSize)
+    {
+        // Guard the region against writes until the commands issued since it has been written are finished
+        m_fences[m_region] = globjects::Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+
+        m_region = (m_region + 1) % m_fences.size();
+
+        waitForRegion(m_region);
+    }
+    else
+    {
+        while (m_regionSize < size)
+        {
+            m_regionSize *= 2;
+        }
+
+        allocate();
+    }
+
+    if (!m_buffer)
+    {
+        return nullptr;
+    }
+
+    m_mapped = true;
+
+    if (m_persistent)
+    {
+        return m_data + offset();
+    }
+
+    return m_buffer->mapRange(offset(), m_regionSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamingBuffer::unmap()
+{
+    if (!m_mapped)
+    {
+        return;
+    }
+
+    // Coherent mappings make writes visible without unmapping
+    if (!m_persistent)
+    {
+        m_buffer->unmap();
+    }
+
+    m_mapped = false;
+}
+
+void StreamingBuffer::allocate()
+{
+    if (m_buffer && m_persistent)
+    {
+        m_buffer->unmap();
+    }
+
+    // Commands still reading the previous buffer keep it alive until they are finished
+    m_buffer = cppassist::make_unique<globjects::Buffer>();
+    m_data   = nullptr;
+    m_region = 0;
+
+    for (auto & fence : m_fences)
+    {
+        fence = nullptr;
+    }
+
+    const auto size = m_regionSize * m_fences.size();
+
+    m_persistent = globjects::hasExtension(GLextension::GL_ARB_buffer_storage);
+
+    if (m_persistent)
+    {
+        m_buffer->setStorage(size, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        m_data = static_cast<unsigned char *>(m_buffer->mapRange(0, size, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+
+        if (!m_data)
+        {
+            m_buffer = nullptr;
+        }
+    }
+    else
+    {
+        m_buffer->setData(size, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+void StreamingBuffer::waitForRegion(std::size_t region)
+{
+    auto & fence = m_fences[region];
+    if (!fence)
+    {
+        return;
+    }
+
+    // Flush once, so the fence is guaranteed to be signaled eventually
+    auto result = fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, s_waitTimeout);
+
+    while (result == GL_TIMEOUT_EXPIRED)
+    {
+        result = fence->clientWait(GL_NONE_BIT, s_waitTimeout);
+    }
+
+    fence = nullptr;
+}
+
+
+} // namespace gloperate
@@ -0,0 +1,136 @@
+
+#include <gloperate/rendering/UniformRing.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+
+#include <gloperate/rendering/StreamingBuffer.h>
+#include <gloperate/rendering/RenderStateCache.h>
+
+
+namespace
+{
+
+
+thread_local gloperate::UniformRing * t_ring = nullptr; ///< Ring bound to the current thread
+
+const std::size_t s_alignment = 256; ///< Alignment of constants, satisfies GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+UniformRing::ThreadBinding::ThreadBinding(UniformRing * ring)
+: m_previousRing(t_ring)
+{
+    t_ring = ring;
+}
+
+UniformRing::ThreadBinding::~ThreadBinding()
+{
+    t_ring = m_previousRing;
+}
+
+
+UniformRing * UniformRing::current()
+{
+    return t_ring;
+}
+
+UniformRing::UniformRing(std::size_t regionSize, std::size_t numRegions)
+: m_buffer(cppassist::make_unique<StreamingBuffer>(regionSize, numRegions))
+, m_overflow(nullptr)
+, m_data(nullptr)
+, m_used(0)
+, m_ready(false)
+{
+}
+
+UniformRing::~UniformRing()
+{
+}
+
+void UniformRing::beginFrame()
+{
+    // Grow the region if the previous frame has run out of space
+    const auto data = m_buffer->map(m_used);
+
+    // Without persistent mapping, the region is written while it is in use
+    if (data && !m_buffer->persistent())
+    {
+        m_buffer->unmap();
+    }
+
+    m_data  = m_buffer->persistent() ? static_cast<unsigned char *>(data) : nullptr;
+    m_ready = data != nullptr;
+    m_used  = 0;
+}
+
+bool UniformRing::bind(std::size_t index, const void * data, std::size_t size)
+{
+    const auto offset = (m_used + s_alignment - 1) / s_alignment * s_alignment;
+
+    // Failed allocations count as well, so the region fits all constants in the next frame
+    m_used = offset + size;
+
+    if (!m_ready || m_used > m_buffer->regionSize())
+    {
+        // Respecifying the data store orphans the previous one, so draw calls that are still pending keep their constants
+        if (!m_overflow)
+        {
+            m_overflow = cppassist::make_unique<globjects::Buffer>();
+        }
+
+        m_overflow->setData(size, data, gl::GL_STREAM_DRAW);
+        m_overflow->bindBase(gl::GL_UNIFORM_BUFFER, index);
+
+        if (const auto cache = RenderStateCache::current())
+        {
+            cache->invalidateBufferBase(gl::GL_UNIFORM_BUFFER, index);
+        }
+
+        return false;
+    }
+
+    const auto bufferOffset = m_buffer->offset() + offset;
+
+    if (m_data)
+    {
+        std::memcpy(m_data + offset, data, size);
+    }
+    else
+    {
+        m_buffer->buffer()->setSubData(bufferOffset, size, data);
+    }
+
+    m_buffer->buffer()->bindRange(gl::GL_UNIFORM_BUFFER, index, bufferOffset, size);
+
+    if (const auto cache = RenderStateCache::current())
+    {
+        cache->invalidateBufferBase(gl::GL_UNIFORM_BUFFER, index);
+    }
+
+    return true;
+}
+
+void UniformRing::clear()
+{
+    m_buffer   = cppassist::make_unique<StreamingBuffer>(m_buffer->regionSize(), m_buffer->numRegions());
+    m_overflow = nullptr;
+    m_data     = nullptr;
+    m_used   = 0;
+    m_ready  = false;
+}
+
+
+} // namespace gloperate
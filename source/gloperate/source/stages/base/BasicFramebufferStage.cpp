@@ -9,6 +9,8 @@
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/DepthRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
+#include <gloperate/rendering/FramebufferCache.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate
@@ -51,6 +53,8 @@ void BasicFramebufferStage::onContextInit(AbstractGLContext *)
 void BasicFramebufferStage::onContextDeinit(AbstractGLContext *)
 {
     // Clean up OpenGL objects
+    FramebufferCache::releaseTexture(m_colorTexture.get());
+    FramebufferCache::releaseTexture(m_depthTexture.get());
     m_colorBuffer         = nullptr;
     m_depthBuffer         = nullptr;
     m_colorTexture        = nullptr;
@@ -66,6 +70,9 @@ void BasicFramebufferStage::onProcess()
 
     m_depthTexture->image2D(0, gl::GL_DEPTH_COMPONENT, size.x, size.y, 0, gl::GL_DEPTH_COMPONENT, gl::GL_FLOAT, nullptr);
 
+    // Resizing may have bound the textures
+    RenderStateCache::texturesChanged();
+
     // Update outputs
     this->colorTexture.setValue(m_colorTexture.get());
     this->depthTexture.setValue(m_depthTexture.get());
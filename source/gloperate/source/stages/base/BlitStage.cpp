@@ -67,37 +67,40 @@ void BlitStage::onProcess()
         static_cast<gl::GLint>((*targetViewport).w)
     }};
 
-    globjects::Framebuffer * sourceFBO = RenderInterface::obtainFBO(0, *source, m_sourceFBO.get(), m_defaultFBO.get());
+    auto sourceChanged = false;
+    globjects::Framebuffer * sourceFBO = RenderInterface::obtainFBO(0, *source, m_sourceFBO.get(), m_defaultFBO.get(), &sourceChanged);
     auto sourceAttachment = source->drawBufferAttachment(0);
 
     if (*source == *target)
     {
         m_intermediateBuffer->storage(gl::GL_RGBA, sourceRect[2], sourceRect[3]);
 
-        globjects::Framebuffer * intermediateFBO = RenderInterface::obtainFBO(0, m_intermediateTarget.get(), m_intermediateFBO.get(), nullptr);
+        auto intermediateChanged = false;
+        globjects::Framebuffer * intermediateFBO = RenderInterface::obtainFBO(0, m_intermediateTarget.get(), m_intermediateFBO.get(), nullptr, &intermediateChanged);
         auto intermediateAttachment = target->drawBufferAttachment(0);
 
-        sourceFBO->printStatus(true);
-        intermediateFBO->printStatus(true);
+        RenderInterface::validateFBO(sourceFBO, sourceChanged);
+        RenderInterface::validateFBO(intermediateFBO, intermediateChanged);
         sourceFBO->blit(sourceAttachment, sourceRect, intermediateFBO, intermediateAttachment, sourceRect, gl::GL_COLOR_BUFFER_BIT, *minFilter);
 
         sourceFBO = intermediateFBO;
         sourceAttachment = intermediateAttachment;
+        sourceChanged = false;
     }
 
-    globjects::Framebuffer * targetFBO = RenderInterface::obtainFBO(0, *target, m_targetFBO.get(), m_defaultFBO.get());
+    auto targetChanged = false;
+    globjects::Framebuffer * targetFBO = RenderInterface::obtainFBO(0, *target, m_targetFBO.get(), m_defaultFBO.get(), &targetChanged);
     auto targetAttachment = target->drawBufferAttachment(0);
 
+    RenderInterface::validateFBO(sourceFBO, sourceChanged);
+    RenderInterface::validateFBO(targetFBO, targetChanged);
+
     if (sourceRect[2] <= targetRect[2] && sourceRect[3] <= targetRect[3])
     {
-        sourceFBO->printStatus(true);
-        targetFBO->printStatus(true);
         sourceFBO->blit(sourceAttachment, sourceRect, targetFBO, targetAttachment, targetRect, gl::GL_COLOR_BUFFER_BIT, *magFilter);
     }
     else
     {
-        sourceFBO->printStatus(true);
-        targetFBO->printStatus(true);
         sourceFBO->blit(sourceAttachment, sourceRect, targetFBO, targetAttachment, targetRect, gl::GL_COLOR_BUFFER_BIT, *minFilter);
     }
 
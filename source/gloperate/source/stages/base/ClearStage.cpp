@@ -13,6 +13,7 @@
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/DepthRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace
@@ -230,7 +231,7 @@ void ClearStage::onProcess()
         {
             // Setup OpenGL state
             gl::glScissor(renderInterface.viewport->x, renderInterface.viewport->y, renderInterface.viewport->z, renderInterface.viewport->w);
-            gl::glEnable(gl::GL_SCISSOR_TEST);
+            RenderStateCache::applyCapability(gl::GL_SCISSOR_TEST, true);
 
             // Scissor is enabled
             scissorEnabled = true;
@@ -238,7 +239,7 @@ void ClearStage::onProcess()
         else
         {
             // Clear full render targets if viewport has invalid size
-            gl::glDisable(gl::GL_SCISSOR_TEST);
+            RenderStateCache::applyCapability(gl::GL_SCISSOR_TEST, false);
         }
 
         // Clear all render targets
@@ -273,7 +274,7 @@ void ClearStage::onProcess()
         // Reset OpenGL state
         if (scissorEnabled)
         {
-            gl::glDisable(gl::GL_SCISSOR_TEST);
+            RenderStateCache::applyCapability(gl::GL_SCISSOR_TEST, false);
         }
     }
 
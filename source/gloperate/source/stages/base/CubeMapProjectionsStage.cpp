@@ -30,6 +30,11 @@ void CubeMapProjectionsStage::onContextInit(gloperate::AbstractGLContext * /*con
 {
 }
 
+bool CubeMapProjectionsStage::requiresContext() const
+{
+    return false;
+}
+
 void CubeMapProjectionsStage::onProcess()
 {
     const auto c = *center;
@@ -8,6 +8,8 @@
 
 #include <gloperate/base/Environment.h>
 #include <gloperate/base/ResourceManager.h>
+#include <gloperate/base/ResourceCache.h>
+#include <gloperate/rendering/RenderPass.h>
 
 #include <gloperate/gloperate.h>
 
@@ -42,10 +44,28 @@ ProgramStage::~ProgramStage()
 void ProgramStage::onContextInit(AbstractGLContext *)
 {
     m_program = cppassist::make_unique<globjects::Program>();
+
+    // Invalidate output when a shader file has been modified (notified on the render thread of the context)
+    if (auto cache = ResourceCache::current())
+    {
+        m_resourceChangedConnection = cache->resourceChanged.connect([this] (const std::string & path)
+        {
+            for (auto input : inputs<cppfs::FilePath>())
+            {
+                if (path == ResourceManager::canonicalPath((*input)->path()))
+                {
+                    program.invalidate();
+                    return;
+                }
+            }
+        });
+    }
 }
 
 void ProgramStage::onContextDeinit(AbstractGLContext *)
 {
+    m_resourceChangedConnection = cppexpose::Connection();
+
     // Clean up OpenGL objects
     m_shaders.clear();
     m_program = nullptr;
@@ -68,16 +88,23 @@ void ProgramStage::onProcess()
         }
     }
 
-    // Load and attach all shaders from inputs of type FilePath
+    // Release shaders of the previous files
+    m_shaders.clear();
+
+    // Get and attach all shaders from inputs of type FilePath
     for (auto input : inputs<cppfs::FilePath>())
     {
-        if (auto shader = environment()->resourceManager()->load<globjects::Shader>((*input)->path()))
+        if (auto shader = environment()->resourceManager()->get<globjects::Shader>((*input)->path()))
         {
-            m_shaders.emplace_back(shader);
-            m_program->attach(shader);
+            m_program->attach(shader.get());
+            m_shaders.push_back(std::move(shader));
         }
     }
 
+    // Link now, so the constant blocks can be bound to the indices of the canvas and render passes
+    m_program->link();
+    RenderPass::bindConstantBlocks(m_program.get());
+
     // Update output
     program.setValue(m_program.get());
 }
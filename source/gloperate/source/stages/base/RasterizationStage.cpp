@@ -53,14 +53,12 @@ void RasterizationStage::onProcess()
         const glm::vec4 & viewport = *renderInterface.viewport;
         gl::glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 
-        // Configure FBO
+        // Configure FBO (validated by the render interface if the render targets have changed)
         auto fbo = renderInterface.obtainFBO();
 
         // Bind FBO
         fbo->bind(gl::GL_FRAMEBUFFER);
 
-        fbo->printStatus(true);
-
         // Render the drawable
         (*drawable)->draw();
 
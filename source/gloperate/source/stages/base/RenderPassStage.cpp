@@ -16,6 +16,7 @@
 #include <gloperate/rendering/RenderPass.h>
 #include <gloperate/rendering/Drawable.h>
 #include <gloperate/rendering/Camera.h>
+#include <gloperate/rendering/FrameConstants.h>
 
 
 namespace gloperate
@@ -78,6 +79,7 @@ void RenderPassStage::onProcess()
     bool hasModelMatrix = (this->modelMatrix.isValid());
     const glm::mat4 modelMatrix = hasModelMatrix ? *this->modelMatrix : glm::mat4(1.0f);
 
+    // Transformations are still set as uniforms for shaders that do not use the transform constants
     if (camera)
     {
         (*program)->setUniform<glm::mat4>("viewProjectionMatrix",         camera->viewProjectionMatrix());
@@ -103,6 +105,16 @@ void RenderPassStage::onProcess()
         (*program)->setUniform<glm::mat3>("modelNormalMatrix",                 glm::inverseTranspose(glm::mat3(camera->viewMatrix() * modelMatrix)));
     }
 
+    // Provide transformations as constants of the render pass, which are bound per draw call (identity without a camera)
+    TransformConstants transform;
+    transform.viewMatrix                = camera ? camera->viewMatrix()           : glm::mat4(1.0f);
+    transform.projectionMatrix          = camera ? camera->projectionMatrix()     : glm::mat4(1.0f);
+    transform.viewProjectionMatrix      = camera ? camera->viewProjectionMatrix() : glm::mat4(1.0f);
+    transform.modelMatrix               = modelMatrix;
+    transform.modelViewProjectionMatrix = transform.viewProjectionMatrix * modelMatrix;
+
+    m_renderPass->setUniformBlock(TransformConstants::binding, transform);
+
     // Update OpenGL states
     if (*this->depthTest) m_renderPass->stateBefore()->enable (gl::GL_DEPTH_TEST);
     else                  m_renderPass->stateBefore()->disable(gl::GL_DEPTH_TEST);
@@ -131,7 +143,7 @@ void RenderPassStage::onProcess()
         if (input->type() == typeid(globjects::Texture *))
         {
             // Get texture
-            globjects::Texture * texture = static_cast<Input<globjects::Texture *> *>(input)->value();
+            globjects::Texture * texture = **static_cast<Input<globjects::Texture *> *>(input);
 
             if (!texture)
                 continue;
@@ -152,7 +164,7 @@ void RenderPassStage::onProcess()
         else if (input->type() == typeid(globjects::Buffer *))
         {
             // Get buffer
-            globjects::Buffer * buffer = static_cast<Input<globjects::Buffer *> *>(input)->value();
+            globjects::Buffer * buffer = **static_cast<Input<globjects::Buffer *> *>(input);
 
             if (!buffer)
                 continue;
@@ -186,101 +198,101 @@ void RenderPassStage::onProcess()
 void RenderPassStage::setUniformValue(globjects::Program * program, AbstractSlot * input)
 {
     if (input->type() == typeid(float)) {
-        program->setUniform<float>(input->name(), static_cast<Input<float> *>(input)->value());
+        program->setUniform<float>(input->name(), **static_cast<Input<float> *>(input));
     } else if (input->type() == typeid(int)) {
-        program->setUniform<int>(input->name(), static_cast<Input<int> *>(input)->value());
+        program->setUniform<int>(input->name(), **static_cast<Input<int> *>(input));
     } else if (input->type() == typeid(unsigned int)) {
-        program->setUniform<unsigned int>(input->name(), static_cast<Input<unsigned int> *>(input)->value());
+        program->setUniform<unsigned int>(input->name(), **static_cast<Input<unsigned int> *>(input));
     } else if (input->type() == typeid(bool)) {
-        program->setUniform<bool>(input->name(), static_cast<Input<bool> *>(input)->value());
+        program->setUniform<bool>(input->name(), **static_cast<Input<bool> *>(input));
     } else if (input->type() == typeid(glm::vec2)) {
-        program->setUniform<glm::vec2>(input->name(), static_cast<Input<glm::vec2> *>(input)->value());
+        program->setUniform<glm::vec2>(input->name(), **static_cast<Input<glm::vec2> *>(input));
     } else if (input->type() == typeid(glm::vec3)) {
-        program->setUniform<glm::vec3>(input->name(), static_cast<Input<glm::vec3> *>(input)->value());
+        program->setUniform<glm::vec3>(input->name(), **static_cast<Input<glm::vec3> *>(input));
     } else if (input->type() == typeid(glm::vec4)) {
-        program->setUniform<glm::vec4>(input->name(), static_cast<Input<glm::vec4> *>(input)->value());
+        program->setUniform<glm::vec4>(input->name(), **static_cast<Input<glm::vec4> *>(input));
     } else if (input->type() == typeid(glm::ivec2)) {
-        program->setUniform<glm::ivec2>(input->name(), static_cast<Input<glm::ivec2> *>(input)->value());
+        program->setUniform<glm::ivec2>(input->name(), **static_cast<Input<glm::ivec2> *>(input));
     } else if (input->type() == typeid(glm::ivec3)) {
-        program->setUniform<glm::ivec3>(input->name(), static_cast<Input<glm::ivec3> *>(input)->value());
+        program->setUniform<glm::ivec3>(input->name(), **static_cast<Input<glm::ivec3> *>(input));
     } else if (input->type() == typeid(glm::ivec4)) {
-        program->setUniform<glm::ivec4>(input->name(), static_cast<Input<glm::ivec4> *>(input)->value());
+        program->setUniform<glm::ivec4>(input->name(), **static_cast<Input<glm::ivec4> *>(input));
     } else if (input->type() == typeid(glm::uvec2)) {
-        program->setUniform<glm::uvec2>(input->name(), static_cast<Input<glm::uvec2> *>(input)->value());
+        program->setUniform<glm::uvec2>(input->name(), **static_cast<Input<glm::uvec2> *>(input));
     } else if (input->type() == typeid(glm::uvec3)) {
-        program->setUniform<glm::uvec3>(input->name(), static_cast<Input<glm::uvec3> *>(input)->value());
+        program->setUniform<glm::uvec3>(input->name(), **static_cast<Input<glm::uvec3> *>(input));
     } else if (input->type() == typeid(glm::uvec4)) {
-        program->setUniform<glm::uvec4>(input->name(), static_cast<Input<glm::uvec4> *>(input)->value());
+        program->setUniform<glm::uvec4>(input->name(), **static_cast<Input<glm::uvec4> *>(input));
     } else if (input->type() == typeid(glm::mat2)) {
-        program->setUniform<glm::mat2>(input->name(), static_cast<Input<glm::mat2> *>(input)->value());
+        program->setUniform<glm::mat2>(input->name(), **static_cast<Input<glm::mat2> *>(input));
     } else if (input->type() == typeid(glm::mat3)) {
-        program->setUniform<glm::mat3>(input->name(), static_cast<Input<glm::mat3> *>(input)->value());
+        program->setUniform<glm::mat3>(input->name(), **static_cast<Input<glm::mat3> *>(input));
     } else if (input->type() == typeid(glm::mat4)) {
-        program->setUniform<glm::mat4>(input->name(), static_cast<Input<glm::mat4> *>(input)->value());
+        program->setUniform<glm::mat4>(input->name(), **static_cast<Input<glm::mat4> *>(input));
     } else if (input->type() == typeid(glm::mat2x3)) {
-        program->setUniform<glm::mat2x3>(input->name(), static_cast<Input<glm::mat2x3> *>(input)->value());
+        program->setUniform<glm::mat2x3>(input->name(), **static_cast<Input<glm::mat2x3> *>(input));
     } else if (input->type() == typeid(glm::mat3x2)) {
-        program->setUniform<glm::mat3x2>(input->name(), static_cast<Input<glm::mat3x2> *>(input)->value());
+        program->setUniform<glm::mat3x2>(input->name(), **static_cast<Input<glm::mat3x2> *>(input));
     } else if (input->type() == typeid(glm::mat2x4)) {
-        program->setUniform<glm::mat2x4>(input->name(), static_cast<Input<glm::mat2x4> *>(input)->value());
+        program->setUniform<glm::mat2x4>(input->name(), **static_cast<Input<glm::mat2x4> *>(input));
     } else if (input->type() == typeid(glm::mat4x2)) {
-        program->setUniform<glm::mat4x2>(input->name(), static_cast<Input<glm::mat4x2> *>(input)->value());
+        program->setUniform<glm::mat4x2>(input->name(), **static_cast<Input<glm::mat4x2> *>(input));
     } else if (input->type() == typeid(glm::mat3x4)) {
-        program->setUniform<glm::mat3x4>(input->name(), static_cast<Input<glm::mat3x4> *>(input)->value());
+        program->setUniform<glm::mat3x4>(input->name(), **static_cast<Input<glm::mat3x4> *>(input));
     } else if (input->type() == typeid(glm::mat4x3)) {
-        program->setUniform<glm::mat4x3>(input->name(), static_cast<Input<glm::mat4x3> *>(input)->value());
+        program->setUniform<glm::mat4x3>(input->name(), **static_cast<Input<glm::mat4x3> *>(input));
     } else if (input->type() == typeid(gl::GLuint64)) {
-        program->setUniform<gl::GLuint64>(input->name(), static_cast<Input<gl::GLuint64> *>(input)->value());
+        program->setUniform<gl::GLuint64>(input->name(), **static_cast<Input<gl::GLuint64> *>(input));
     } else if (input->type() == typeid(globjects::TextureHandle)) {
-        program->setUniform<globjects::TextureHandle>(input->name(), static_cast<Input<globjects::TextureHandle> *>(input)->value());
+        program->setUniform<globjects::TextureHandle>(input->name(), **static_cast<Input<globjects::TextureHandle> *>(input));
     } else if (input->type() == typeid(std::vector<float>)) {
-        program->setUniform<std::vector<float>>(input->name(), static_cast<Input<std::vector<float>> *>(input)->value());
+        program->setUniform<std::vector<float>>(input->name(), **static_cast<Input<std::vector<float>> *>(input));
     } else if (input->type() == typeid(std::vector<int>)) {
-        program->setUniform<std::vector<int>>(input->name(), static_cast<Input<std::vector<int>> *>(input)->value());
+        program->setUniform<std::vector<int>>(input->name(), **static_cast<Input<std::vector<int>> *>(input));
     } else if (input->type() == typeid(std::vector<unsigned int>)) {
-        program->setUniform<std::vector<unsigned int>>(input->name(), static_cast<Input<std::vector<unsigned int>> *>(input)->value());
+        program->setUniform<std::vector<unsigned int>>(input->name(), **static_cast<Input<std::vector<unsigned int>> *>(input));
     } else if (input->type() == typeid(std::vector<bool>)) {
-        program->setUniform<std::vector<bool>>(input->name(), static_cast<Input<std::vector<bool>> *>(input)->value());
+        program->setUniform<std::vector<bool>>(input->name(), **static_cast<Input<std::vector<bool>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::vec2>)) {
-        program->setUniform<std::vector<glm::vec2>>(input->name(), static_cast<Input<std::vector<glm::vec2>> *>(input)->value());
+        program->setUniform<std::vector<glm::vec2>>(input->name(), **static_cast<Input<std::vector<glm::vec2>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::vec3>)) {
-        program->setUniform<std::vector<glm::vec3>>(input->name(), static_cast<Input<std::vector<glm::vec3>> *>(input)->value());
+        program->setUniform<std::vector<glm::vec3>>(input->name(), **static_cast<Input<std::vector<glm::vec3>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::vec4>)) {
-        program->setUniform<std::vector<glm::vec4>>(input->name(), static_cast<Input<std::vector<glm::vec4>> *>(input)->value());
+        program->setUniform<std::vector<glm::vec4>>(input->name(), **static_cast<Input<std::vector<glm::vec4>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::ivec2>)) {
-        program->setUniform<std::vector<glm::ivec2>>(input->name(), static_cast<Input<std::vector<glm::ivec2>> *>(input)->value());
+        program->setUniform<std::vector<glm::ivec2>>(input->name(), **static_cast<Input<std::vector<glm::ivec2>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::ivec3>)) {
-        program->setUniform<std::vector<glm::ivec3>>(input->name(), static_cast<Input<std::vector<glm::ivec3>> *>(input)->value());
+        program->setUniform<std::vector<glm::ivec3>>(input->name(), **static_cast<Input<std::vector<glm::ivec3>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::ivec4>)) {
-        program->setUniform<std::vector<glm::ivec4>>(input->name(), static_cast<Input<std::vector<glm::ivec4>> *>(input)->value());
+        program->setUniform<std::vector<glm::ivec4>>(input->name(), **static_cast<Input<std::vector<glm::ivec4>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::uvec2>)) {
-        program->setUniform<std::vector<glm::uvec2>>(input->name(), static_cast<Input<std::vector<glm::uvec2>> *>(input)->value());
+        program->setUniform<std::vector<glm::uvec2>>(input->name(), **static_cast<Input<std::vector<glm::uvec2>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::uvec3>)) {
-        program->setUniform<std::vector<glm::uvec3>>(input->name(), static_cast<Input<std::vector<glm::uvec3>> *>(input)->value());
+        program->setUniform<std::vector<glm::uvec3>>(input->name(), **static_cast<Input<std::vector<glm::uvec3>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::uvec4>)) {
-        program->setUniform<std::vector<glm::uvec4>>(input->name(), static_cast<Input<std::vector<glm::uvec4>> *>(input)->value());
+        program->setUniform<std::vector<glm::uvec4>>(input->name(), **static_cast<Input<std::vector<glm::uvec4>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat2>)) {
-        program->setUniform<std::vector<glm::mat2>>(input->name(), static_cast<Input<std::vector<glm::mat2>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat2>>(input->name(), **static_cast<Input<std::vector<glm::mat2>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat3>)) {
-        program->setUniform<std::vector<glm::mat3>>(input->name(), static_cast<Input<std::vector<glm::mat3>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat3>>(input->name(), **static_cast<Input<std::vector<glm::mat3>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat4>)) {
-        program->setUniform<std::vector<glm::mat4>>(input->name(), static_cast<Input<std::vector<glm::mat4>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat4>>(input->name(), **static_cast<Input<std::vector<glm::mat4>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat2x3>)) {
-        program->setUniform<std::vector<glm::mat2x3>>(input->name(), static_cast<Input<std::vector<glm::mat2x3>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat2x3>>(input->name(), **static_cast<Input<std::vector<glm::mat2x3>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat3x2>)) {
-        program->setUniform<std::vector<glm::mat3x2>>(input->name(), static_cast<Input<std::vector<glm::mat3x2>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat3x2>>(input->name(), **static_cast<Input<std::vector<glm::mat3x2>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat2x4>)) {
-        program->setUniform<std::vector<glm::mat2x4>>(input->name(), static_cast<Input<std::vector<glm::mat2x4>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat2x4>>(input->name(), **static_cast<Input<std::vector<glm::mat2x4>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat4x2>)) {
-        program->setUniform<std::vector<glm::mat4x2>>(input->name(), static_cast<Input<std::vector<glm::mat4x2>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat4x2>>(input->name(), **static_cast<Input<std::vector<glm::mat4x2>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat3x4>)) {
-        program->setUniform<std::vector<glm::mat3x4>>(input->name(), static_cast<Input<std::vector<glm::mat3x4>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat3x4>>(input->name(), **static_cast<Input<std::vector<glm::mat3x4>> *>(input));
     } else if (input->type() == typeid(std::vector<glm::mat4x3>)) {
-        program->setUniform<std::vector<glm::mat4x3>>(input->name(), static_cast<Input<std::vector<glm::mat4x3>> *>(input)->value());
+        program->setUniform<std::vector<glm::mat4x3>>(input->name(), **static_cast<Input<std::vector<glm::mat4x3>> *>(input));
     } else if (input->type() == typeid(std::vector<gl::GLuint64>)) {
-        program->setUniform<std::vector<gl::GLuint64>>(input->name(), static_cast<Input<std::vector<gl::GLuint64>> *>(input)->value());
+        program->setUniform<std::vector<gl::GLuint64>>(input->name(), **static_cast<Input<std::vector<gl::GLuint64>> *>(input));
     } else if (input->type() == typeid(std::vector<globjects::TextureHandle>)) {
-        program->setUniform<std::vector<globjects::TextureHandle>>(input->name(), static_cast<Input<std::vector<globjects::TextureHandle>> *>(input)->value());
+        program->setUniform<std::vector<globjects::TextureHandle>>(input->name(), **static_cast<Input<std::vector<globjects::TextureHandle>> *>(input));
     }
 }
 
@@ -8,9 +8,12 @@
 
 #include <globjects/Renderbuffer.h>
 
+#include <gloperate/pipeline/Pipeline.h>
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/DepthRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
+#include <gloperate/rendering/FramebufferCache.h>
+#include <gloperate/rendering/RenderTargetPool.h>
 
 
 using namespace gl;
@@ -28,6 +31,7 @@ RenderbufferRenderTargetStage::RenderbufferRenderTargetStage(gloperate::Environm
 : Stage(environment, "RenderbufferRenderTargetStage", name)
 , internalFormat("internalFormat", this)
 , size("size", this)
+, transient("transient", this, false)
 , renderbuffer("renderbuffer", this)
 , colorRenderTarget("colorRenderTarget", this)
 , depthRenderTarget("depthRenderTarget", this)
@@ -52,7 +56,14 @@ void RenderbufferRenderTargetStage::onContextInit(gloperate::AbstractGLContext *
 
 void RenderbufferRenderTargetStage::onContextDeinit(AbstractGLContext *)
 {
+    // Release transient storage, which is deleted by the pipeline
+    if (parentPipeline())
+    {
+        parentPipeline()->renderTargetPool()->removeClient(this);
+    }
+
     // Clean up OpenGL objects
+    FramebufferCache::releaseRenderbuffer(m_renderbuffer.get());
     m_renderbuffer        = nullptr;
     m_colorRenderTarget   = nullptr;
     m_depthRenderTarget   = nullptr;
@@ -67,10 +78,29 @@ void RenderbufferRenderTargetStage::onProcess()
         return;
     }
 
-    // Create texture image
     const auto width  = (*size)[2];
     const auto height = (*size)[3];
-    m_renderbuffer->storage(*internalFormat, width, height);
+    const auto pipeline = parentPipeline();
+
+    Renderbuffer * target = nullptr;
+
+    if (*transient && pipeline)
+    {
+        // Obtain renderbuffer that is shared with other transient render targets
+        target = pipeline->renderTargetPool()->obtainRenderbuffer(this, *internalFormat, width, height);
+    }
+    else
+    {
+        if (pipeline)
+        {
+            pipeline->renderTargetPool()->removeClient(this);
+        }
+
+        // Create renderbuffer storage
+        m_renderbuffer->storage(*internalFormat, width, height);
+
+        target = m_renderbuffer.get();
+    }
 
     switch(*internalFormat)
     {
@@ -81,26 +111,26 @@ void RenderbufferRenderTargetStage::onProcess()
         m_colorRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_renderbuffer.get());
+        m_depthRenderTarget->setTarget(target);
         break;
     case GL_DEPTH_STENCIL:
     case GL_DEPTH24_STENCIL8:
     case GL_DEPTH32F_STENCIL8:
         m_colorRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_renderbuffer.get());
-        m_stencilRenderTarget->setTarget(m_renderbuffer.get());
+        m_depthRenderTarget->setTarget(target);
+        m_stencilRenderTarget->setTarget(target);
         break;
     default: // Color attachment
         m_depthRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_colorRenderTarget->setTarget(m_renderbuffer.get());
+        m_colorRenderTarget->setTarget(target);
         break;
     }
 
     // Update outputs
-    renderbuffer.setValue(m_renderbuffer.get());
+    renderbuffer.setValue(target);
     colorRenderTarget.setValue(m_colorRenderTarget.get());
     depthRenderTarget.setValue(m_depthRenderTarget.get());
     stencilRenderTarget.setValue(m_stencilRenderTarget.get());
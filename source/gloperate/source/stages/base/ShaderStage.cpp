@@ -5,6 +5,7 @@
 
 #include <gloperate/base/Environment.h>
 #include <gloperate/base/ResourceManager.h>
+#include <gloperate/base/ResourceCache.h>
 
 #include <gloperate/gloperate.h>
 
@@ -29,18 +30,31 @@ ShaderStage::~ShaderStage()
 
 void ShaderStage::onContextInit(AbstractGLContext *)
 {
+    // Reload shader when its file has been modified (notified on the render thread of the context)
+    if (auto cache = ResourceCache::current())
+    {
+        m_resourceChangedConnection = cache->resourceChanged.connect([this] (const std::string & path)
+        {
+            if (path == ResourceManager::canonicalPath((*filePath).path()))
+            {
+                invalidateOutputs();
+            }
+        });
+    }
 }
 
 void ShaderStage::onContextDeinit(AbstractGLContext *)
 {
+    m_resourceChangedConnection = cppexpose::Connection();
+
     // Clean up OpenGL objects
     m_shader = nullptr;
 }
 
 void ShaderStage::onProcess()
 {
-    // Load shader
-    m_shader = std::unique_ptr<globjects::Shader>(environment()->resourceManager()->load<globjects::Shader>((*filePath).path()));
+    // Get shader, it is only loaded if no other stage uses the file
+    m_shader = environment()->resourceManager()->get<globjects::Shader>((*filePath).path());
 
     // Update outputs
     shader.setValue(m_shader.get());
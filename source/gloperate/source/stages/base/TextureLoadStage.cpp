@@ -1,9 +1,13 @@
 
 #include <gloperate/stages/base/TextureLoadStage.h>
 
+#include <chrono>
+
 #include <glbinding/gl/enum.h>
 
 #include <gloperate/base/Environment.h>
+#include <gloperate/base/ResourceCache.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace gloperate
@@ -26,23 +30,68 @@ TextureLoadStage::~TextureLoadStage()
 
 void TextureLoadStage::onContextInit(AbstractGLContext *)
 {
+    // Reload texture in the background when its file has been modified (notified on the render thread of the context)
+    if (auto cache = ResourceCache::current())
+    {
+        m_resourceChangedConnection = cache->resourceChanged.connect([this] (const std::string & path)
+        {
+            if (m_texture && path == ResourceManager::canonicalPath((*filename).path()))
+            {
+                m_pendingTexture = m_environment->resourceManager()->loadAsync<globjects::Texture>((*filename).path());
+                setAlwaysProcessed(true);
+            }
+        });
+    }
 }
 
 void TextureLoadStage::onContextDeinit(AbstractGLContext *)
 {
+    m_resourceChangedConnection = cppexpose::Connection();
+
     // Clean up OpenGL objects
     m_texture = nullptr;
+
+    // Discard texture that is being loaded
+    m_pendingTexture = std::future<std::shared_ptr<globjects::Texture>>();
+    setAlwaysProcessed(false);
 }
 
 void TextureLoadStage::onProcess()
 {
-    // Load texture
-    auto tex = m_environment->resourceManager()->load<globjects::Texture>((*filename).path());
-    m_texture = tex ? std::unique_ptr<globjects::Texture>(tex) : globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
-
-    // Update outputs
-    texture.setValue(m_texture.get());
+    // Start loading texture
+    if (filename.hasChanged() || (!m_texture && !m_pendingTexture.valid()))
+    {
+        m_pendingTexture = m_environment->resourceManager()->loadAsync<globjects::Texture>((*filename).path());
+
+        // Check for the texture in every frame until it is ready
+        setAlwaysProcessed(true);
+    }
+
+    // Take over texture once it has been loaded
+    if (m_pendingTexture.valid() && m_pendingTexture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        m_texture = m_pendingTexture.get();
+
+        if (!m_texture)
+        {
+            m_texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
+            RenderStateCache::texturesChanged();
+        }
+
+        setAlwaysProcessed(false);
+    }
+    else if (!m_texture)
+    {
+        // Provide default texture until the first texture is ready
+        m_texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
+        RenderStateCache::texturesChanged();
+    }
+
+    // Update outputs, while waiting they are only set again if they have been invalidated
+    if (!texture.isValid() || *texture != m_texture.get())
+    {
+        texture.setValue(m_texture.get());
+    }
 }
 
-
 } // namespace gloperate
@@ -8,9 +8,13 @@
 
 #include <globjects/Texture.h>
 
+#include <gloperate/pipeline/Pipeline.h>
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/DepthRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
+#include <gloperate/rendering/FramebufferCache.h>
+#include <gloperate/rendering/RenderTargetPool.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 using namespace gl;
@@ -30,6 +34,7 @@ TextureRenderTargetStage::TextureRenderTargetStage(gloperate::Environment * envi
 , format("format", this)
 , type("type", this)
 , size("size", this)
+, transient("transient", this, false)
 , texture("texture", this)
 , colorRenderTarget("colorRenderTarget", this)
 , depthRenderTarget("depthRenderTarget", this)
@@ -54,7 +59,14 @@ void TextureRenderTargetStage::onContextInit(gloperate::AbstractGLContext *)
 
 void TextureRenderTargetStage::onContextDeinit(AbstractGLContext *)
 {
+    // Release transient storage, which is deleted by the pipeline
+    if (parentPipeline())
+    {
+        parentPipeline()->renderTargetPool()->removeClient(this);
+    }
+
     // Clean up OpenGL objects
+    FramebufferCache::releaseTexture(m_texture.get());
     m_texture             = nullptr;
     m_colorRenderTarget   = nullptr;
     m_depthRenderTarget   = nullptr;
@@ -69,10 +81,30 @@ void TextureRenderTargetStage::onProcess()
         return;
     }
 
-    // Create texture image
     const auto width  = (*size)[2];
     const auto height = (*size)[3];
-    m_texture->image2D(0, *internalFormat, width, height, 0, *format, *type, nullptr);
+    const auto pipeline = parentPipeline();
+
+    Texture * target = nullptr;
+
+    if (*transient && pipeline)
+    {
+        // Obtain texture that is shared with other transient render targets
+        target = pipeline->renderTargetPool()->obtainTexture(this, *internalFormat, *format, *type, width, height);
+    }
+    else
+    {
+        if (pipeline)
+        {
+            pipeline->renderTargetPool()->removeClient(this);
+        }
+
+        // Create texture image
+        m_texture->image2D(0, *internalFormat, width, height, 0, *format, *type, nullptr);
+        RenderStateCache::texturesChanged();
+
+        target = m_texture.get();
+    }
 
     switch(*internalFormat)
     {
@@ -83,26 +115,26 @@ void TextureRenderTargetStage::onProcess()
         m_colorRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_texture.get());
+        m_depthRenderTarget->setTarget(target);
         break;
     case GL_DEPTH_STENCIL:
     case GL_DEPTH24_STENCIL8:
     case GL_DEPTH32F_STENCIL8:
         m_colorRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_texture.get());
-        m_stencilRenderTarget->setTarget(m_texture.get());
+        m_depthRenderTarget->setTarget(target);
+        m_stencilRenderTarget->setTarget(target);
         break;
     default: // Color attachment
         m_depthRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_colorRenderTarget->setTarget(m_texture.get());
+        m_colorRenderTarget->setTarget(target);
         break;
     }
 
     // Update outputs
-    texture.setValue(m_texture.get());
+    texture.setValue(target);
     colorRenderTarget.setValue(m_colorRenderTarget.get());
     depthRenderTarget.setValue(m_depthRenderTarget.get());
     stencilRenderTarget.setValue(m_stencilRenderTarget.get());
@@ -26,6 +26,11 @@ TransformStage::~TransformStage()
 {
 }
 
+bool TransformStage::requiresContext() const
+{
+    return false;
+}
+
 void TransformStage::onProcess()
 {
     // Calculate model matrix
@@ -9,20 +9,133 @@
 #include <globjects/FramebufferAttachment.h>
 #include <globjects/AttachedRenderbuffer.h>
 #include <globjects/AttachedTexture.h>
+#include <globjects/Texture.h>
+#include <globjects/Renderbuffer.h>
 
 #include <gloperate/rendering/RenderTargetType.h>
+#include <gloperate/rendering/FramebufferCache.h>
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/DepthRenderTarget.h>
 #include <gloperate/rendering/DepthStencilRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
 
 
+namespace
+{
+
+
+gl::GLenum attachmentPoint(size_t index, gloperate::AbstractRenderTarget * renderTarget)
+{
+    switch (renderTarget->underlyingAttachmentType())
+    {
+    case gloperate::AttachmentType::Depth:
+        return gl::GL_DEPTH_ATTACHMENT;
+
+    case gloperate::AttachmentType::Stencil:
+        return gl::GL_STENCIL_ATTACHMENT;
+
+    case gloperate::AttachmentType::DepthStencil:
+        return gl::GL_DEPTH_STENCIL_ATTACHMENT;
+
+    default:
+        return gl::GL_COLOR_ATTACHMENT0 + index;
+    }
+}
+
+// Returns 'false' if the render target cannot be attached to a cached framebuffer
+bool appendAttachment(size_t index, gloperate::AbstractRenderTarget * renderTarget, std::vector<gloperate::FramebufferCache::Attachment> & attachments)
+{
+    gloperate::FramebufferCache::Attachment attachment;
+    attachment.attachment   = attachmentPoint(index, renderTarget);
+    attachment.texture      = nullptr;
+    attachment.renderbuffer = nullptr;
+
+    switch (renderTarget->currentTargetType())
+    {
+    case gloperate::RenderTargetType::Texture:
+        attachment.texture = renderTarget->textureAttachment();
+        break;
+
+    case gloperate::RenderTargetType::Renderbuffer:
+        attachment.renderbuffer = renderTarget->renderbufferAttachment();
+        break;
+
+    case gloperate::RenderTargetType::UserDefinedFBOAttachment:
+        {
+            const auto targetAttachment = renderTarget->framebufferAttachment();
+
+            if (targetAttachment->isTextureAttachment())
+            {
+                attachment.texture = static_cast<globjects::AttachedTexture *>(targetAttachment)->texture();
+            }
+            else
+            {
+                attachment.renderbuffer = static_cast<globjects::AttachedRenderbuffer *>(targetAttachment)->renderBuffer();
+            }
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    attachment.id = attachment.texture ? attachment.texture->id() : attachment.renderbuffer->id();
+
+    attachments.push_back(attachment);
+
+    return true;
+}
+
+template <typename TargetType>
+void appendRevisions(const std::vector<gloperate::Input<TargetType *> *> & inputs, std::vector<std::size_t> & revisions, std::size_t & index, bool & changed)
+{
+    for (auto input : inputs)
+    {
+        const auto renderTarget = **input;
+        const auto revision = renderTarget ? renderTarget->revision() : std::size_t(0);
+
+        if (index < revisions.size())
+        {
+            changed |= revisions[index] != revision;
+            revisions[index] = revision;
+        }
+        else
+        {
+            changed = true;
+            revisions.push_back(revision);
+        }
+
+        ++index;
+    }
+}
+
+template <typename TargetType>
+bool appendAttachments(const std::vector<gloperate::Input<TargetType *> *> & inputs, std::vector<gloperate::FramebufferCache::Attachment> & attachments)
+{
+    for (auto input : inputs)
+    {
+        if (**input && !appendAttachment(0, **input, attachments))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
 
 RenderInterface::RenderInterface(Stage * stage)
 : viewport("viewport", stage, glm::vec4(0.0, 0.0, -1.0, -1.0))
+, m_compatibilityValid(false)
+, m_compatible(false)
+, m_configuredFBO(nullptr)
 {
     // Hide inputs in property editor
     viewport.setOption("hidden", true);
@@ -103,6 +216,18 @@ void RenderInterface::updateRenderTargetOutputs()
 }
 
 bool RenderInterface::allRenderTargetsCompatible() const
+{
+    // Only check render targets again if one of them has changed
+    if (updateRevisions(m_compatibilityRevisions) || !m_compatibilityValid)
+    {
+        m_compatible         = checkRenderTargetsCompatible();
+        m_compatibilityValid = true;
+    }
+
+    return m_compatible;
+}
+
+bool RenderInterface::checkRenderTargetsCompatible() const
 {
     if (m_colorRenderTargetInputs.empty() && m_depthRenderTargetInputs.empty() && m_depthStencilRenderTargetInputs.empty() && m_stencilRenderTargetInputs.empty())
     {
@@ -349,41 +474,57 @@ Output<StencilRenderTarget *> * RenderInterface::stencilRenderTargetOutput(size_
 void RenderInterface::addRenderTargetInput(Input<ColorRenderTarget *> * input)
 {
     m_colorRenderTargetInputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::addRenderTargetInput(Input<DepthRenderTarget *> * input)
 {
     m_depthRenderTargetInputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::addRenderTargetInput(Input<DepthStencilRenderTarget *> * input)
 {
     m_depthStencilRenderTargetInputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::addRenderTargetInput(Input<StencilRenderTarget *> * input)
 {
     m_stencilRenderTargetInputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::addRenderTargetOutput(Output<ColorRenderTarget *> * input)
 {
     m_colorRenderTargetOutputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::addRenderTargetOutput(Output<DepthRenderTarget *> * input)
 {
     m_depthRenderTargetOutputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::addRenderTargetOutput(Output<DepthStencilRenderTarget *> * input)
 {
     m_depthStencilRenderTargetOutputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::addRenderTargetOutput(Output<StencilRenderTarget *> * input)
 {
     m_stencilRenderTargetOutputs.push_back(input);
+
+    m_compatibilityValid = false;
 }
 
 void RenderInterface::pairwiseColorRenderTargetsDo(std::function<void(Input<ColorRenderTarget *> *, Output<ColorRenderTarget *> *)> callback, bool includeIncompletePairs)
@@ -438,6 +579,31 @@ globjects::Framebuffer * RenderInterface::obtainFBO() const
 {
     assert(allRenderTargetsCompatible());
 
+    // Use a framebuffer of the context that is configured for exactly these render targets
+    if (auto cache = FramebufferCache::current())
+    {
+        auto fbo = obtainCachedFBO(cache);
+
+        if (fbo)
+        {
+            validateFBO(fbo, false);
+
+            return fbo;
+        }
+    }
+
+    // Reuse configuration of the intermediate FBO if no render target has changed
+    const auto targetsChanged = updateRevisions(m_fboRevisions);
+
+    if (!targetsChanged && m_configuredFBO)
+    {
+        validateFBO(m_configuredFBO, false);
+
+        return m_configuredFBO;
+    }
+
+    m_configuredFBO = nullptr;
+
     std::vector<gl::GLenum> drawBuffers;
     globjects::Framebuffer * currentFBO = nullptr;
     auto colorAttachmentIndex = size_t(0);
@@ -514,42 +680,86 @@ globjects::Framebuffer * RenderInterface::obtainFBO() const
 
     currentFBO->setDrawBuffers(drawBuffers);
 
+    // The default FBO is only validated if the render targets have changed
+    validateFBO(currentFBO, targetsChanged || currentFBO == m_fbo.get());
+
+    // The draw buffers of the default FBO are shared with other stages, so only the intermediate FBO keeps its configuration
+    if (currentFBO == m_fbo.get())
+    {
+        m_configuredFBO = currentFBO;
+    }
+
     return currentFBO;
 }
 
-globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget) const
+globjects::Framebuffer * RenderInterface::obtainCachedFBO(FramebufferCache * cache) const
 {
-    return obtainFBO(index, renderTarget, m_fbo.get(), m_defaultFBO.get());
-}
+    std::vector<FramebufferCache::Attachment> attachments;
+    std::vector<gl::GLenum> drawBuffers;
 
-globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget, globjects::Framebuffer * fbo, globjects::Framebuffer * defaultFBO)
-{
-    if (renderTarget == nullptr)
+    auto colorAttachmentIndex = size_t(0);
+    for (auto input : m_colorRenderTargetInputs)
     {
-        return nullptr;
-    }
+        const auto renderTarget = **input;
 
-    auto attachmentIndex = gl::GL_COLOR_ATTACHMENT0 + index;
+        if (renderTarget)
+        {
+            if (!appendAttachment(colorAttachmentIndex, renderTarget, attachments))
+            {
+                return nullptr;
+            }
 
-    if (renderTarget->underlyingAttachmentType() == AttachmentType::Depth)
+            drawBuffers.push_back(renderTarget->drawBufferAttachment(colorAttachmentIndex));
+        }
+        else
+        {
+            drawBuffers.push_back(gl::GL_NONE);
+        }
+
+        ++colorAttachmentIndex;
+    }
+
+    if (!appendAttachments(m_depthRenderTargetInputs, attachments)
+     || !appendAttachments(m_depthStencilRenderTargetInputs, attachments)
+     || !appendAttachments(m_stencilRenderTargetInputs, attachments)
+     || attachments.empty())
     {
-        attachmentIndex = gl::GL_DEPTH_ATTACHMENT;
+        return nullptr;
     }
 
-    if (renderTarget->underlyingAttachmentType() == AttachmentType::Stencil)
+    return cache->obtain(attachments, drawBuffers);
+}
+
+globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget, bool * attachmentChanged) const
+{
+    // The intermediate FBO may be configured differently by the caller
+    m_configuredFBO = nullptr;
+
+    return obtainFBO(index, renderTarget, m_fbo.get(), m_defaultFBO.get(), attachmentChanged);
+}
+
+globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget, globjects::Framebuffer * fbo, globjects::Framebuffer * defaultFBO, bool * attachmentChanged)
+{
+    if (attachmentChanged)
     {
-        attachmentIndex = gl::GL_STENCIL_ATTACHMENT;
+        *attachmentChanged = false;
     }
 
-    if (renderTarget->underlyingAttachmentType() == AttachmentType::DepthStencil)
+    if (renderTarget == nullptr)
     {
-        attachmentIndex = gl::GL_DEPTH_STENCIL_ATTACHMENT;
+        return nullptr;
     }
 
+    const auto attachmentIndex = attachmentPoint(index, renderTarget);
+
+    auto changed = false;
+    globjects::Framebuffer * result = nullptr;
+
     switch (renderTarget->currentTargetType())
     {
     case RenderTargetType::DefaultFBOAttachment:
-        return defaultFBO;
+        result = defaultFBO;
+        break;
 
     case RenderTargetType::UserDefinedFBOAttachment:
         {
@@ -566,22 +776,26 @@ globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRender
                 if (targetAttachment->isTextureAttachment())
                 {
                     fbo->attachTexture(attachmentIndex, targetAttachedTexture->texture());
+                    changed = true;
                 }
                 else
                 {
                     fbo->attachRenderBuffer(attachmentIndex, targetAttachedRenderbuffer->renderBuffer());
+                    changed = true;
                 }
             }
             else if (fboAttachment->isTextureAttachment() && (!targetAttachment->isTextureAttachment() || fboAttachedTexture->texture() != targetAttachedTexture->texture()))
             {
                 fbo->attachTexture(attachmentIndex, targetAttachedTexture->texture());
+                changed = true;
             }
             else if (fboAttachment->isRenderBufferAttachment() && (!targetAttachment->isRenderBufferAttachment() || fboAttachedRenderbuffer->renderBuffer() != targetAttachedRenderbuffer->renderBuffer()))
             {
                 fbo->attachRenderBuffer(attachmentIndex, targetAttachedRenderbuffer->renderBuffer());
+                changed = true;
             }
 
-            return fbo;
+            result = fbo;
         }
         break;
 
@@ -593,9 +807,10 @@ globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRender
             if (!attachment || !attachment->isTextureAttachment() || attachedTexture->texture() != renderTarget->textureAttachment())
             {
                 fbo->attachTexture(attachmentIndex, renderTarget->textureAttachment());
+                changed = true;
             }
 
-            return fbo;
+            result = fbo;
         }
         break;
 
@@ -607,27 +822,73 @@ globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRender
             if (!attachment || !attachment->isRenderBufferAttachment() || attachedRenderbuffer->renderBuffer() != renderTarget->renderbufferAttachment())
             {
                 fbo->attachRenderBuffer(attachmentIndex, renderTarget->renderbufferAttachment());
+                changed = true;
             }
 
-            return fbo;
+            result = fbo;
         }
         break;
 
     default:
-        return nullptr;
+        break;
     }
+
+    if (attachmentChanged)
+    {
+        *attachmentChanged = changed;
+    }
+
+    return result;
+}
+
+void RenderInterface::validateFBO(globjects::Framebuffer * fbo, bool attachmentsChanged)
+{
+#ifdef NDEBUG
+    if (!attachmentsChanged)
+    {
+        return;
+    }
+#else
+    (void)attachmentsChanged;
+#endif
+
+    if (fbo)
+    {
+        fbo->printStatus(true);
+    }
+}
+
+bool RenderInterface::updateRevisions(std::vector<std::size_t> & revisions) const
+{
+    auto index   = std::size_t(0);
+    auto changed = false;
+
+    appendRevisions(m_colorRenderTargetInputs,        revisions, index, changed);
+    appendRevisions(m_depthRenderTargetInputs,        revisions, index, changed);
+    appendRevisions(m_depthStencilRenderTargetInputs, revisions, index, changed);
+    appendRevisions(m_stencilRenderTargetInputs,      revisions, index, changed);
+
+    if (revisions.size() != index)
+    {
+        revisions.resize(index);
+        changed = true;
+    }
+
+    return changed;
 }
 
 void RenderInterface::onContextInit()
 {
     m_defaultFBO = globjects::Framebuffer::defaultFBO();
     m_fbo = cppassist::make_unique<globjects::Framebuffer>();
+    m_configuredFBO = nullptr;
 }
 
 void RenderInterface::onContextDeinit()
 {
     m_defaultFBO = nullptr;
     m_fbo = nullptr;
+    m_configuredFBO = nullptr;
 }
 
 
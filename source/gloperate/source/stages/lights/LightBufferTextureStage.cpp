@@ -9,6 +9,8 @@
 #include <globjects/Texture.h>
 
 #include <gloperate/rendering/Light.h>
+#include <gloperate/rendering/StreamingBuffer.h>
+#include <gloperate/rendering/RenderStateCache.h>
 
 
 namespace
@@ -53,33 +55,64 @@ void LightBufferTextureStage::onContextDeinit(AbstractGLContext * /*context*/)
     m_attenuationBuffer.reset();
     m_positionBuffer.reset();
     m_colorTypeBuffer.reset();
+    m_emptyBuffer.reset();
 }
 
 void LightBufferTextureStage::onProcess()
 {
-    if (!colorTypeData.isValid() || !positionData.isValid() || !attenuationData.isValid())
+    if (!m_colorTypeTexture)
     {
         setupBufferTextures();
     }
 
-    std::vector<ColorTypeEntry> colorsTypes{};
-    std::vector<glm::vec3> positions{};
-    std::vector<glm::vec3> attenuations{};
-
+    std::size_t numLights = 0;
     for (auto lightInput : m_lightInputs)
     {
-        if (!lightInput->isValid())
-            continue;
+        if (lightInput->isValid())
+        {
+            ++numLights;
+        }
+    }
+
+    // Write light data straight into the current regions of the streaming buffers
+    const auto colorTypeSize   = numLights * sizeof(ColorTypeEntry);
+    const auto positionSize    = numLights * sizeof(glm::vec3);
+    const auto attenuationSize = numLights * sizeof(glm::vec3);
 
-        auto lightDef = lightInput->value();
-        colorsTypes.push_back(ColorTypeEntry{lightDef.color, float(lightDef.type)});
-        positions.push_back(lightDef.position);
-        attenuations.push_back(lightDef.attenuationCoefficients);
+    auto colorsTypes  = static_cast<ColorTypeEntry *>(m_colorTypeBuffer->map(colorTypeSize));
+    auto positions    = static_cast<glm::vec3 *>(m_positionBuffer->map(positionSize));
+    auto attenuations = static_cast<glm::vec3 *>(m_attenuationBuffer->map(attenuationSize));
+
+    if (colorsTypes && positions && attenuations)
+    {
+        std::size_t i = 0;
+        for (auto lightInput : m_lightInputs)
+        {
+            if (!lightInput->isValid())
+                continue;
+
+            const auto & lightDef = **lightInput;
+            colorsTypes[i]  = ColorTypeEntry{lightDef.color, float(lightDef.type)};
+            positions[i]    = lightDef.position;
+            attenuations[i] = lightDef.attenuationCoefficients;
+            ++i;
+        }
     }
+    else
+    {
+        numLights = 0;
+    }
+
+    m_colorTypeBuffer->unmap();
+    m_positionBuffer->unmap();
+    m_attenuationBuffer->unmap();
+
+    attachRegion(m_colorTypeTexture.get(), gl::GL_RGBA32F, m_colorTypeBuffer.get(), numLights > 0 ? colorTypeSize : 0);
+    attachRegion(m_positionTexture.get(), gl::GL_RGB32F, m_positionBuffer.get(), numLights > 0 ? positionSize : 0);
+    attachRegion(m_attenuationTexture.get(), gl::GL_RGB32F, m_attenuationBuffer.get(), numLights > 0 ? attenuationSize : 0);
 
-    m_colorTypeBuffer->setData(colorsTypes, gl::GL_DYNAMIC_DRAW);
-    m_positionBuffer->setData(positions, gl::GL_DYNAMIC_DRAW);
-    m_attenuationBuffer->setData(attenuations, gl::GL_DYNAMIC_DRAW);
+    // Without DSA, re-pointing the buffer textures has bound them to the active unit
+    RenderStateCache::texturesChanged();
 
     colorTypeData.setValue(m_colorTypeTexture.get());
     positionData.setValue(m_positionTexture.get());
@@ -88,18 +121,35 @@ void LightBufferTextureStage::onProcess()
 
 void LightBufferTextureStage::setupBufferTextures()
 {
-    m_colorTypeBuffer = cppassist::make_unique<globjects::Buffer>();
+    m_colorTypeBuffer = cppassist::make_unique<StreamingBuffer>();
     m_colorTypeTexture = cppassist::make_unique<globjects::Texture>(gl::GL_TEXTURE_BUFFER);
 
-    m_positionBuffer = cppassist::make_unique<globjects::Buffer>();
+    m_positionBuffer = cppassist::make_unique<StreamingBuffer>();
     m_positionTexture = cppassist::make_unique<globjects::Texture>(gl::GL_TEXTURE_BUFFER);
 
-    m_attenuationBuffer = cppassist::make_unique<globjects::Buffer>();
+    m_attenuationBuffer = cppassist::make_unique<StreamingBuffer>();
     m_attenuationTexture = cppassist::make_unique<globjects::Texture>(gl::GL_TEXTURE_BUFFER);
 
-    m_colorTypeTexture->texBuffer(gl::GL_RGBA32F, m_colorTypeBuffer.get());
-    m_positionTexture->texBuffer(gl::GL_RGB32F, m_positionBuffer.get());
-    m_attenuationTexture->texBuffer(gl::GL_RGB32F, m_attenuationBuffer.get());
+    m_emptyBuffer = cppassist::make_unique<globjects::Buffer>();
+    m_emptyBuffer->setData(0, nullptr, gl::GL_STATIC_DRAW);
+
+    m_colorTypeTexture->texBuffer(gl::GL_RGBA32F, m_emptyBuffer.get());
+    m_positionTexture->texBuffer(gl::GL_RGB32F, m_emptyBuffer.get());
+    m_attenuationTexture->texBuffer(gl::GL_RGB32F, m_emptyBuffer.get());
+
+    RenderStateCache::texturesChanged();
+}
+
+void LightBufferTextureStage::attachRegion(globjects::Texture * texture, gl::GLenum internalFormat, StreamingBuffer * buffer, std::size_t size)
+{
+    // The number of texels determines the number of lights, so an empty range needs an empty buffer
+    if (size == 0 || !buffer->buffer())
+    {
+        texture->texBuffer(internalFormat, m_emptyBuffer.get());
+        return;
+    }
+
+    texture->texBufferRange(internalFormat, buffer->buffer(), buffer->offset(), size);
 }
 
 Input<Light> * LightBufferTextureStage::createLightInput()
@@ -23,6 +23,11 @@ LightCreationStage::~LightCreationStage()
 {
 }
 
+bool LightCreationStage::requiresContext() const
+{
+    return false;
+}
+
 void LightCreationStage::onProcess()
 {
     light.setValue(Light{LightType(*type), *color, *position, *attenuationCoefficients});
@@ -14,11 +14,13 @@
 #include <globjects/VertexAttributeBinding.h>
 #include <globjects/Shader.h>
 #include <globjects/Buffer.h>
+#include <globjects/Sync.h>
 
 #include <gloperate/gloperate.h>
 #include <gloperate/base/Environment.h>
 #include <gloperate/base/Canvas.h>
 #include <gloperate/base/AbstractGLContext.h>
+#include <gloperate/rendering/FramebufferCache.h>
 
 
 using namespace globjects;
@@ -57,6 +59,10 @@ static const char * s_fragmentShader = R"(
 )";
 
 
+static const std::size_t  s_numPixelBuffers = 3;       ///< Number of frames that may be read back at the same time
+static const gl::GLuint64 s_waitTimeout     = 1000000; ///< Timeout of a single wait for a fence in nanoseconds
+
+
 CPPEXPOSE_COMPONENT(FFMPEGVideoExporter, gloperate::AbstractVideoExporter)
 
 
@@ -64,6 +70,8 @@ FFMPEGVideoExporter::FFMPEGVideoExporter()
 : m_videoEncoder(new FFMPEGVideoEncoder)
 , m_canvas(nullptr)
 , m_image(nullptr)
+, m_oldestFrame(0)
+, m_pendingFrames(0)
 , m_progress(0)
 , m_initialized(false)
 , m_contextHandling(AbstractVideoExporter::IgnoreContext)
@@ -126,9 +134,7 @@ void FFMPEGVideoExporter::createVideo(AbstractVideoExporter::ContextHandling con
 
         Framebuffer::unbind(gl::GL_FRAMEBUFFER);
 
-        m_color_quad->getImage(0, m_image->format(), m_image->type(), m_image->data());
-
-        m_videoEncoder->putFrame(*m_image);
+        readFrame();
 
         m_progress = i*100/length;
         progress(i, length);
@@ -185,9 +191,7 @@ void FFMPEGVideoExporter::onRender(ContextHandling contextHandling, globjects::F
 
     Framebuffer::unbind(gl::GL_FRAMEBUFFER);
 
-    m_color_quad->getImage(0, m_image->format(), m_image->type(), m_image->data());
-
-    m_videoEncoder->putFrame(*m_image);
+    readFrame();
 
     if (shouldFinalize)
     {
@@ -235,6 +239,8 @@ void FFMPEGVideoExporter::initialize(ContextHandling contextHandling)
 
 void FFMPEGVideoExporter::finalize()
 {
+    flushFrames();
+
     m_videoEncoder->finishEncoding();
 
     if (m_contextHandling == AbstractVideoExporter::ActivateContext)
@@ -255,6 +261,10 @@ void FFMPEGVideoExporter::createAndSetupGeometry()
         glm::vec2( -1.f, -1.f ),
         glm::vec2( -1.f, +1.f ) } };
         
+    // Cached framebuffers of the canvas may still refer to the previous targets
+    FramebufferCache::releaseTexture(m_color.get());
+    FramebufferCache::releaseRenderbuffer(m_depth.get());
+
     m_fbo = cppassist::make_unique<Framebuffer>();
     m_color = Texture::createDefault(gl::GL_TEXTURE_2D);
     m_depth = cppassist::make_unique<Renderbuffer>();
@@ -299,6 +309,7 @@ void FFMPEGVideoExporter::createAndSetupBuffer()
     auto width = m_parameters.at("width").toULongLong();
     auto height = m_parameters.at("height").toULongLong();
 
+    delete m_image;
     m_image = new Image(width, height, gl::GL_RGB, gl::GL_UNSIGNED_BYTE);
 
     m_color->image2D(0, m_image->format(), m_image->width(), m_image->height(), 0, m_image->format(), m_image->type(), nullptr);
@@ -306,4 +317,94 @@ void FFMPEGVideoExporter::createAndSetupBuffer()
 
     m_color_quad->image2D(0, m_image->format(), m_image->width(), m_image->height(), 0, m_image->format(), m_image->type(), nullptr);
     m_depth_quad->storage(gl::GL_DEPTH_COMPONENT32, m_image->width(), m_image->height());
+
+    // Frames are read back tightly packed, as expected by the encoder
+    const auto frameSize = m_image->width() * m_image->height() * m_image->channels() * m_image->bytes();
+
+    m_pixelBuffers.clear();
+    m_fences.clear();
+    m_fences.resize(s_numPixelBuffers);
+    m_oldestFrame   = 0;
+    m_pendingFrames = 0;
+
+    for (std::size_t i = 0; i < s_numPixelBuffers; ++i)
+    {
+        auto buffer = cppassist::make_unique<Buffer>();
+        buffer->setData(frameSize, nullptr, gl::GL_STREAM_READ);
+        m_pixelBuffers.push_back(std::move(buffer));
+    }
+}
+
+void FFMPEGVideoExporter::readFrame()
+{
+    // Reuse the buffer of the oldest frame if all buffers are in use
+    if (m_pendingFrames == m_pixelBuffers.size())
+    {
+        encodeFrame();
+    }
+
+    const auto index = (m_oldestFrame + m_pendingFrames) % m_pixelBuffers.size();
+
+    gl::GLint packAlignment = 4;
+    gl::glGetIntegerv(gl::GL_PACK_ALIGNMENT, &packAlignment);
+    gl::glPixelStorei(gl::GL_PACK_ALIGNMENT, 1);
+
+    // Start readback into the buffer, the data pointer is an offset into the bound buffer
+    m_pixelBuffers[index]->bind(gl::GL_PIXEL_PACK_BUFFER);
+    m_color_quad->getImage(0, m_image->format(), m_image->type(), nullptr);
+    Buffer::unbind(gl::GL_PIXEL_PACK_BUFFER);
+
+    gl::glPixelStorei(gl::GL_PACK_ALIGNMENT, packAlignment);
+
+    m_fences[index] = Sync::fence(gl::GL_SYNC_GPU_COMMANDS_COMPLETE);
+
+    ++m_pendingFrames;
+}
+
+void FFMPEGVideoExporter::encodeFrame()
+{
+    if (m_pendingFrames == 0)
+    {
+        return;
+    }
+
+    const auto index = m_oldestFrame;
+    auto & fence = m_fences[index];
+
+    // Flush once, so the fence is guaranteed to be signaled eventually
+    if (fence)
+    {
+        auto result = fence->clientWait(gl::GL_SYNC_FLUSH_COMMANDS_BIT, s_waitTimeout);
+
+        while (result == gl::GL_TIMEOUT_EXPIRED)
+        {
+            result = fence->clientWait(gl::GL_NONE_BIT, s_waitTimeout);
+        }
+
+        fence = nullptr;
+    }
+
+    const auto frameSize = m_image->width() * m_image->height() * m_image->channels() * m_image->bytes();
+    const auto data = m_pixelBuffers[index]->mapRange(0, frameSize, gl::GL_MAP_READ_BIT);
+
+    if (data)
+    {
+        m_videoEncoder->putFrame(static_cast<const char *>(data), m_image->width(), m_image->height());
+        m_pixelBuffers[index]->unmap();
+    }
+    else
+    {
+        critical() << "Could not map pixel buffer, frame is dropped.";
+    }
+
+    m_oldestFrame = (m_oldestFrame + 1) % m_pixelBuffers.size();
+    --m_pendingFrames;
+}
+
+void FFMPEGVideoExporter::flushFrames()
+{
+    while (m_pendingFrames > 0)
+    {
+        encodeFrame();
+    }
 }
@@ -7,6 +7,7 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include <cppexpose/plugin/plugin_api.h>
 
@@ -14,6 +15,8 @@
 #include <globjects/Renderbuffer.h>
 #include <globjects/VertexArray.h>
 #include <globjects/Program.h>
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
 
 #include <gloperate/tools/AbstractVideoExporter.h>
 
@@ -30,6 +33,10 @@ namespace gloperate {
 /**
 *  @brief
 *    A tool which renders a given Stage into an output video file.
+*
+*    Frames are read back asynchronously into a ring of pixel pack buffers.
+*    A frame is mapped and encoded only when its buffer is needed again, so
+*    the readback of a frame overlaps with rendering the following frames.
 */
 class FFMPEGVideoExporter : public gloperate::AbstractVideoExporter
 {
@@ -72,6 +79,27 @@ protected:
     void createAndSetupShader();
     void createAndSetupBuffer();
 
+    /**
+    *  @brief
+    *    Read back the current frame into the next pixel pack buffer
+    *
+    *  @remarks
+    *    If all buffers are in use, the oldest frame is encoded first.
+    */
+    void readFrame();
+
+    /**
+    *  @brief
+    *    Wait for the oldest frame that has been read back and encode it
+    */
+    void encodeFrame();
+
+    /**
+    *  @brief
+    *    Encode all frames that have been read back
+    */
+    void flushFrames();
+
 
 protected:
     FFMPEGVideoEncoder                     * m_videoEncoder;
@@ -88,6 +116,11 @@ protected:
     std::unique_ptr<globjects::Buffer>       m_buffer;
     std::unique_ptr<globjects::Program>      m_program;
 
+    std::vector<std::unique_ptr<globjects::Buffer>> m_pixelBuffers;  ///< Ring of pixel pack buffers the frames are read back into
+    std::vector<std::unique_ptr<globjects::Sync>>   m_fences;        ///< Fence of the readback into each buffer
+    std::size_t                                     m_oldestFrame;   ///< Index of the buffer that holds the oldest pending frame
+    std::size_t                                     m_pendingFrames; ///< Number of frames that have been read back but not encoded
+
     cppexpose::VariantMap                    m_parameters;
 
     int                                      m_progress;
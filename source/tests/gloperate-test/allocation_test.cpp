@@ -0,0 +1,220 @@
+
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <cppassist/logging/logging.h>
+
+#include <gloperate/base/Environment.h>
+#include <gloperate/base/logging.h>
+#include <gloperate/pipeline/Pipeline.h>
+#include <gloperate/pipeline/Stage.h>
+#include <gloperate/pipeline/Input.h>
+#include <gloperate/pipeline/Output.h>
+
+
+namespace
+{
+
+
+std::atomic<std::size_t> s_numAllocations(0); ///< Number of allocations since the start of the program
+
+
+void * allocate(std::size_t size)
+{
+    ++s_numAllocations;
+
+    if (void * memory = std::malloc(size > 0 ? size : 1))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+
+// Stage that passes its input on to its output
+class ForwardStage : public gloperate::Stage
+{
+public:
+    ForwardStage(gloperate::Environment * environment, const std::string & name)
+    : Stage(environment, "ForwardStage", name)
+    , input("input", this, 0)
+    , output("output", this, 0)
+    {
+    }
+
+    Input<int>  input;
+    Output<int> output;
+
+protected:
+    virtual void onProcess() override
+    {
+        output.setValue(*input + 1);
+    }
+};
+
+
+// Pipeline with a chain of forward stages
+class ChainPipeline : public gloperate::Pipeline
+{
+public:
+    ChainPipeline(gloperate::Environment * environment, std::size_t numStages)
+    : Pipeline(environment, "ChainPipeline", "chain")
+    , value("value", this, 0)
+    , result("result", this, 0)
+    {
+        gloperate::Slot<int> * source = &value;
+
+        for (std::size_t i = 0; i < numStages; ++i)
+        {
+            auto stage = std::unique_ptr<ForwardStage>(new ForwardStage(environment, "forward"));
+            stage->input << *source;
+            source = &stage->output;
+
+            addStage(std::move(stage));
+        }
+
+        result << *source;
+    }
+
+    Input<int>  value;
+    Output<int> result;
+};
+
+
+// Count allocations on all threads during a function call
+template <typename Function>
+std::size_t countAllocations(Function function)
+{
+    const auto before = s_numAllocations.load();
+
+    function();
+
+    return s_numAllocations.load() - before;
+}
+
+
+} // namespace
+
+
+// Replace global allocation functions to count allocations (also those of the gloperate library on platforms with symbol interposition)
+void * operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void * operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void * memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void * memory) noexcept
+{
+    std::free(memory);
+}
+
+
+class allocation_test : public testing::Test
+{
+public:
+    allocation_test()
+    {
+        // Debug messages are not logged during a regular run
+        cppassist::setVerbosityLevel(static_cast<int>(cppassist::LogMessage::Info));
+    }
+
+protected:
+    gloperate::Environment m_environment;
+};
+
+
+TEST_F(allocation_test, DisabledDebugMessagesDoNotAllocate)
+{
+    ChainPipeline pipeline(&m_environment, 4);
+    const auto stage = pipeline.stages().back();
+
+    const auto numAllocations = countAllocations([stage] ()
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            GLOPERATE_DEBUG(1) << stage->qualifiedName() << ": processing " << std::to_string(i);
+        }
+    });
+
+    EXPECT_EQ(0u, numAllocations);
+}
+
+TEST_F(allocation_test, QualifiedNamesAreBuiltOnAttach)
+{
+    ChainPipeline pipeline(&m_environment, 4);
+    const auto stage = pipeline.stages().back();
+
+    EXPECT_EQ("chain.forward4", stage->qualifiedName());
+    EXPECT_EQ("chain.forward4.output", stage->outputs().front()->qualifiedName());
+
+    const auto numAllocations = countAllocations([stage] ()
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            stage->qualifiedName();
+            stage->outputs().front()->qualifiedName();
+        }
+    });
+
+    EXPECT_EQ(0u, numAllocations);
+}
+
+TEST_F(allocation_test, AllocationsPerFrame)
+{
+    const std::size_t numStages = 64;
+    const int numFrames = 1000;
+
+    ChainPipeline pipeline(&m_environment, numStages);
+    pipeline.result.setRequired(true);
+
+    // Sort stages and fill caches
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        pipeline.value.setValue(frame);
+        pipeline.process();
+    }
+
+    ASSERT_EQ(static_cast<int>(9 + numStages), *pipeline.result);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto numAllocations = countAllocations([&pipeline, numFrames] ()
+    {
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            pipeline.value.setValue(frame);
+            pipeline.process();
+        }
+    });
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    EXPECT_EQ(static_cast<int>(numFrames - 1 + numStages), *pipeline.result);
+
+    const auto allocationsPerFrame = static_cast<double>(numAllocations) / numFrames;
+    const auto timePerFrame        = static_cast<double>(duration) / numFrames / 1000.0;
+
+    RecordProperty("allocationsPerFrame", std::to_string(allocationsPerFrame));
+    RecordProperty("microsecondsPerFrame", std::to_string(timePerFrame));
+
+    // Neither debug messages nor qualified names may allocate while processing
+    EXPECT_EQ(0u, numAllocations);
+}
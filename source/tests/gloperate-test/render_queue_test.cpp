@@ -0,0 +1,136 @@
+
+#include <gmock/gmock.h>
+
+#include <vector>
+
+#include <gloperate/rendering/AbstractDrawable.h>
+#include <gloperate/rendering/RenderPass.h>
+#include <gloperate/rendering/RenderQueue.h>
+
+
+namespace
+{
+
+
+// Geometry that does not issue any OpenGL calls
+class NullDrawable : public gloperate::AbstractDrawable
+{
+public:
+    virtual void draw() const override
+    {
+    }
+};
+
+
+// Queue that exposes its sorted passes without drawing them
+class TestQueue : public gloperate::RenderQueue
+{
+public:
+    std::vector<const gloperate::RenderPass *> sortedPasses() const
+    {
+        sort();
+
+        std::vector<const gloperate::RenderPass *> passes;
+        for (const auto & item : m_items)
+        {
+            passes.push_back(item.pass);
+        }
+
+        return passes;
+    }
+
+    std::vector<globjects::Framebuffer *> sortedFramebuffers() const
+    {
+        sort();
+
+        std::vector<globjects::Framebuffer *> framebuffers;
+        for (const auto & item : m_items)
+        {
+            framebuffers.push_back(item.framebuffer);
+        }
+
+        return framebuffers;
+    }
+};
+
+
+} // namespace
+
+
+class render_queue_test : public testing::Test
+{
+public:
+    render_queue_test()
+    {
+        // Framebuffers are only compared by identity when sorting, so they are never accessed
+        m_framebuffer1 = reinterpret_cast<globjects::Framebuffer *>(&m_framebufferStorage[0]);
+        m_framebuffer2 = reinterpret_cast<globjects::Framebuffer *>(&m_framebufferStorage[1]);
+    }
+
+protected:
+    int                      m_framebufferStorage[2];
+    globjects::Framebuffer * m_framebuffer1;
+    globjects::Framebuffer * m_framebuffer2;
+};
+
+
+TEST_F(render_queue_test, PassesAreGroupedByFramebuffer)
+{
+    NullDrawable geometry;
+    gloperate::RenderPass passes[5];
+    for (auto & pass : passes)
+    {
+        pass.setGeometry(&geometry);
+    }
+
+    TestQueue queue;
+    queue.submit(&passes[0], 0.0f, m_framebuffer1);
+    queue.submit(&passes[1], 0.0f, nullptr);
+    queue.submit(&passes[2], 0.0f, m_framebuffer2);
+    queue.submit(&passes[3], 0.0f, m_framebuffer1);
+    queue.submit(&passes[4], 0.0f, nullptr);
+
+    // Passes without framebuffer come first, each framebuffer is bound once
+    const std::vector<globjects::Framebuffer *> expectedFramebuffers { nullptr, nullptr, m_framebuffer1, m_framebuffer1, m_framebuffer2 };
+    EXPECT_EQ(expectedFramebuffers, queue.sortedFramebuffers());
+
+    // Passes with equal keys keep the order of submission
+    const std::vector<const gloperate::RenderPass *> expectedPasses { &passes[1], &passes[4], &passes[0], &passes[3], &passes[2] };
+    EXPECT_EQ(expectedPasses, queue.sortedPasses());
+}
+
+TEST_F(render_queue_test, PassesAreSortedByGeometryAndDepth)
+{
+    NullDrawable geometry1;
+    NullDrawable geometry2;
+
+    gloperate::RenderPass near1, far1, pass2;
+    near1.setGeometry(&geometry1);
+    far1.setGeometry(&geometry1);
+    pass2.setGeometry(&geometry2);
+
+    TestQueue queue;
+    queue.submit(&far1, 0.8f);
+    queue.submit(&pass2, 0.1f);
+    queue.submit(&near1, 0.2f);
+
+    // Passes of the same geometry are drawn together, front to back
+    const std::vector<const gloperate::RenderPass *> expectedPasses { &near1, &far1, &pass2 };
+    EXPECT_EQ(expectedPasses, queue.sortedPasses());
+}
+
+TEST_F(render_queue_test, ClearRemovesPasses)
+{
+    NullDrawable geometry;
+    gloperate::RenderPass pass;
+    pass.setGeometry(&geometry);
+
+    TestQueue queue;
+    queue.submit(&pass, 0.0f, m_framebuffer1);
+    queue.submit(&pass, 0.0f, m_framebuffer2);
+    EXPECT_EQ(2u, queue.size());
+
+    queue.clear();
+    EXPECT_EQ(0u, queue.size());
+    EXPECT_TRUE(queue.sortedPasses().empty());
+}
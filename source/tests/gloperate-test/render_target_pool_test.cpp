@@ -0,0 +1,253 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <gloperate/base/Environment.h>
+#include <gloperate/pipeline/Pipeline.h>
+#include <gloperate/pipeline/Stage.h>
+#include <gloperate/pipeline/Input.h>
+#include <gloperate/pipeline/Output.h>
+#include <gloperate/rendering/ColorRenderTarget.h>
+#include <gloperate/rendering/RenderTargetPool.h>
+
+
+namespace
+{
+
+
+// Pool that assigns storage without allocating OpenGL objects
+class TestPool : public gloperate::RenderTargetPool
+{
+public:
+    const void * assignTexture(const gloperate::Stage * client)
+    {
+        return assign(client, false, gl::GL_RGBA8, 64, 64);
+    }
+};
+
+
+// Stage that provides the storage of a render target, like a transient render target stage
+class TargetStage : public gloperate::Stage
+{
+public:
+    TargetStage(gloperate::Environment * environment, const std::string & name)
+    : Stage(environment, "TargetStage", name)
+    , target("target", this, nullptr)
+    , pool(nullptr)
+    {
+    }
+
+    Output<gloperate::ColorRenderTarget *> target;
+
+    TestPool * pool; ///< Pool of the parent pipeline, if it assigns storage
+
+protected:
+    virtual void onProcess() override
+    {
+        if (pool)
+        {
+            pool->assignTexture(this);
+        }
+
+        target.setValue(nullptr);
+    }
+};
+
+
+// Stage that draws into or reads a render target and passes it on
+class PassStage : public gloperate::Stage
+{
+public:
+    PassStage(gloperate::Environment * environment, const std::string & name)
+    : Stage(environment, "PassStage", name)
+    , target("target", this, nullptr)
+    , dependency("dependency", this, 0)
+    , targetOut("targetOut", this, nullptr)
+    , done("done", this, 0)
+    , processed(0)
+    {
+    }
+
+    Input<gloperate::ColorRenderTarget *>  target;
+    Input<int>                             dependency; ///< Orders stages without passing on a render target
+    Output<gloperate::ColorRenderTarget *> targetOut;
+    Output<int>                            done;
+
+    int processed; ///< Number of times the stage has been processed
+
+protected:
+    virtual void onProcess() override
+    {
+        ++processed;
+
+        targetOut.setValue(*target);
+        done.setValue(*dependency + 1);
+    }
+};
+
+
+// Pipeline with two render targets that are used one after another
+class SequencePipeline : public gloperate::Pipeline
+{
+public:
+    SequencePipeline(gloperate::Environment * environment)
+    : Pipeline(environment, "SequencePipeline", "sequence")
+    {
+        auto target1 = cppassist::make_unique<TargetStage>(environment, "target1");
+        auto target2 = cppassist::make_unique<TargetStage>(environment, "target2");
+        auto draw1   = cppassist::make_unique<PassStage>(environment, "draw1");
+        auto read1   = cppassist::make_unique<PassStage>(environment, "read1");
+        auto draw2   = cppassist::make_unique<PassStage>(environment, "draw2");
+        auto read2   = cppassist::make_unique<PassStage>(environment, "read2");
+
+        draw1->target << target1->target;
+        read1->target << draw1->targetOut;
+        draw2->target << target2->target;
+        draw2->dependency << read1->done;
+        read2->target << draw2->targetOut;
+
+        this->target1 = target1.get();
+        this->target2 = target2.get();
+        this->draw1   = draw1.get();
+        this->read1   = read1.get();
+        this->draw2   = draw2.get();
+        this->read2   = read2.get();
+
+        addStage(std::move(target1));
+        addStage(std::move(target2));
+        addStage(std::move(draw1));
+        addStage(std::move(read1));
+        addStage(std::move(draw2));
+        addStage(std::move(read2));
+    }
+
+    // Let the clients request storage from a pool that does not allocate OpenGL objects
+    void useTestPool()
+    {
+        auto pool = cppassist::make_unique<TestPool>();
+
+        target1->pool = pool.get();
+        target2->pool = pool.get();
+
+        m_renderTargetPool = std::move(pool);
+    }
+
+    std::size_t indexOf(const gloperate::Stage * stage) const
+    {
+        return static_cast<std::size_t>(std::find(stages().begin(), stages().end(), stage) - stages().begin());
+    }
+
+    TargetStage * target1;
+    TargetStage * target2;
+    PassStage   * draw1;
+    PassStage   * read1;
+    PassStage   * draw2;
+    PassStage   * read2;
+};
+
+
+} // namespace
+
+
+class render_target_pool_test : public testing::Test
+{
+protected:
+    gloperate::Environment m_environment;
+};
+
+
+TEST_F(render_target_pool_test, LifetimesStartAtFirstReader)
+{
+    SequencePipeline pipeline(&m_environment);
+    pipeline.renderTargetPool()->addClient(pipeline.target1);
+    pipeline.renderTargetPool()->addClient(pipeline.target2);
+
+    pipeline.process();
+
+    const auto lifetime1 = pipeline.renderTargetPool()->lifetime(pipeline.target1);
+    const auto lifetime2 = pipeline.renderTargetPool()->lifetime(pipeline.target2);
+
+    EXPECT_EQ(pipeline.indexOf(pipeline.draw1), lifetime1.first);
+    EXPECT_EQ(pipeline.indexOf(pipeline.read1), lifetime1.second);
+    EXPECT_EQ(pipeline.indexOf(pipeline.draw2), lifetime2.first);
+    EXPECT_EQ(pipeline.indexOf(pipeline.read2), lifetime2.second);
+
+    EXPECT_LT(lifetime1.second, lifetime2.first);
+}
+
+TEST_F(render_target_pool_test, SequentialTargetsShareStorage)
+{
+    SequencePipeline pipeline(&m_environment);
+    pipeline.renderTargetPool()->addClient(pipeline.target1);
+    pipeline.renderTargetPool()->addClient(pipeline.target2);
+
+    pipeline.process();
+
+    const auto lifetime1 = pipeline.renderTargetPool()->lifetime(pipeline.target1);
+    const auto lifetime2 = pipeline.renderTargetPool()->lifetime(pipeline.target2);
+
+    // Assign storage with the lifetimes determined by the pipeline
+    TestPool pool;
+    pool.addClient(pipeline.target1);
+    pool.addClient(pipeline.target2);
+    pool.setLifetime(pipeline.target1, lifetime1.first, lifetime1.second);
+    pool.setLifetime(pipeline.target2, lifetime2.first, lifetime2.second);
+
+    const auto storage1 = pool.assignTexture(pipeline.target1);
+    const auto storage2 = pool.assignTexture(pipeline.target2);
+
+    EXPECT_EQ(storage1, storage2);
+    EXPECT_EQ(1u, pool.size());
+}
+
+TEST_F(render_target_pool_test, OverlappingTargetsDoNotShareStorage)
+{
+    SequencePipeline pipeline(&m_environment);
+
+    TestPool pool;
+    pool.addClient(pipeline.target1);
+    pool.addClient(pipeline.target2);
+    pool.setLifetime(pipeline.target1, 2, 4);
+    pool.setLifetime(pipeline.target2, 4, 5);
+
+    const auto storage1 = pool.assignTexture(pipeline.target1);
+    const auto storage2 = pool.assignTexture(pipeline.target2);
+
+    EXPECT_NE(storage1, storage2);
+    EXPECT_EQ(2u, pool.size());
+}
+
+TEST_F(render_target_pool_test, ReaderOfSharedStorageIsProcessedWithItsWriter)
+{
+    SequencePipeline pipeline(&m_environment);
+    pipeline.useTestPool();
+    pipeline.renderTargetPool()->addClient(pipeline.target1);
+    pipeline.renderTargetPool()->addClient(pipeline.target2);
+    pipeline.read2->done.setRequired(true);
+
+    pipeline.process();
+
+    ASSERT_TRUE(pipeline.renderTargetPool()->isShared(pipeline.target1));
+    EXPECT_EQ(1, pipeline.draw1->processed);
+    EXPECT_EQ(1, pipeline.read1->processed);
+
+    // Clean pipeline is not processed again
+    pipeline.process();
+
+    EXPECT_EQ(1, pipeline.draw1->processed);
+    EXPECT_EQ(1, pipeline.read1->processed);
+
+    // Only the reader has changed, but draw2 has overwritten the shared storage since draw1 has drawn into it
+    pipeline.read1->dependency.setValue(1);
+    pipeline.process();
+
+    EXPECT_EQ(2, pipeline.draw1->processed);
+    EXPECT_EQ(2, pipeline.read1->processed);
+}